@@ -47,6 +47,7 @@
 #include "java/JavaInstallList.h"
 #include "net/PasteUpload.h"
 #include "tasks/Task.h"
+#include "tasks/TaskTrace.h"
 #include "tools/GenericProfiler.h"
 #include "ui/InstanceWindow.h"
 #include "ui/MainWindow.h"
@@ -107,6 +108,8 @@
 
 #include <minecraft/auth/AccountList.h>
 #include "icons/IconList.h"
+#include "modplatform/helpers/HashCache.h"
+#include "net/ContentStore.h"
 #include "net/HttpMetaCache.h"
 
 #include "updater/ExternalUpdater.h"
@@ -333,7 +336,8 @@ Application::Application(int& argc, char** argv) : QApplication(argc, argv)
           { { "o", "offline" }, "Launch offline, with given player name (only valid in combination with --launch)", "offline" },
           { "alive", "Write a small '" + liveCheckFile + "' file after the launcher starts" },
           { { "I", "import" }, "Import instance or resource from specified local path or URL", "url" },
-          { "show", "Opens the window for the specified instance (by instance ID)", "show" } });
+          { "show", "Opens the window for the specified instance (by instance ID)", "show" },
+          { "trace-tasks", "Record every task the launcher runs, and write a trace of them to 'logs/task-trace.json' on exit" } });
     // Has to be positional for some OS to handle that properly
     parser.addPositionalArgument("URL", "Import the resource(s) at the given URL(s) (same as -I / --import)", "[URL...]");
 
@@ -351,6 +355,8 @@ Application::Application(int& argc, char** argv) : QApplication(argc, argv)
         m_offlineName = parser.value("offline");
     }
     m_liveCheck = parser.isSet("alive");
+    if (parser.isSet("trace-tasks"))
+        m_taskTrace = std::make_unique<TaskTrace>();
 
     m_instanceIdToShowWindowOf = parser.value("show");
 
@@ -1027,6 +1033,8 @@ Application::Application(int& argc, char** argv) : QApplication(argc, argv)
         m_metacache->addBase("meta", QDir("meta").absolutePath());
         m_metacache->addBase("java", QDir("cache/java").absolutePath());
         m_metacache->Load();
+        m_contentStore.reset(new Net::ContentStore(QDir("cache/objects").absolutePath()));
+        m_hashCache.reset(new Hashing::HashCache(QDir("cache").absoluteFilePath("hashes.dat")));
         qInfo() << "<> Cache initialized.";
     }
 
@@ -1055,6 +1063,18 @@ Application::Application(int& argc, char** argv) : QApplication(argc, argv)
             // save any remaining instance state
             m_instances->saveNow();
         }
+        if (m_taskTrace) {
+            m_taskTrace->stop();
+            qDebug() << "Task metrics:";
+            for (const auto& line : m_taskTrace->metrics())
+                qDebug().noquote() << "  " + line;
+            try {
+                FS::write(FS::PathCombine(m_dataPath, "logs", "task-trace.json"),
+                          m_taskTrace->toChromeTrace(BuildConfig.LAUNCHER_DISPLAYNAME));
+            } catch (const FS::FileSystemException& e) {
+                qWarning() << "Couldn't write the task trace:" << e.cause();
+            }
+        }
         if (logFile) {
             logFile->flush();
             logFile->close();
@@ -72,6 +72,7 @@ class BaseDetachedToolFactory;
 class TranslationsModel;
 class ITheme;
 class MCEditTool;
+class TaskTrace;
 class ThemeManager;
 class IconTheme;
 
@@ -79,6 +80,14 @@ namespace Meta {
 class Index;
 }
 
+namespace Hashing {
+class HashCache;
+}
+
+namespace Net {
+class ContentStore;
+}
+
 #if defined(APPLICATION)
 #undef APPLICATION
 #endif
@@ -146,6 +155,10 @@ class Application : public QApplication {
 
     shared_qobject_ptr<HttpMetaCache> metacache();
 
+    std::shared_ptr<Net::ContentStore> contentStore() const { return m_contentStore; }
+
+    std::shared_ptr<Hashing::HashCache> hashCache() const { return m_hashCache; }
+
     shared_qobject_ptr<Meta::Index> metadataIndex();
 
     void updateCapabilities();
@@ -247,6 +260,8 @@ class Application : public QApplication {
     shared_qobject_ptr<AccountList> m_accounts;
 
     shared_qobject_ptr<HttpMetaCache> m_metacache;
+    std::shared_ptr<Net::ContentStore> m_contentStore;
+    std::shared_ptr<Hashing::HashCache> m_hashCache;
     shared_qobject_ptr<Meta::Index> m_metadataIndex;
 
     std::shared_ptr<SettingsObject> m_settings;
@@ -314,6 +329,8 @@ class Application : public QApplication {
     QString m_instanceIdToShowWindowOf;
     std::unique_ptr<QFile> logFile;
     shared_qobject_ptr<LogModel> logModel;
+    // every task the launcher runs, when started with --trace-tasks
+    std::unique_ptr<TaskTrace> m_taskTrace;
 
    public:
     void addQSavePath(QString);
@@ -1324,9 +1324,6 @@ bool clone::operator()(const QString& offset, bool dryRun)
  */
 bool clone_file(const QString& src, const QString& dst, std::error_code& ec)
 {
-    auto src_path = StringUtils::toStdString(QDir::toNativeSeparators(QFileInfo(src).absoluteFilePath()));
-    auto dst_path = StringUtils::toStdString(QDir::toNativeSeparators(QFileInfo(dst).absoluteFilePath()));
-
     FilesystemInfo srcinfo = statFS(src);
     FilesystemInfo dstinfo = statFS(dst);
 
@@ -1336,6 +1333,14 @@ bool clone_file(const QString& src, const QString& dst, std::error_code& ec)
         return false;
     }
 
+    return reflink_file(src, dst, ec);
+}
+
+bool reflink_file(const QString& src, const QString& dst, std::error_code& ec)
+{
+    auto src_path = StringUtils::toStdString(QDir::toNativeSeparators(QFileInfo(src).absoluteFilePath()));
+    auto dst_path = StringUtils::toStdString(QDir::toNativeSeparators(QFileInfo(dst).absoluteFilePath()));
+
 #if defined(Q_OS_WIN)
 
     if (!win_ioctl_clone(src_path, dst_path, ec)) {
@@ -534,6 +534,12 @@ class clone : public QObject {
  */
 bool clone_file(const QString& src, const QString& dst, std::error_code& ec);
 
+/**
+ * @brief clone/reflink file from src to dst, without checking that both are on the same clone capable filesystem first
+ * For callers cloning many files that already checked with canClone()
+ */
+bool reflink_file(const QString& src, const QString& dst, std::error_code& ec);
+
 #if defined(Q_OS_WIN)
 bool win_ioctl_clone(const std::wstring& src_path, const std::wstring& dst_path, std::error_code& ec);
 #elif defined(Q_OS_LINUX)
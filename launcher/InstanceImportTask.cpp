@@ -97,7 +97,7 @@ void InstanceImportTask::downloadFromUrl()
     m_archivePath = entry->getFullPath();
 
     auto filesNetJob = makeShared<NetJob>(tr("Modpack download"), APPLICATION->network());
-    filesNetJob->addNetAction(Net::ApiDownload::makeCached(m_sourceUrl, entry));
+    filesNetJob->addNetAction(Net::ApiDownload::makeCached(m_sourceUrl, entry, Net::Download::Option::Segmented));
 
     connect(filesNetJob.get(), &NetJob::succeeded, this, &InstanceImportTask::processZipPack);
     connect(filesNetJob.get(), &NetJob::progress, this, &InstanceImportTask::setProgress);
@@ -74,12 +74,20 @@ QStringList LoggedProcess::reprocess(const QByteArray& data, QStringDecoder& dec
 
 void LoggedProcess::on_stdErr()
 {
+    if (m_raw_output) {
+        emit output(readAllStandardError(), MessageLevel::StdErr);
+        return;
+    }
     auto lines = reprocess(readAllStandardError(), m_err_decoder);
     emit log(lines, MessageLevel::StdErr);
 }
 
 void LoggedProcess::on_stdOut()
 {
+    if (m_raw_output) {
+        emit output(readAllStandardOutput(), MessageLevel::StdOut);
+        return;
+    }
     auto lines = reprocess(readAllStandardOutput(), m_out_decoder);
     emit log(lines, MessageLevel::StdOut);
 }
@@ -178,3 +186,8 @@ void LoggedProcess::setDetachable(bool detachable)
 {
     m_is_detachable = detachable;
 }
+
+void LoggedProcess::setRawOutput(bool raw)
+{
+    m_raw_output = raw;
+}
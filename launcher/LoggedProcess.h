@@ -57,8 +57,15 @@ class LoggedProcess : public QProcess {
 
     void setDetachable(bool detachable);
 
+    /**
+     * Emit the output as it arrives through output(), instead of decoded lines through log().
+     * For readers that do their own splitting and decoding.
+     */
+    void setRawOutput(bool raw);
+
    signals:
     void log(QStringList lines, MessageLevel level);
+    void output(QByteArray data, MessageLevel level);
     void stateChanged(LoggedProcess::State state);
 
    public slots:
@@ -88,4 +95,5 @@ class LoggedProcess : public QProcess {
     int m_exit_code = 0;
     bool m_is_aborting = false;
     bool m_is_detachable = false;
+    bool m_raw_output = false;
 };
@@ -39,6 +39,8 @@
 #include "FileSystem.h"
 #include "archive/ArchiveReader.h"
 #include "archive/ArchiveWriter.h"
+#include "archive/ZipExtractor.h"
+#include "archive/ZipIndex.h"
 
 #include <QCoreApplication>
 #include <QDebug>
@@ -52,6 +54,27 @@ using FilterFunction = std::function<bool(const QString&)>;
 #if defined(LAUNCHER_APPLICATION)
 bool mergeZipFiles(ArchiveWriter& into, QFileInfo from, QSet<QString>& contained, const FilterFunction& filter = nullptr)
 {
+    // zips are copied entry by entry without inflating them again, anything else goes through libarchive
+    ZipIndex index(from.absoluteFilePath());
+    if (index.open()) {
+        for (const auto& entry : index.entries()) {
+            if (filter && !filter(entry.name)) {
+                qDebug() << "Skipping file " << entry.name << " from " << from.fileName() << " - filtered";
+                continue;
+            }
+            if (contained.contains(entry.name)) {
+                qDebug() << "Skipping already contained file " << entry.name << " from " << from.fileName();
+                continue;
+            }
+            contained.insert(entry.name);
+            if (!into.addEntry(index, entry)) {
+                qCritical() << "Failed to copy data of " << entry.name << " into the jar";
+                return false;
+            }
+        }
+        return true;
+    }
+
     ArchiveReader r(from.absoluteFilePath());
     return r.parse([&into, &contained, &filter, from](ArchiveReader::File* f) {
         auto filename = f->filename();
@@ -91,9 +114,11 @@ bool compressDirFiles(ArchiveWriter& zip, QString dir, QFileInfoList files)
 }
 
 // ours
-bool createModdedJar(QString sourceJarPath, QString targetJarPath, const QList<Mod*>& mods)
+bool createModdedJar(QString sourceJarPath, QString targetJarPath, const QList<Mod*>& mods, bool store)
 {
     ArchiveWriter zipOut(targetJarPath);
+    if (store)
+        zipOut.setCompressionLevel(0);
     if (!zipOut.open()) {
         FS::deletePath(targetJarPath);
         qCritical() << "Failed to open the minecraft.jar for modding";
@@ -166,7 +191,6 @@ bool createModdedJar(QString sourceJarPath, QString targetJarPath, const QList<M
         return false;
     }
 
-    // Recompress the jar
     if (!zipOut.close()) {
         FS::deletePath(targetJarPath);
         qCritical() << "Failed to finalize minecraft.jar!";
@@ -183,6 +207,16 @@ std::optional<QStringList> extractSubDir(ArchiveReader* zip, const QString& subd
 
     QStringList extracted;
 
+    // zips are extracted on several threads, anything else goes through libarchive
+    ZipExtractor extractor(zip->getZipName(), subdir, target);
+    extractor.setRemoveInvalidPathChars(true);
+    if (extractor.open()) {
+        auto result = extractor.extract();
+        if (!result)
+            qWarning() << "Failed to extract" << zip->getZipName() << "-" << extractor.errorString();
+        return result;
+    }
+
     qDebug() << "Extracting subdir" << subdir << "from" << zip->getZipName() << "to" << target;
     if (!zip->collectFiles()) {
         qWarning() << "Failed to enumerate files in archive";
@@ -57,8 +57,9 @@ using FilterFileFunction = std::function<bool(const QFileInfo&)>;
 #if defined(LAUNCHER_APPLICATION)
 /**
  * take a source jar, add mods to it, resulting in target jar
+ * with 'store', entries are written uncompressed, trading size for not having to deflate everything again
  */
-bool createModdedJar(QString sourceJarPath, QString targetJarPath, const QList<Mod*>& mods);
+bool createModdedJar(QString sourceJarPath, QString targetJarPath, const QList<Mod*>& mods, bool store = false);
 #endif
 
 /**
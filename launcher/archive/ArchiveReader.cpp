@@ -65,6 +65,16 @@ QByteArray ArchiveReader::File::readAll(int* outStatus)
     return data;
 }
 
+qint64 ArchiveReader::File::read(char* data, qint64 maxSize)
+{
+    auto read = archive_read_data(m_archive.get(), data, static_cast<size_t>(maxSize));
+    if (read < 0) {
+        qWarning() << "libarchive read error: " << archive_error_string(m_archive.get());
+        return -1;
+    }
+    return read;
+}
+
 QDateTime ArchiveReader::File::dateTime()
 {
     auto mtime = archive_entry_mtime(m_entry);
@@ -189,6 +199,22 @@ bool ArchiveReader::File::isFile()
 {
     return (archive_entry_filetype(m_entry) & AE_IFMT) == AE_IFREG;
 }
+bool ArchiveReader::File::isSymLink()
+{
+    return (archive_entry_filetype(m_entry) & AE_IFMT) == AE_IFLNK;
+}
+QString ArchiveReader::File::symLinkTarget()
+{
+    return QString::fromUtf8(archive_entry_symlink_utf8(m_entry));
+}
+quint32 ArchiveReader::File::mode()
+{
+    return archive_entry_mode(m_entry);
+}
+qint64 ArchiveReader::File::size()
+{
+    return archive_entry_size_is_set(m_entry) ? archive_entry_size(m_entry) : -1;
+}
 bool ArchiveReader::File::skip()
 {
     return archive_read_data_skip(m_archive.get()) == ARCHIVE_OK;
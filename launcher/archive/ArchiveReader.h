@@ -43,9 +43,17 @@ class ArchiveReader {
 
         QString filename();
         bool isFile();
+        bool isSymLink();
+        QString symLinkTarget();
         QDateTime dateTime();
+        /** The entry's unix mode, file type bits included. */
+        quint32 mode();
+        /** Size of the entry's data, or -1 if the archive doesn't say up front. */
+        qint64 size();
         const char* error();
 
+        /** Reads the next part of the entry's data. Returns 0 at its end and -1 on errors. */
+        qint64 read(char* data, qint64 maxSize);
         QByteArray readAll(int* outStatus = nullptr);
         bool skip();
         bool writeFile(archive* out, QString targetFileName = "", bool notBlock = false);
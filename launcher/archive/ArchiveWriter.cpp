@@ -18,25 +18,97 @@
 #include "ArchiveWriter.h"
 #include <archive.h>
 #include <archive_entry.h>
-#include <sys/stat.h>
 
-#include <QFile>
+#include <QBuffer>
+#include <QDebug>
 #include <QFileInfo>
+#include <QScopeGuard>
+#include <QtEndian>
 
 #include <memory>
 
-#if defined Q_OS_WIN32
-#ifndef WIN32_LEAN_AND_MEAN
-#define WIN32_LEAN_AND_MEAN
-#endif
-// clang-format off
-#include <windows.h>
-#include <fileapi.h>
-// clang-format on
-#endif
+#include <zlib.h>
 
 namespace MMCZip {
 
+namespace {
+constexpr quint32 s_localHeaderSig = 0x04034b50;
+constexpr quint32 s_centralHeaderSig = 0x02014b50;
+constexpr quint32 s_endOfCentralDirSig = 0x06054b50;
+constexpr quint32 s_zip64EndOfCentralDirSig = 0x06064b50;
+constexpr quint32 s_zip64LocatorSig = 0x07064b50;
+
+constexpr qint64 s_localHeaderSize = 30;
+constexpr quint16 s_zip64ExtraId = 0x0001;
+
+constexpr quint16 s_versionNeeded = 20;
+constexpr quint16 s_versionNeededZip64 = 45;
+// made by: unix, so the external attributes hold the file mode
+constexpr quint16 s_versionMadeBy = (3 << 8) | s_versionNeededZip64;
+
+constexpr quint16 s_flagDataDescriptor = 0x0008;
+constexpr quint16 s_flagUtf8 = 0x0800;
+
+constexpr quint32 s_modeFile = 0100000;
+constexpr quint32 s_modeDir = 0040000;
+constexpr quint32 s_modeLink = 0120000;
+constexpr quint32 s_dosDirAttribute = 0x10;
+
+constexpr quint64 s_max32 = 0xFFFFFFFF;
+constexpr quint64 s_max16 = 0xFFFF;
+// deflate can grow incompressible data a little, so switch to zip64 before the input gets close to the limit
+constexpr quint64 s_zip64Threshold = s_max32 - 0x100000;
+
+constexpr qint64 s_chunkSize = 256 * 1024;
+
+template <typename T>
+void put(QByteArray& out, T value)
+{
+    char bytes[sizeof(T)];
+    qToLittleEndian(value, bytes);
+    out.append(bytes, sizeof(T));
+}
+
+quint32 unixPermissions(QFileDevice::Permissions permissions)
+{
+    quint32 mode = 0;
+    const std::pair<QFileDevice::Permission, quint32> bits[] = {
+        { QFileDevice::ReadOwner, 0400 }, { QFileDevice::WriteOwner, 0200 }, { QFileDevice::ExeOwner, 0100 },
+        { QFileDevice::ReadGroup, 0040 }, { QFileDevice::WriteGroup, 0020 }, { QFileDevice::ExeGroup, 0010 },
+        { QFileDevice::ReadOther, 0004 }, { QFileDevice::WriteOther, 0002 }, { QFileDevice::ExeOther, 0001 },
+    };
+    for (auto [permission, bit] : bits) {
+        if (permissions & permission)
+            mode |= bit;
+    }
+    return mode;
+}
+
+// the data of the entry an ArchiveReader is at, so it can be streamed into another archive
+class ArchiveFileDevice : public QIODevice {
+   public:
+    explicit ArchiveFileDevice(ArchiveReader::File* file) : m_file(file) { open(QIODevice::ReadOnly | QIODevice::Unbuffered); }
+
+    bool isSequential() const override { return true; }
+    bool atEnd() const override { return m_atEnd; }
+
+   protected:
+    qint64 readData(char* data, qint64 maxSize) override
+    {
+        auto read = m_file->read(data, maxSize);
+        if (read < 0)
+            setErrorString(QString::fromUtf8(m_file->error()));
+        m_atEnd = read <= 0;
+        return read;
+    }
+    qint64 writeData(const char*, qint64) override { return -1; }
+
+   private:
+    ArchiveReader::File* m_file;
+    bool m_atEnd = false;
+};
+}  // namespace
+
 ArchiveWriter::ArchiveWriter(const QString& archiveName) : m_filename(archiveName) {}
 
 ArchiveWriter::~ArchiveWriter()
@@ -51,185 +123,428 @@ bool ArchiveWriter::open()
         return false;
     }
 
-    m_archive = archive_write_new();
-    if (!m_archive) {
-        qCritical() << "Archive not initialized.";
+    m_file.setFileName(m_filename);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCritical() << "Failed to open archive file:" << m_filename << "-" << m_file.errorString();
         return false;
     }
+    m_entries.clear();
+    return true;
+}
 
-    auto format = m_format.toUtf8();
-    archive_write_set_format_by_name(m_archive, format.constData());
+bool ArchiveWriter::close()
+{
+    if (!m_file.isOpen())
+        return true;
+
+    bool success = writeCentralDirectory();
+    if (!success)
+        qCritical() << "Failed to write the central directory of" << m_filename << "-" << m_file.errorString();
+    m_file.close();
+    if (m_file.error() != QFileDevice::NoError) {
+        qCritical() << "Failed to close archive" << m_filename << "-" << m_file.errorString();
+        success = false;
+    }
+    m_entries.clear();
+    return success;
+}
 
-    if (archive_write_set_options(m_archive, "hdrcharset=UTF-8") != ARCHIVE_OK) {
-        qCritical() << "Failed to open archive file:" << m_filename << "-" << archive_error_string(m_archive);
-        return false;
+auto ArchiveWriter::newEntry(const QString& fileDest, quint32 mode, const QDateTime& modified) const -> Entry
+{
+    Entry entry;
+    entry.name = fileDest.toUtf8();
+    entry.versionMadeBy = s_versionMadeBy;
+    entry.flags = s_flagUtf8;
+    entry.externalAttributes = mode << 16;
+    if ((mode & s_modeDir) == s_modeDir)
+        entry.externalAttributes |= s_dosDirAttribute;
+
+    // dos dates start in 1980 and have a two second resolution
+    auto local = modified.isValid() ? modified.toLocalTime() : QDateTime::currentDateTime();
+    auto date = local.date();
+    auto time = local.time();
+    if (date.year() < 1980) {
+        entry.dosDate = (1 << 5) | 1;
+    } else {
+        entry.dosDate = quint16(((date.year() - 1980) << 9) | (date.month() << 5) | date.day());
+        entry.dosTime = quint16((time.hour() << 11) | (time.minute() << 5) | (time.second() / 2));
     }
+    return entry;
+}
+
+bool ArchiveWriter::writeLocalHeader(const Entry& entry, bool zip64)
+{
+    QByteArray header;
+    header.reserve(s_localHeaderSize + entry.name.size() + 20);
+    put<quint32>(header, s_localHeaderSig);
+    put<quint16>(header, zip64 ? s_versionNeededZip64 : s_versionNeeded);
+    put<quint16>(header, entry.flags);
+    put<quint16>(header, entry.method);
+    put<quint16>(header, entry.dosTime);
+    put<quint16>(header, entry.dosDate);
+    put<quint32>(header, entry.crc32);
+    put<quint32>(header, zip64 ? quint32(s_max32) : quint32(entry.compressedSize));
+    put<quint32>(header, zip64 ? quint32(s_max32) : quint32(entry.uncompressedSize));
+    put<quint16>(header, quint16(entry.name.size()));
+    put<quint16>(header, zip64 ? 20 : 0);
+    header.append(entry.name);
+    if (zip64) {
+        // the local zip64 field always holds both sizes
+        put<quint16>(header, s_zip64ExtraId);
+        put<quint16>(header, 16);
+        put<quint64>(header, entry.uncompressedSize);
+        put<quint64>(header, entry.compressedSize);
+    }
+    return m_file.write(header) == header.size();
+}
 
-    auto archiveNameW = m_filename.toStdWString();
-    if (archive_write_open_filename_w(m_archive, archiveNameW.data()) != ARCHIVE_OK) {
-        qCritical() << "Failed to open archive file:" << m_filename << "-" << archive_error_string(m_archive);
+bool ArchiveWriter::startEntry(Entry entry, bool zip64)
+{
+    m_current.reset();
+    if (entry.name.size() > qsizetype(s_max16)) {
+        qCritical() << "File name too long for a zip entry:" << entry.name;
         return false;
     }
 
+    // the crc and sizes are only known once the data is written, they get filled in by endEntry()
+    entry.compressedSize = 0;
+    entry.localHeaderOffset = quint64(m_file.pos());
+    if (!writeLocalHeader(entry, zip64))
+        return false;
+    m_current = std::move(entry);
+    m_currentZip64 = zip64;
     return true;
 }
 
-bool ArchiveWriter::close()
+bool ArchiveWriter::beginEntry(const QString& fileDest,
+                               quint16 method,
+                               quint64 uncompressedSize,
+                               const QDateTime& modified,
+                               QFileDevice::Permissions permissions)
 {
-    bool success = true;
-    if (m_archive) {
-        if (archive_write_close(m_archive) != ARCHIVE_OK) {
-            qCritical() << "Failed to close archive" << m_filename << "-" << archive_error_string(m_archive);
-            success = false;
-        }
-        if (archive_write_free(m_archive) != ARCHIVE_OK) {
-            qCritical() << "Failed to free archive" << m_filename << "-" << archive_error_string(m_archive);
-            success = false;
-        }
-        m_archive = nullptr;
-    }
-    return success;
+    auto entry = newEntry(fileDest, s_modeFile | unixPermissions(permissions), modified);
+    entry.method = method;
+    return startEntry(std::move(entry), uncompressedSize >= s_zip64Threshold);
 }
 
-bool ArchiveWriter::addFile(const QString& fileName, const QString& fileDest)
+bool ArchiveWriter::addRawData(QByteArrayView data)
 {
-    QFileInfo fileInfo(fileName);
-    if (!fileInfo.exists()) {
-        qCritical() << "File does not exist:" << fileInfo.filePath();
+    if (!m_current)
         return false;
-    }
+    if (m_file.write(data.data(), data.size()) != data.size())
+        return false;
+    m_current->compressedSize += quint64(data.size());
+    return true;
+}
 
-    std::unique_ptr<archive_entry, void (*)(archive_entry*)> entry_ptr(archive_entry_new(), archive_entry_free);
-    auto entry = entry_ptr.get();
-    if (!entry) {
-        qCritical() << "Failed to create archive entry";
+bool ArchiveWriter::endEntry(quint32 crc32, quint64 uncompressedSize)
+{
+    if (!m_current)
+        return false;
+    auto entry = std::move(*m_current);
+    m_current.reset();
+    entry.crc32 = crc32;
+    entry.uncompressedSize = uncompressedSize;
+
+    if (!m_currentZip64 && (entry.compressedSize >= s_max32 || entry.uncompressedSize >= s_max32)) {
+        qCritical() << "File changed size while adding it to the archive:" << entry.name;
         return false;
     }
 
-    auto fileDestUtf8 = fileDest.toUtf8();
-    archive_entry_set_pathname_utf8(entry, fileDestUtf8.constData());
+    const auto end = m_file.pos();
+    if (!m_file.seek(qint64(entry.localHeaderOffset)) || !writeLocalHeader(entry, m_currentZip64) || !m_file.seek(end))
+        return false;
 
-#if defined Q_OS_WIN32
-    {
-        // Windows needs to use this method, thanks I hate it.
+    m_entries.append(entry);
+    return true;
+}
 
-        auto widePath = fileInfo.absoluteFilePath().toStdWString();
-        HANDLE file_handle = CreateFileW(widePath.data(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
-        if (file_handle == INVALID_HANDLE_VALUE) {
-            qCritical() << "Failed to stat file:" << fileInfo.filePath();
+bool ArchiveWriter::writeEntry(Entry entry, QIODevice& input, qint64 size)
+{
+    const int level = m_compressionLevel < 0 ? Z_DEFAULT_COMPRESSION : qMin(m_compressionLevel, 9);
+    entry.method = (level == 0 || size == 0) ? ZipIndex::Stored : ZipIndex::Deflated;
+    const bool deflated = entry.method == ZipIndex::Deflated;
+    if (!startEntry(std::move(entry), quint64(size) >= s_zip64Threshold))
+        return false;
+
+    z_stream strm;
+    if (deflated) {
+        memset(&strm, 0, sizeof(strm));
+        // negative window bits: raw deflate, zip entries have no zlib header
+        if (deflateInit2(&strm, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
             return false;
-        }
+    }
+    auto cleanup = qScopeGuard([&strm, deflated] {
+        if (deflated)
+            deflateEnd(&strm);
+    });
 
-        BY_HANDLE_FILE_INFORMATION file_info;
-        if (!GetFileInformationByHandle(file_handle, &file_info)) {
-            qCritical() << "Failed to stat file:" << fileInfo.filePath();
-            CloseHandle(file_handle);
+    QByteArray in(s_chunkSize, Qt::Uninitialized);
+    QByteArray out(s_chunkSize, Qt::Uninitialized);
+    uLong crc = crc32(0, nullptr, 0);
+    quint64 uncompressedSize = 0;
+    bool finished = false;
+    while (!finished) {
+        const auto read = input.read(in.data(), in.size());
+        if (read < 0) {
+            qCritical() << "Read error for" << m_current->name << "-" << input.errorString();
             return false;
         }
+        finished = read == 0 || input.atEnd();
+        crc = crc32(crc, reinterpret_cast<const Bytef*>(in.constData()), uInt(read));
+        uncompressedSize += quint64(read);
 
-        archive_entry_copy_bhfi(entry, &file_info);
-        CloseHandle(file_handle);
-    }
-#else
-    {
-        // this only works for multibyte encoded filenames if the local is properly set,
-        // a wide character version doesn't seem to exist: here's hoping...
-
-        QByteArray utf8 = fileInfo.absoluteFilePath().toUtf8();
-        const char* cpath = utf8.constData();
-        struct stat st;
-        if (stat(cpath, &st) != 0) {
-            qCritical() << "Failed to stat file:" << fileInfo.filePath();
-            return false;
+        if (!deflated) {
+            if (!addRawData(QByteArrayView(in.constData(), read)))
+                return false;
+            continue;
         }
 
-        // This should handle the copying of most attributes
-        archive_entry_copy_stat(entry, &st);
+        strm.next_in = reinterpret_cast<Bytef*>(in.data());
+        strm.avail_in = uInt(read);
+        const int flush = finished ? Z_FINISH : Z_NO_FLUSH;
+        int err;
+        do {
+            strm.next_out = reinterpret_cast<Bytef*>(out.data());
+            strm.avail_out = uInt(out.size());
+            err = deflate(&strm, flush);
+            if (err == Z_STREAM_ERROR)
+                return false;
+            if (!addRawData(QByteArrayView(out.constData(), out.size() - strm.avail_out)))
+                return false;
+        } while (strm.avail_out == 0 || (flush == Z_FINISH && err != Z_STREAM_END));
+    }
+    return endEntry(quint32(crc), uncompressedSize);
+}
+
+std::optional<QByteArray> ArchiveWriter::deflateChunk(QByteArrayView data, QByteArrayView dictionary, int level, bool last)
+{
+    z_stream strm;
+    memset(&strm, 0, sizeof(strm));
+    level = level < 0 ? Z_DEFAULT_COMPRESSION : qMin(level, 9);
+    if (deflateInit2(&strm, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        return {};
+    auto cleanup = qScopeGuard([&strm] { deflateEnd(&strm); });
+
+    if (!dictionary.isEmpty()) {
+        dictionary = dictionary.last(qMin<qsizetype>(dictionary.size(), 1 << MAX_WBITS));
+        if (deflateSetDictionary(&strm, reinterpret_cast<const Bytef*>(dictionary.data()), uInt(dictionary.size())) != Z_OK)
+            return {};
+    }
+
+    // a sync flush ends the chunk on a byte boundary without ending the deflate stream, so the next chunk can follow it
+    const int flush = last ? Z_FINISH : Z_SYNC_FLUSH;
+    strm.next_in = const_cast<Bytef*>(reinterpret_cast<const Bytef*>(data.data()));
+    strm.avail_in = uInt(data.size());
+
+    QByteArray out(qsizetype(deflateBound(&strm, uLong(data.size()))) + 16, Qt::Uninitialized);
+    int err;
+    do {
+        if (strm.total_out == uLong(out.size()))
+            out.resize(out.size() * 2);
+        strm.next_out = reinterpret_cast<Bytef*>(out.data()) + strm.total_out;
+        strm.avail_out = uInt(out.size() - qsizetype(strm.total_out));
+        err = deflate(&strm, flush);
+    } while (strm.avail_out == 0 && (err == Z_OK || err == Z_BUF_ERROR));
+
+    // Z_BUF_ERROR only means that the previous call already flushed everything
+    if (last ? err != Z_STREAM_END : (err != Z_OK && err != Z_BUF_ERROR))
+        return {};
+    out.resize(qsizetype(strm.total_out));
+    return out;
+}
+
+bool ArchiveWriter::addFile(const QString& fileName, const QString& fileDest)
+{
+    QFileInfo fileInfo(fileName);
+    if (!fileInfo.exists() && !fileInfo.isSymLink()) {
+        qCritical() << "File does not exist:" << fileInfo.filePath();
+        return false;
     }
-#endif
 
-    // However:
-    // "The [filetype] constants used by stat(2) may have different numeric values from the corresponding [libarchive constants]."
-    // - `archive_entry_stat(3)`
+    const auto permissions = unixPermissions(fileInfo.permissions());
     if (fileInfo.isSymLink()) {
-        archive_entry_set_filetype(entry, AE_IFLNK);
-
-        // We also need to manually copy some attributes from the link itself, as `stat` above operates on its target
-        auto target = fileInfo.symLinkTarget().toUtf8();
-        archive_entry_set_symlink_utf8(entry, target.constData());
-        archive_entry_set_size(entry, 0);
-        archive_entry_set_perm(entry, fileInfo.permissions());
-    } else if (fileInfo.isFile()) {
-        archive_entry_set_filetype(entry, AE_IFREG);
-    } else {
+        // links are stored as their target
+        QBuffer target;
+        target.setData(fileInfo.symLinkTarget().toUtf8());
+        target.open(QIODevice::ReadOnly);
+        auto level = std::exchange(m_compressionLevel, 0);
+        bool ok = writeEntry(newEntry(fileDest, s_modeLink | 0777, fileInfo.lastModified()), target, target.size());
+        m_compressionLevel = level;
+        return ok;
+    }
+    if (!fileInfo.isFile()) {
         qCritical() << "Unsupported file type:" << fileInfo.filePath();
         return false;
     }
 
-    if (archive_write_header(m_archive, entry) != ARCHIVE_OK) {
-        qCritical() << "Failed to write header for: " << fileDest << "-" << archive_error_string(m_archive);
+    QFile file(fileInfo.absoluteFilePath());
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCritical() << "Failed to open file: " << fileInfo.filePath();
         return false;
     }
-
-    if (fileInfo.isFile() && !fileInfo.isSymLink()) {
-        QFile file(fileInfo.absoluteFilePath());
-        if (!file.open(QIODevice::ReadOnly)) {
-            qCritical() << "Failed to open file: " << fileInfo.filePath();
-            return false;
-        }
-
-        constexpr qint64 chunkSize = 8192;
-        QByteArray buffer;
-        buffer.resize(chunkSize);
-
-        while (!file.atEnd()) {
-            auto bytesRead = file.read(buffer.data(), chunkSize);
-            if (bytesRead < 0) {
-                qCritical() << "Read error in file: " << fileInfo.filePath();
-                return false;
-            }
-
-            if (archive_write_data(m_archive, buffer.constData(), bytesRead) < 0) {
-                qCritical() << "Write error in archive for: " << fileDest;
-                return false;
-            }
-        }
+    if (!writeEntry(newEntry(fileDest, s_modeFile | permissions, fileInfo.lastModified()), file, file.size())) {
+        qCritical() << "Failed to write" << fileInfo.filePath() << "to" << m_filename;
+        return false;
     }
-
     return true;
 }
 
 bool ArchiveWriter::addFile(const QString& fileDest, const QByteArray& data)
 {
-    std::unique_ptr<archive_entry, void (*)(archive_entry*)> entry_ptr(archive_entry_new(), archive_entry_free);
-    auto entry = entry_ptr.get();
-    if (!entry) {
-        qCritical() << "Failed to create archive entry";
+    QBuffer buffer;
+    buffer.setData(data);
+    buffer.open(QIODevice::ReadOnly);
+    if (!writeEntry(newEntry(fileDest, s_modeFile | 0644, QDateTime::currentDateTime()), buffer, data.size())) {
+        qCritical() << "Write error in archive for: " << fileDest;
         return false;
     }
+    return true;
+}
 
-    auto fileDestUtf8 = fileDest.toUtf8();
-    archive_entry_set_pathname_utf8(entry, fileDestUtf8.constData());
-    archive_entry_set_perm(entry, 0644);
+bool ArchiveWriter::addFile(ArchiveReader::File* f)
+{
+    auto name = f->filename();
+    // archives without unix attributes don't have any permissions either
+    auto permissions = f->mode() & 07777;
+    if (f->isSymLink()) {
+        // links are stored as their target, like addFile() does for the ones on disk
+        QBuffer target;
+        target.setData(f->symLinkTarget().toUtf8());
+        target.open(QIODevice::ReadOnly);
+        auto level = std::exchange(m_compressionLevel, 0);
+        bool ok = writeEntry(newEntry(name, s_modeLink | (permissions ? permissions : 0777), f->dateTime()), target, target.size());
+        m_compressionLevel = level;
+        return ok;
+    }
+    if (!f->isFile()) {
+        if (!name.endsWith('/')) {
+            qWarning() << "Skipping unsupported entry" << name;
+            return f->skip();
+        }
+        QBuffer empty;
+        empty.open(QIODevice::ReadOnly);
+        return writeEntry(newEntry(name, s_modeDir | (permissions ? permissions : 0755), f->dateTime()), empty, 0);
+    }
 
-    archive_entry_set_filetype(entry, AE_IFREG);
-    archive_entry_set_size(entry, data.size());
+    ArchiveFileDevice data(f);
+    // an unknown size may be a large one, which only fits with zip64
+    auto size = f->size() < 0 ? qint64(s_zip64Threshold) : f->size();
+    if (!writeEntry(newEntry(name, s_modeFile | (permissions ? permissions : 0644), f->dateTime()), data, size)) {
+        qCritical() << "Failed to copy" << name << "-" << data.errorString();
+        return false;
+    }
+    return true;
+}
 
-    if (archive_write_header(m_archive, entry) != ARCHIVE_OK) {
-        qCritical() << "Failed to write header for: " << fileDest << "-" << archive_error_string(m_archive);
+bool ArchiveWriter::addEntry(const ZipIndex& source, const ZipIndex::Entry& sourceEntry, const QString& fileDest)
+{
+    const auto raw = source.rawData(sourceEntry);
+    if (quint64(raw.size()) != sourceEntry.compressedSize) {
+        qCritical() << "Broken local header for" << sourceEntry.name;
         return false;
     }
 
-    if (archive_write_data(m_archive, data.constData(), data.size()) < 0) {
-        qCritical() << "Write error in archive for: " << fileDest << "-" << archive_error_string(m_archive);
+    Entry entry;
+    entry.name = (fileDest.isEmpty() ? sourceEntry.name : fileDest).toUtf8();
+    if (entry.name.size() > qsizetype(s_max16)) {
+        qCritical() << "File name too long for a zip entry:" << entry.name;
+        return false;
+    }
+    entry.versionMadeBy = sourceEntry.versionMadeBy;
+    // the sizes go in the local header now, and the name was written as utf-8
+    entry.flags = quint16((sourceEntry.flags & ~s_flagDataDescriptor) | s_flagUtf8);
+    entry.method = sourceEntry.method;
+    entry.dosTime = sourceEntry.dosTime;
+    entry.dosDate = sourceEntry.dosDate;
+    entry.crc32 = sourceEntry.crc32;
+    entry.compressedSize = sourceEntry.compressedSize;
+    entry.uncompressedSize = sourceEntry.uncompressedSize;
+    entry.externalAttributes = sourceEntry.externalAttributes;
+    entry.localHeaderOffset = quint64(m_file.pos());
+
+    const bool zip64 = entry.compressedSize >= s_max32 || entry.uncompressedSize >= s_max32;
+    if (!writeLocalHeader(entry, zip64) || m_file.write(raw.data(), raw.size()) != raw.size()) {
+        qCritical() << "Write error in archive for: " << entry.name;
         return false;
     }
+    m_entries.append(entry);
     return true;
 }
 
-bool ArchiveWriter::addFile(ArchiveReader::File* f)
+bool ArchiveWriter::writeCentralDirectory()
 {
-    return f->writeFile(m_archive, "", true);
+    const quint64 cdOffset = quint64(m_file.pos());
+
+    QByteArray directory;
+    for (const auto& entry : std::as_const(m_entries)) {
+        QByteArray zip64;
+        auto field = [&zip64](quint64 value) {
+            if (value >= s_max32)
+                put<quint64>(zip64, value);
+            return quint32(qMin(value, s_max32));
+        };
+        const auto uncompressedSize = field(entry.uncompressedSize);
+        const auto compressedSize = field(entry.compressedSize);
+        const auto localHeaderOffset = field(entry.localHeaderOffset);
+
+        put<quint32>(directory, s_centralHeaderSig);
+        put<quint16>(directory, entry.versionMadeBy);
+        put<quint16>(directory, zip64.isEmpty() ? s_versionNeeded : s_versionNeededZip64);
+        put<quint16>(directory, entry.flags);
+        put<quint16>(directory, entry.method);
+        put<quint16>(directory, entry.dosTime);
+        put<quint16>(directory, entry.dosDate);
+        put<quint32>(directory, entry.crc32);
+        put<quint32>(directory, compressedSize);
+        put<quint32>(directory, uncompressedSize);
+        put<quint16>(directory, quint16(entry.name.size()));
+        put<quint16>(directory, zip64.isEmpty() ? 0 : quint16(zip64.size() + 4));
+        put<quint16>(directory, 0);  // comment
+        put<quint16>(directory, 0);  // disk
+        put<quint16>(directory, 0);  // internal attributes
+        put<quint32>(directory, entry.externalAttributes);
+        put<quint32>(directory, localHeaderOffset);
+        directory.append(entry.name);
+        if (!zip64.isEmpty()) {
+            put<quint16>(directory, s_zip64ExtraId);
+            put<quint16>(directory, quint16(zip64.size()));
+            directory.append(zip64);
+        }
+    }
+    const quint64 cdSize = quint64(directory.size());
+    const quint64 count = quint64(m_entries.size());
+
+    QByteArray end;
+    if (count >= s_max16 || cdOffset >= s_max32 || cdSize >= s_max32) {
+        const quint64 zip64End = cdOffset + cdSize;
+        put<quint32>(end, s_zip64EndOfCentralDirSig);
+        put<quint64>(end, 44);  // size of the rest of the record
+        put<quint16>(end, s_versionMadeBy);
+        put<quint16>(end, s_versionNeededZip64);
+        put<quint32>(end, 0);
+        put<quint32>(end, 0);
+        put<quint64>(end, count);
+        put<quint64>(end, count);
+        put<quint64>(end, cdSize);
+        put<quint64>(end, cdOffset);
+
+        put<quint32>(end, s_zip64LocatorSig);
+        put<quint32>(end, 0);
+        put<quint64>(end, zip64End);
+        put<quint32>(end, 1);
+    }
+    put<quint32>(end, s_endOfCentralDirSig);
+    put<quint16>(end, 0);
+    put<quint16>(end, 0);
+    put<quint16>(end, quint16(qMin(count, s_max16)));
+    put<quint16>(end, quint16(qMin(count, s_max16)));
+    put<quint32>(end, quint32(qMin(cdSize, s_max32)));
+    put<quint32>(end, quint32(qMin(cdOffset, s_max32)));
+    put<quint16>(end, 0);  // comment
+
+    directory.append(end);
+    return m_file.write(directory) == directory.size();
 }
 
 std::unique_ptr<archive, void (*)(archive*)> ArchiveWriter::createDiskWriter()
@@ -18,17 +18,34 @@
 #pragma once
 
 #include <QByteArray>
+#include <QDateTime>
+#include <QFile>
 #include <QFileDevice>
+#include <QList>
+
+#include <optional>
+
 #include "archive/ArchiveReader.h"
+#include "archive/ZipIndex.h"
 
 struct archive;
 namespace MMCZip {
 
+/**
+ * Writes zip archives.
+ *
+ * The zip format is written here directly rather than through libarchive, which can only take entries as
+ * uncompressed data. That way entries of another zip can be copied with addEntry() exactly as they are stored,
+ * compressed data and crc included, without inflating and deflating them again.
+ */
 class ArchiveWriter {
    public:
     ArchiveWriter(const QString& archiveName);
     virtual ~ArchiveWriter();
 
+    /** Deflate level of the entries written from now on, from 0 (stored as they are) to 9. Must be set before open(). */
+    void setCompressionLevel(int level) { m_compressionLevel = level; }
+
     bool open();
     bool close();
 
@@ -36,11 +53,53 @@ class ArchiveWriter {
     bool addFile(const QString& fileDest, const QByteArray& data);
     bool addFile(ArchiveReader::File* f);
 
+    /** Copies 'entry' from 'source' as it is stored there, under 'fileDest' or its own name. */
+    bool addEntry(const ZipIndex& source, const ZipIndex::Entry& entry, const QString& fileDest = {});
+
+    /** Starts an entry whose data, already compressed with 'method', is then passed to addRawData(). */
+    bool beginEntry(const QString& fileDest,
+                    quint16 method,
+                    quint64 uncompressedSize,
+                    const QDateTime& modified,
+                    QFileDevice::Permissions permissions);
+    bool addRawData(QByteArrayView data);
+    /** Fills in the crc and size of the entry started by beginEntry(). */
+    bool endEntry(quint32 crc32, quint64 uncompressedSize);
+
+    /**
+     * Deflates one chunk of a file, on any thread. The chunks of a file concatenated in order make up its entry data.
+     * 'dictionary' is the data right before the chunk, so the chunk compresses as well as it would in one piece.
+     */
+    static std::optional<QByteArray> deflateChunk(QByteArrayView data, QByteArrayView dictionary, int level, bool last);
+
     static std::unique_ptr<archive, void (*)(archive*)> createDiskWriter();
 
    private:
-    struct archive* m_archive = nullptr;
+    struct Entry {
+        QByteArray name;
+        quint16 versionMadeBy = 0;
+        quint16 flags = 0;
+        quint16 method = 0;
+        quint16 dosTime = 0;
+        quint16 dosDate = 0;
+        quint32 crc32 = 0;
+        quint64 compressedSize = 0;
+        quint64 uncompressedSize = 0;
+        quint64 localHeaderOffset = 0;
+        quint32 externalAttributes = 0;
+    };
+
+    Entry newEntry(const QString& fileDest, quint32 mode, const QDateTime& modified) const;
+    bool writeEntry(Entry entry, QIODevice& input, qint64 size);
+    bool startEntry(Entry entry, bool zip64);
+    bool writeLocalHeader(const Entry& entry, bool zip64);
+    bool writeCentralDirectory();
+
+    QFile m_file;
     QString m_filename;
-    QString m_format = "zip";
+    int m_compressionLevel = -1;  // zlib's default
+    QList<Entry> m_entries;
+    std::optional<Entry> m_current;
+    bool m_currentZip64 = false;
 };
-}  // namespace MMCZip
\ No newline at end of file
+}  // namespace MMCZip
@@ -19,9 +19,55 @@
 
 #include <QtConcurrent>
 
+#include <deque>
+
+#include <zlib.h>
+
 #include "FileSystem.h"
 
 namespace MMCZip {
+namespace {
+// files are compressed in chunks of this size, so a large file is spread over all workers too
+constexpr qint64 s_chunkSize = 4 * 1024 * 1024;
+// how far back deflate looks, each chunk is primed with that much of the data before it
+constexpr qint64 s_windowSize = 32 * 1024;
+
+const QStringList s_compressedSuffixes = { "jar", "zip", "mrpack", "png", "jpg", "jpeg", "ogg", "gz", "xz", "7z" };
+
+struct Chunk {
+    bool ok = false;
+    QByteArray data;
+    quint32 crc32 = 0;
+    qint64 size = 0;
+};
+
+Chunk compressChunk(const QString& path, qint64 offset, qint64 length, int level, bool last)
+{
+    Chunk chunk;
+    QFile file(path);
+    const qint64 start = level == 0 ? offset : qMax<qint64>(0, offset - s_windowSize);
+    if (!file.open(QIODevice::ReadOnly) || !file.seek(start))
+        return chunk;
+    const auto data = file.read(offset - start + length);
+    if (data.size() != offset - start + length)
+        return chunk;
+
+    const auto input = QByteArrayView(data).sliced(offset - start);
+    chunk.crc32 = quint32(crc32(crc32(0, nullptr, 0), reinterpret_cast<const Bytef*>(input.data()), uInt(input.size())));
+    chunk.size = input.size();
+    if (level == 0) {
+        chunk.data = data;
+    } else {
+        auto deflated = ArchiveWriter::deflateChunk(input, QByteArrayView(data).first(offset - start), level, last);
+        if (!deflated)
+            return chunk;
+        chunk.data = std::move(*deflated);
+    }
+    chunk.ok = true;
+    return chunk;
+}
+}  // namespace
+
 void ExportToZipTask::executeTask()
 {
     setStatus("Adding files...");
@@ -31,6 +77,10 @@ void ExportToZipTask::executeTask()
     m_buildZipWatcher.setFuture(m_buildZipFuture);
 }
 
+/**
+ * The files are cut into chunks that the compress pool deflates independently, while this thread writes the finished chunks to the
+ * archive in order. Only a few chunks per worker are in flight at any time, so memory use doesn't depend on the size of the files.
+ */
 auto ExportToZipTask::exportZip() -> ZipResult
 {
     if (!m_dir.exists()) {
@@ -48,24 +98,92 @@ auto ExportToZipTask::exportZip() -> ZipResult
         }
     }
 
+    struct Item {
+        QFileInfo source;
+        QString relative;
+        int level;
+        bool direct;  // written by ArchiveWriter::addFile() instead, e.g. symlinks
+    };
+    QList<Item> items;
     for (const QFileInfo& file : m_files) {
-        if (m_buildZipFuture.isCanceled())
-            return ZipResult();
-
         auto absolute = file.absoluteFilePath();
         auto relative = m_dir.relativeFilePath(absolute);
-        setStatus("Compressing: " + relative);
-        setProgress(m_progress + 1, m_progressTotal);
+        if (m_excludeFiles.contains(relative))
+            continue;
         if (m_followSymlinks) {
             if (file.isSymLink())
                 absolute = file.symLinkTarget();
             else
                 absolute = file.canonicalFilePath();
         }
+        QFileInfo source(absolute);
+        int level = m_compressionLevel;
+        if (m_storeCompressedFiles && s_compressedSuffixes.contains(source.suffix(), Qt::CaseInsensitive))
+            level = 0;
+        items.append({ source, relative, level, source.isSymLink() || !source.isFile() });
+    }
+    setProgress(0, items.size());
+
+    const qsizetype maxPending = qMax(1, m_compressPool.maxThreadCount()) * 2;
+    std::deque<QFuture<Chunk>> pending;
+    qsizetype nextItem = 0;
+    qint64 nextOffset = 0;
+    auto submit = [&] {
+        while (qsizetype(pending.size()) < maxPending && nextItem < items.size()) {
+            const auto& item = items[nextItem];
+            const auto size = item.source.size();
+            if (item.direct || size == 0) {
+                nextItem++;
+                continue;
+            }
+            const auto length = qMin(s_chunkSize, size - nextOffset);
+            const bool last = nextOffset + length >= size;
+            pending.push_back(QtConcurrent::run(&m_compressPool, compressChunk, item.source.absoluteFilePath(), nextOffset, length,
+                                                item.level, last));
+            nextOffset += length;
+            if (last) {
+                nextItem++;
+                nextOffset = 0;
+            }
+        }
+    };
+
+    for (const auto& item : items) {
+        if (m_buildZipFuture.isCanceled())
+            return ZipResult();
+
+        setStatus("Compressing: " + item.relative);
+        setProgress(m_progress + 1, m_progressTotal);
+        submit();
+
+        const auto dest = m_destinationPrefix + item.relative;
+        if (item.direct) {
+            if (!m_output.addFile(item.source.absoluteFilePath(), dest))
+                return ZipResult(tr("Could not read and compress %1").arg(item.relative));
+            continue;
+        }
+
+        const auto size = item.source.size();
+        const auto method = (item.level == 0 || size == 0) ? ZipIndex::Stored : ZipIndex::Deflated;
+        if (!m_output.beginEntry(dest, method, quint64(size), item.source.lastModified(), item.source.permissions()))
+            return ZipResult(tr("Could not read and compress %1").arg(item.relative));
+
+        uLong crc = crc32(0, nullptr, 0);
+        for (qint64 offset = 0; offset < size; offset += s_chunkSize) {
+            if (m_buildZipFuture.isCanceled())
+                return ZipResult();
+            auto future = std::move(pending.front());
+            pending.pop_front();
+            // keep the workers busy while this chunk is written
+            submit();
 
-        if (!m_excludeFiles.contains(relative) && !m_output.addFile(absolute, m_destinationPrefix + relative)) {
-            return ZipResult(tr("Could not read and compress %1").arg(relative));
+            const auto chunk = future.result();
+            if (!chunk.ok || !m_output.addRawData(chunk.data))
+                return ZipResult(tr("Could not read and compress %1").arg(item.relative));
+            crc = crc32_combine(crc, chunk.crc32, chunk.size);
         }
+        if (!m_output.endEntry(quint32(crc), quint64(size)))
+            return ZipResult(tr("Could not read and compress %1").arg(item.relative));
     }
 
     if (!m_output.close()) {
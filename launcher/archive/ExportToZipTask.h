@@ -21,6 +21,7 @@
 #include <QFileInfoList>
 #include <QFuture>
 #include <QFutureWatcher>
+#include <QThreadPool>
 
 #include "archive/ArchiveWriter.h"
 #include "tasks/Task.h"
@@ -46,6 +47,12 @@ class ExportToZipTask : public Task {
 
     void setExcludeFiles(QStringList excludeFiles) { m_excludeFiles = excludeFiles; }
     void addExtraFile(QString fileName, QByteArray data) { m_extraFiles.insert(fileName, data); }
+    /** Deflate level of the exported files, from 0 (store everything) to 9. */
+    void setCompressionLevel(int level) { m_compressionLevel = level; }
+    /** Whether files that are compressed already (jars, zips, pngs, oggs...) are stored rather than deflated again. */
+    void setStoreCompressedFiles(bool store) { m_storeCompressedFiles = store; }
+    /** Number of threads compressing files, one per core by default. */
+    void setThreadCount(int count) { m_compressPool.setMaxThreadCount(count); }
 
     using ZipResult = std::optional<QString>;
 
@@ -65,6 +72,9 @@ class ExportToZipTask : public Task {
     bool m_followSymlinks;
     QStringList m_excludeFiles;
     QHash<QString, QByteArray> m_extraFiles;
+    int m_compressionLevel = -1;  // zlib's default
+    bool m_storeCompressedFiles = true;
+    QThreadPool m_compressPool;
 
     QFuture<ZipResult> m_buildZipFuture;
     QFutureWatcher<ZipResult> m_buildZipWatcher;
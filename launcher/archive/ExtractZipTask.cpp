@@ -18,8 +18,10 @@
 #include "ExtractZipTask.h"
 #include <QtConcurrent>
 #include "FileSystem.h"
+#include "StringUtils.h"
 #include "archive/ArchiveReader.h"
 #include "archive/ArchiveWriter.h"
+#include "archive/ZipExtractor.h"
 
 namespace MMCZip {
 
@@ -37,6 +39,24 @@ auto ExtractZipTask::extractZip() -> ZipResult
 
     QStringList extracted;
 
+    // zips are extracted on several threads, anything else goes through libarchive
+    ZipExtractor extractor(m_input.getZipName(), m_subdirectory, target);
+    if (extractor.open()) {
+        setStatus(tr("Extracting files..."));
+        connect(
+            &extractor, &ZipExtractor::progress, this,
+            [this, &extractor](qint64 bytesDone, qint64 bytesTotal, qint64 bytesPerSecond) {
+                if (m_zipFuture.isCanceled())
+                    extractor.cancel();
+                setProgress(bytesDone, bytesTotal);
+                setDetails(tr("%1 /s").arg(StringUtils::humanReadableFileSize(bytesPerSecond)));
+            },
+            Qt::DirectConnection);
+        if (!extractor.extract() && !extractor.wasCanceled())
+            return ZipResult(extractor.errorString());
+        return ZipResult();
+    }
+
     qDebug() << "Extracting subdir" << m_subdirectory << "from" << m_input.getZipName() << "to" << target;
     if (!m_input.collectFiles()) {
         return ZipResult(tr("Failed to enumerate files in archive"));
@@ -0,0 +1,212 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  Prism Launcher - Minecraft Launcher
+ *  Copyright (c) 2026 Prism Launcher Contributors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "ZipExtractor.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QScopeGuard>
+#include <QSemaphore>
+#include <QSet>
+#include <QUrl>
+#include <QtConcurrent>
+
+#include "FileSystem.h"
+
+namespace MMCZip {
+
+namespace {
+constexpr quint16 s_flagEncrypted = 0x0001;
+constexpr quint16 s_hostUnix = 3;
+constexpr quint32 s_modeTypeMask = 0170000;
+constexpr quint32 s_modeLink = 0120000;
+
+// how often extract() reports progress and checks for cancellation
+constexpr int s_progressInterval = 100;
+
+quint32 unixMode(const ZipIndex::Entry& entry)
+{
+    return (entry.versionMadeBy >> 8) == s_hostUnix ? entry.externalAttributes >> 16 : 0;
+}
+
+QFileDevice::Permissions fromUnixMode(quint32 mode)
+{
+    QFileDevice::Permissions permissions;
+    const std::pair<quint32, QFileDevice::Permissions> bits[] = {
+        { 0400, QFileDevice::ReadOwner | QFileDevice::ReadUser },
+        { 0200, QFileDevice::WriteOwner | QFileDevice::WriteUser },
+        { 0100, QFileDevice::ExeOwner | QFileDevice::ExeUser },
+        { 0040, QFileDevice::ReadGroup },
+        { 0020, QFileDevice::WriteGroup },
+        { 0010, QFileDevice::ExeGroup },
+        { 0004, QFileDevice::ReadOther },
+        { 0002, QFileDevice::WriteOther },
+        { 0001, QFileDevice::ExeOther },
+    };
+    for (const auto& [bit, permission] : bits) {
+        if (mode & bit)
+            permissions |= permission;
+    }
+    return permissions;
+}
+
+QDateTime fromDosTime(quint16 date, quint16 time)
+{
+    return QDateTime(QDate(1980 + (date >> 9), (date >> 5) & 0xF, date & 0x1F), QTime(time >> 11, (time >> 5) & 0x3F, (time & 0x1F) * 2));
+}
+
+// identifies the file an entry ends up as. on the usual file systems of Windows and macOS, names that only differ in case are the same file
+QString fileKey(const QString& path)
+{
+#if defined(Q_OS_WIN) || defined(Q_OS_MACOS)
+    return path.toCaseFolded();
+#else
+    return path;
+#endif
+}
+}  // namespace
+
+ZipExtractor::ZipExtractor(const QString& archive, const QString& subdirectory, const QString& target)
+    : m_index(archive), m_subdirectory(subdirectory), m_target(target)
+{}
+
+bool ZipExtractor::open()
+{
+    if (!m_index.open())
+        return false;
+    for (const auto& entry : m_index.entries()) {
+        if ((entry.flags & s_flagEncrypted) || (entry.method != ZipIndex::Stored && entry.method != ZipIndex::Deflated) ||
+            (unixMode(entry) & s_modeTypeMask) == s_modeLink)
+            return false;
+    }
+    return true;
+}
+
+void ZipExtractor::fail(const QString& error)
+{
+    QMutexLocker locker(&m_errorLock);
+    if (!m_failed.exchange(true))
+        m_error = error;
+}
+
+std::optional<QStringList> ZipExtractor::extract()
+{
+    const auto targetTopDir = QUrl::fromLocalFile(m_target);
+
+    struct Job {
+        const ZipIndex::Entry* entry;
+        QString path;
+    };
+    QList<Job> jobs;
+    QHash<QString, qsizetype> jobsByPath;
+    QSet<QString> folders;
+    QStringList extracted;
+    qint64 bytesTotal = 0;
+
+    qDebug() << "Extracting subdir" << m_subdirectory << "with" << m_pool.maxThreadCount() << "threads to" << m_target;
+    for (const auto& entry : m_index.entries()) {
+        auto fileName = m_removeInvalidPathChars ? FS::RemoveInvalidPathChars(entry.name) : entry.name;
+        if (!fileName.startsWith(m_subdirectory))
+            continue;
+
+        auto relativeFileName = QDir::fromNativeSeparators(fileName.mid(m_subdirectory.size()));
+        // Fix subdirs/files ending with a / getting transformed into absolute paths
+        if (relativeFileName.startsWith('/'))
+            relativeFileName = relativeFileName.mid(1);
+
+        auto path = relativeFileName.isEmpty() ? m_target : FS::PathCombine(targetTopDir.toLocalFile(), relativeFileName);
+        if (relativeFileName.isEmpty() || relativeFileName.endsWith('/')) {
+            if (!relativeFileName.isEmpty() && !targetTopDir.isParentOf(QUrl::fromLocalFile(path + '/'))) {
+                m_error = tr("Extracting %1 was cancelled, because it was effectively outside of the target path %2")
+                              .arg(relativeFileName, m_target);
+                return std::nullopt;
+            }
+            folders.insert(path);
+            extracted.append(path + '/');
+            continue;
+        }
+
+        if (!targetTopDir.isParentOf(QUrl::fromLocalFile(path))) {
+            m_error =
+                tr("Extracting %1 was cancelled, because it was effectively outside of the target path %2").arg(relativeFileName, m_target);
+            return std::nullopt;
+        }
+        folders.insert(QFileInfo(path).path());
+
+        // the last of several entries for the same file wins, as it would when extracting them one after the other.
+        // they must not go to different workers, which would write the file at the same time
+        const auto key = fileKey(path);
+        if (auto it = jobsByPath.constFind(key); it != jobsByPath.constEnd()) {
+            bytesTotal -= qint64(jobs[*it].entry->uncompressedSize);
+            jobs[*it].entry = &entry;
+        } else {
+            jobsByPath.insert(key, jobs.size());
+            jobs.append({ &entry, path });
+            extracted.append(path);
+        }
+        bytesTotal += qint64(entry.uncompressedSize);
+    }
+
+    for (const auto& folder : std::as_const(folders)) {
+        if (!FS::ensureFolderPathExists(folder)) {
+            m_error = tr("Failed to create folder %1").arg(folder);
+            return std::nullopt;
+        }
+    }
+
+    // the workers release one permit per job, skipped or not, so the wait below can't outlive them
+    QSemaphore finishedJobs;
+    auto future = QtConcurrent::map(&m_pool, jobs, [this, &finishedJobs](const Job& job) {
+        auto release = qScopeGuard([&finishedJobs] { finishedJobs.release(); });
+        if (m_canceled || m_failed)
+            return;
+
+        QFile output(job.path);
+        if (!output.open(QIODevice::WriteOnly | QIODevice::Truncate) || !m_index.extract(*job.entry, output)) {
+            fail(tr("Failed to extract file %1 to %2").arg(job.entry->name, job.path));
+            return;
+        }
+        output.setFileTime(fromDosTime(job.entry->dosDate, job.entry->dosTime), QFileDevice::FileModificationTime);
+        output.close();
+        if (auto mode = unixMode(*job.entry); mode != 0)
+            output.setPermissions(fromUnixMode(mode));
+        m_bytesDone += qint64(job.entry->uncompressedSize);
+    });
+
+    QElapsedTimer timer;
+    timer.start();
+    auto reportProgress = [this, &timer, bytesTotal] {
+        const qint64 done = m_bytesDone;
+        emit progress(done, bytesTotal, done * 1000 / qMax<qint64>(1, timer.elapsed()));
+    };
+    while (!finishedJobs.tryAcquire(int(jobs.size()), s_progressInterval))
+        reportProgress();
+    future.waitForFinished();
+    reportProgress();
+
+    if (m_canceled || m_failed) {
+        FS::removeFiles(extracted);
+        if (m_canceled && !m_failed)
+            m_error = tr("Extraction was cancelled");
+        return std::nullopt;
+    }
+    qDebug() << "Extracted" << jobs.size() << "files," << bytesTotal << "bytes in" << timer.elapsed() << "ms";
+    return extracted;
+}
+
+}  // namespace MMCZip
@@ -0,0 +1,78 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  Prism Launcher - Minecraft Launcher
+ *  Copyright (c) 2026 Prism Launcher Contributors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <QMutex>
+#include <QObject>
+#include <QStringList>
+#include <QThreadPool>
+
+#include <atomic>
+#include <optional>
+
+#include "archive/ZipIndex.h"
+
+namespace MMCZip {
+
+/**
+ * Extracts (a subdirectory of) a zip archive on several threads.
+ *
+ * The central directory is read up front and the folders are all created before any file is written. A pool of workers then inflates
+ * the entries straight from the mapped archive, each through a fixed size buffer, so memory use doesn't depend on the size of the entries.
+ */
+class ZipExtractor : public QObject {
+    Q_OBJECT
+   public:
+    ZipExtractor(const QString& archive, const QString& subdirectory, const QString& target);
+
+    /** Reads the central directory. False if the file isn't a zip, or has entries this can't extract (symlinks, encryption...). */
+    bool open();
+
+    /** Runs the entry names through FS::RemoveInvalidPathChars before matching them against the subdirectory. */
+    void setRemoveInvalidPathChars(bool remove) { m_removeInvalidPathChars = remove; }
+    void setThreadCount(int count) { m_pool.setMaxThreadCount(count); }
+
+    /** Blocks until everything is extracted. On failure the files written so far are removed again. */
+    std::optional<QStringList> extract();
+
+    /** Makes extract() stop and fail, from any thread. */
+    void cancel() { m_canceled = true; }
+    bool wasCanceled() const { return m_canceled; }
+    QString errorString() const { return m_error; }
+
+   signals:
+    /** Emitted by the thread running extract(), a few times per second. */
+    void progress(qint64 bytesDone, qint64 bytesTotal, qint64 bytesPerSecond);
+
+   private:
+    void fail(const QString& error);
+
+    ZipIndex m_index;
+    QString m_subdirectory;
+    QString m_target;
+    bool m_removeInvalidPathChars = false;
+
+    QThreadPool m_pool;
+    std::atomic<bool> m_canceled = false;
+    std::atomic<bool> m_failed = false;
+    std::atomic<qint64> m_bytesDone = 0;
+    QMutex m_errorLock;
+    QString m_error;
+};
+
+}  // namespace MMCZip
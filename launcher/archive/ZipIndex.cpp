@@ -0,0 +1,354 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  Prism Launcher - Minecraft Launcher
+ *  Copyright (c) 2026 Prism Launcher Contributors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "ZipIndex.h"
+
+#include <QDebug>
+#include <QtEndian>
+
+#include <zlib.h>
+
+namespace MMCZip {
+
+namespace {
+constexpr quint32 s_localHeaderSig = 0x04034b50;
+constexpr quint32 s_centralHeaderSig = 0x02014b50;
+constexpr quint32 s_endOfCentralDirSig = 0x06054b50;
+constexpr quint32 s_zip64EndOfCentralDirSig = 0x06064b50;
+constexpr quint32 s_zip64LocatorSig = 0x07064b50;
+
+constexpr qint64 s_localHeaderSize = 30;
+constexpr qint64 s_centralHeaderSize = 46;
+constexpr qint64 s_endOfCentralDirSize = 22;
+constexpr qint64 s_zip64EndOfCentralDirSize = 56;
+constexpr qint64 s_zip64LocatorSize = 20;
+constexpr qint64 s_maxCommentSize = 0xFFFF;
+
+constexpr quint16 s_zip64ExtraId = 0x0001;
+constexpr quint16 s_flagEncrypted = 0x0001;
+
+// deflate can't do better than this, anything claiming more is lying about its size
+constexpr quint64 s_maxDeflateRatio = 1032;
+
+template <typename T>
+T le(const uchar* p)
+{
+    return qFromLittleEndian<T>(p);
+}
+}  // namespace
+
+ZipIndex::~ZipIndex()
+{
+    if (m_data)
+        m_file.unmap(const_cast<uchar*>(m_data));
+}
+
+bool ZipIndex::open()
+{
+    if (isOpen())
+        return true;
+    if (!m_file.open(QFile::ReadOnly))
+        return false;
+    m_size = m_file.size();
+    if (m_size < s_endOfCentralDirSize)
+        return false;
+    m_data = m_file.map(0, m_size);
+    if (!m_data)
+        return false;
+
+    if (!readCentralDirectory()) {
+        qWarning() << "Could not read the central directory of" << m_file.fileName();
+        m_file.unmap(const_cast<uchar*>(m_data));
+        m_data = nullptr;
+        m_entries.clear();
+        m_byName.clear();
+        return false;
+    }
+    return true;
+}
+
+bool ZipIndex::readCentralDirectory()
+{
+    // the end of central directory record is at the very end, followed only by the archive comment
+    qint64 eocd = -1;
+    const qint64 lowest = qMax<qint64>(0, m_size - s_endOfCentralDirSize - s_maxCommentSize);
+    for (qint64 pos = m_size - s_endOfCentralDirSize; pos >= lowest; pos--) {
+        if (le<quint32>(m_data + pos) == s_endOfCentralDirSig) {
+            eocd = pos;
+            break;
+        }
+    }
+    if (eocd < 0)
+        return false;
+
+    quint64 count = le<quint16>(m_data + eocd + 10);
+    quint64 cdSize = le<quint32>(m_data + eocd + 12);
+    quint64 cdOffset = le<quint32>(m_data + eocd + 16);
+
+    if (count == 0xFFFF || cdSize == 0xFFFFFFFF || cdOffset == 0xFFFFFFFF) {
+        const qint64 locator = eocd - s_zip64LocatorSize;
+        if (locator < 0 || le<quint32>(m_data + locator) != s_zip64LocatorSig)
+            return false;
+        const quint64 zip64Eocd = le<quint64>(m_data + locator + 8);
+        if (m_size < s_zip64EndOfCentralDirSize || zip64Eocd > quint64(m_size - s_zip64EndOfCentralDirSize) ||
+            le<quint32>(m_data + zip64Eocd) != s_zip64EndOfCentralDirSig)
+            return false;
+        count = le<quint64>(m_data + zip64Eocd + 32);
+        cdSize = le<quint64>(m_data + zip64Eocd + 40);
+        cdOffset = le<quint64>(m_data + zip64Eocd + 48);
+    }
+    if (cdOffset > quint64(m_size) || cdSize > quint64(m_size) - cdOffset)
+        return false;
+
+    // don't trust the count for the reservation, a header takes at least s_centralHeaderSize bytes
+    m_entries.reserve(qMin<quint64>(count, cdSize / s_centralHeaderSize));
+    m_byName.reserve(m_entries.capacity());
+
+    const uchar* p = m_data + cdOffset;
+    const uchar* end = p + cdSize;
+    for (quint64 i = 0; i < count; i++) {
+        if (end - p < s_centralHeaderSize || le<quint32>(p) != s_centralHeaderSig)
+            return false;
+
+        Entry entry;
+        entry.versionMadeBy = le<quint16>(p + 4);
+        entry.flags = le<quint16>(p + 8);
+        entry.method = le<quint16>(p + 10);
+        entry.dosTime = le<quint16>(p + 12);
+        entry.dosDate = le<quint16>(p + 14);
+        entry.crc32 = le<quint32>(p + 16);
+        entry.compressedSize = le<quint32>(p + 20);
+        entry.uncompressedSize = le<quint32>(p + 24);
+        const quint16 nameLength = le<quint16>(p + 28);
+        const quint16 extraLength = le<quint16>(p + 30);
+        const quint16 commentLength = le<quint16>(p + 32);
+        entry.externalAttributes = le<quint32>(p + 38);
+        entry.localHeaderOffset = le<quint32>(p + 42);
+
+        if (end - p < s_centralHeaderSize + nameLength + extraLength + commentLength)
+            return false;
+
+        const auto* name = reinterpret_cast<const char*>(p + s_centralHeaderSize);
+        // the utf-8 flag is often missing from jars, but the names are utf-8 all the same
+        entry.name = QString::fromUtf8(name, nameLength);
+
+        // sizes that don't fit in 32 bits are stored in the zip64 extra field, in this order, only if needed
+        const uchar* extra = p + s_centralHeaderSize + nameLength;
+        const uchar* extraEnd = extra + extraLength;
+        while (extraEnd - extra >= 4) {
+            const quint16 id = le<quint16>(extra);
+            const quint16 size = le<quint16>(extra + 2);
+            const uchar* field = extra + 4;
+            if (extraEnd - field < size)
+                break;
+            if (id == s_zip64ExtraId) {
+                const uchar* fieldEnd = field + size;
+                auto take = [&field, fieldEnd](quint64& value) {
+                    if (value != 0xFFFFFFFF || fieldEnd - field < 8)
+                        return;
+                    value = le<quint64>(field);
+                    field += 8;
+                };
+                take(entry.uncompressedSize);
+                take(entry.compressedSize);
+                take(entry.localHeaderOffset);
+                break;
+            }
+            extra = field + size;
+        }
+
+        p += s_centralHeaderSize + nameLength + extraLength + commentLength;
+
+        // with duplicate names the first entry wins, like it does for a reader going through the archive in order
+        if (!m_byName.contains(entry.name))
+            m_byName.insert(entry.name, m_entries.size());
+        m_entries.append(std::move(entry));
+    }
+    return true;
+}
+
+auto ZipIndex::find(const QString& name) const -> const Entry*
+{
+    auto it = m_byName.constFind(name);
+    if (it == m_byName.constEnd())
+        return nullptr;
+    return &m_entries[*it];
+}
+
+QByteArrayView ZipIndex::rawData(const Entry& entry) const
+{
+    if (!isOpen() || m_size < s_localHeaderSize || entry.localHeaderOffset > quint64(m_size - s_localHeaderSize))
+        return {};
+    const uchar* header = m_data + entry.localHeaderOffset;
+    if (le<quint32>(header) != s_localHeaderSig)
+        return {};
+
+    // the local name and extra field may differ from the central directory ones, only their lengths matter
+    const quint64 dataOffset = entry.localHeaderOffset + s_localHeaderSize + le<quint16>(header + 26) + le<quint16>(header + 28);
+    if (dataOffset > quint64(m_size) || entry.compressedSize > quint64(m_size) - dataOffset)
+        return {};
+    return QByteArrayView(m_data + dataOffset, qsizetype(entry.compressedSize));
+}
+
+std::optional<QByteArray> ZipIndex::read(const Entry& entry) const
+{
+    if (entry.flags & s_flagEncrypted) {
+        qWarning() << "Cannot read encrypted entry" << entry.name << "from" << m_file.fileName();
+        return {};
+    }
+    // the sizes come straight from the archive, don't allocate whatever they claim
+    if (entry.uncompressedSize > MaxReadSize || entry.compressedSize > MaxReadSize) {
+        qWarning() << "Entry" << entry.name << "in" << m_file.fileName() << "is too large to read into memory";
+        return {};
+    }
+    const auto raw = rawData(entry);
+    if (raw.isNull() && entry.compressedSize != 0) {
+        qWarning() << "Broken local header for" << entry.name << "in" << m_file.fileName();
+        return {};
+    }
+
+    QByteArray data;
+    switch (entry.method) {
+        case Stored:
+            data = raw.toByteArray();
+            break;
+        case Deflated: {
+            if (entry.uncompressedSize == 0)
+                break;
+            if (entry.uncompressedSize > quint64(raw.size()) * s_maxDeflateRatio) {
+                qWarning() << "Entry" << entry.name << "in" << m_file.fileName() << "claims an impossible size";
+                return {};
+            }
+            data.resize(qsizetype(entry.uncompressedSize));
+
+            z_stream strm;
+            memset(&strm, 0, sizeof(strm));
+            // negative window bits: raw deflate, zip entries have no zlib header
+            if (inflateInit2(&strm, -MAX_WBITS) != Z_OK)
+                return {};
+            strm.next_in = const_cast<Bytef*>(reinterpret_cast<const Bytef*>(raw.data()));
+            strm.avail_in = uInt(raw.size());
+            strm.next_out = reinterpret_cast<Bytef*>(data.data());
+            strm.avail_out = uInt(data.size());
+            const int err = inflate(&strm, Z_FINISH);
+            inflateEnd(&strm);
+            if (err != Z_STREAM_END || strm.total_out != entry.uncompressedSize) {
+                qWarning() << "Failed to inflate" << entry.name << "from" << m_file.fileName();
+                return {};
+            }
+            break;
+        }
+        default:
+            qWarning() << "Unsupported compression method" << entry.method << "for" << entry.name << "in" << m_file.fileName();
+            return {};
+    }
+
+    if (::crc32(0, reinterpret_cast<const Bytef*>(data.constData()), uInt(data.size())) != entry.crc32) {
+        qWarning() << "CRC mismatch for" << entry.name << "in" << m_file.fileName();
+        return {};
+    }
+    return data;
+}
+
+std::optional<QByteArray> ZipIndex::read(const QString& name) const
+{
+    if (auto entry = find(name))
+        return read(*entry);
+    return {};
+}
+
+bool ZipIndex::extract(const Entry& entry, QIODevice& output) const
+{
+    if (entry.flags & s_flagEncrypted) {
+        qWarning() << "Cannot read encrypted entry" << entry.name << "from" << m_file.fileName();
+        return false;
+    }
+    const auto raw = rawData(entry);
+    if (quint64(raw.size()) != entry.compressedSize) {
+        qWarning() << "Broken local header for" << entry.name << "in" << m_file.fileName();
+        return false;
+    }
+
+    uLong crc = ::crc32(0, nullptr, 0);
+    quint64 written = 0;
+    auto write = [&output, &crc, &written, &entry](const char* data, qint64 size) {
+        crc = ::crc32(crc, reinterpret_cast<const Bytef*>(data), uInt(size));
+        written += quint64(size);
+        // stop right away instead of writing out more than the entry claims to hold
+        return written <= entry.uncompressedSize && output.write(data, size) == size;
+    };
+
+    switch (entry.method) {
+        case Stored: {
+            // in pieces, so the crc's uInt length can't overflow
+            constexpr qsizetype piece = 1024 * 1024;
+            for (qsizetype pos = 0; pos < raw.size(); pos += piece) {
+                if (!write(raw.data() + pos, qMin(piece, raw.size() - pos)))
+                    return false;
+            }
+            break;
+        }
+        case Deflated: {
+            z_stream strm;
+            memset(&strm, 0, sizeof(strm));
+            if (inflateInit2(&strm, -MAX_WBITS) != Z_OK)
+                return false;
+            auto* in = reinterpret_cast<const Bytef*>(raw.data());
+            quint64 inLeft = quint64(raw.size());
+            QByteArray buffer(256 * 1024, Qt::Uninitialized);
+            int err = Z_OK;
+            while (err == Z_OK) {
+                if (strm.avail_in == 0 && inLeft > 0) {
+                    strm.next_in = const_cast<Bytef*>(in);
+                    strm.avail_in = uInt(qMin<quint64>(inLeft, 0x40000000));
+                    in += strm.avail_in;
+                    inLeft -= strm.avail_in;
+                }
+                strm.next_out = reinterpret_cast<Bytef*>(buffer.data());
+                strm.avail_out = uInt(buffer.size());
+                err = inflate(&strm, Z_NO_FLUSH);
+                if ((err == Z_OK || err == Z_STREAM_END) && !write(buffer.constData(), buffer.size() - strm.avail_out)) {
+                    inflateEnd(&strm);
+                    return false;
+                }
+                // no progress possible: the data is cut short
+                if (err == Z_BUF_ERROR && strm.avail_in == 0 && inLeft == 0)
+                    break;
+                if (err == Z_BUF_ERROR)
+                    err = Z_OK;
+            }
+            inflateEnd(&strm);
+            if (err != Z_STREAM_END) {
+                qWarning() << "Failed to inflate" << entry.name << "from" << m_file.fileName();
+                return false;
+            }
+            break;
+        }
+        default:
+            qWarning() << "Unsupported compression method" << entry.method << "for" << entry.name << "in" << m_file.fileName();
+            return false;
+    }
+
+    if (written != entry.uncompressedSize || crc != entry.crc32) {
+        qWarning() << "CRC mismatch for" << entry.name << "in" << m_file.fileName();
+        return false;
+    }
+    return true;
+}
+
+}  // namespace MMCZip
@@ -0,0 +1,95 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  Prism Launcher - Minecraft Launcher
+ *  Copyright (c) 2026 Prism Launcher Contributors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QFile>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <optional>
+
+namespace MMCZip {
+
+/**
+ * Random access reader for zip files.
+ *
+ * Unlike ArchiveReader, which streams through every local header from the start of the file, this reads the
+ * central directory once and then inflates single entries straight from the mapped file. Metadata probes on
+ * large jars cost a few page reads instead of a pass over the whole archive.
+ *
+ * Only stored and deflated entries can be read. Callers should fall back to ArchiveReader when open() fails.
+ */
+class ZipIndex {
+   public:
+    struct Entry {
+        QString name;
+        quint64 localHeaderOffset = 0;
+        quint64 compressedSize = 0;
+        quint64 uncompressedSize = 0;
+        quint32 crc32 = 0;
+        quint16 method = 0;
+        quint16 flags = 0;
+        quint16 dosTime = 0;
+        quint16 dosDate = 0;
+        quint16 versionMadeBy = 0;
+        quint32 externalAttributes = 0;
+
+        bool isDir() const { return name.endsWith('/'); }
+    };
+
+    enum Method : quint16 { Stored = 0, Deflated = 8 };
+
+    // entries larger than this aren't read into memory, they have to be streamed with extract()
+    static constexpr quint64 MaxReadSize = 64 * 1024 * 1024;
+
+    explicit ZipIndex(QString fileName) : m_file(fileName) {}
+    ~ZipIndex();
+
+    // maps the file and reads the central directory. false if the file isn't a zip (or is broken)
+    bool open();
+    bool isOpen() const { return m_data != nullptr; }
+
+    // entries in central directory order. find() returns the first of several entries with the same name
+    const QList<Entry>& entries() const { return m_entries; }
+    const Entry* find(const QString& name) const;
+    bool contains(const QString& name) const { return find(name) != nullptr; }
+
+    // the bytes of the entry as stored in the archive, empty if the local header is broken
+    QByteArrayView rawData(const Entry& entry) const;
+
+    // the uncompressed contents of the entry, checked against its crc. nothing for entries above MaxReadSize
+    std::optional<QByteArray> read(const Entry& entry) const;
+    std::optional<QByteArray> read(const QString& name) const;
+
+    // streams the uncompressed contents of the entry into 'output', checked against its crc. safe to call from several threads at once
+    bool extract(const Entry& entry, QIODevice& output) const;
+
+   private:
+    bool readCentralDirectory();
+
+    QFile m_file;
+    const uchar* m_data = nullptr;
+    qint64 m_size = 0;
+
+    QList<Entry> m_entries;
+    QHash<QString, qsizetype> m_byName;
+};
+
+}  // namespace MMCZip
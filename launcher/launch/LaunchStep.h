@@ -30,6 +30,7 @@ class LaunchStep : public Task {
    signals:
     void logLines(QStringList lines, MessageLevel level);
     void logLine(QString line, MessageLevel level);
+    void logData(QByteArray data, MessageLevel level);
     void readyForLaunch();
     void progressReportingRequest();
 
@@ -42,7 +42,9 @@
 #include <QDebug>
 #include <QDir>
 #include <QStandardPaths>
+#include <utility>
 #include <variant>
+#include "FileSystem.h"
 #include "MessageLevel.h"
 #include "tasks/Task.h"
 
@@ -58,7 +60,12 @@ shared_qobject_ptr<LaunchTask> LaunchTask::create(MinecraftInstancePtr inst)
     return proc;
 }
 
-LaunchTask::LaunchTask(MinecraftInstancePtr instance) : m_instance(instance) {}
+LaunchTask::LaunchTask(MinecraftInstancePtr instance) : m_instance(instance)
+{
+    m_logFlushTimer.setSingleShot(true);
+    m_logFlushTimer.setInterval(16);
+    connect(&m_logFlushTimer, &QTimer::timeout, this, &LaunchTask::flushLogLines);
+}
 
 void LaunchTask::appendStep(shared_qobject_ptr<LaunchStep> step)
 {
@@ -73,6 +80,7 @@ void LaunchTask::prependStep(shared_qobject_ptr<LaunchStep> step)
 void LaunchTask::executeTask()
 {
     m_instance->setCrashed(false);
+    m_trace = std::make_unique<TaskTrace>();
     if (!m_steps.size()) {
         state = LaunchTask::Finished;
         emitSucceeded();
@@ -131,17 +139,12 @@ void LaunchTask::onProgressReportingRequested()
 
 void LaunchTask::setCensorFilter(QMap<QString, QString> filter)
 {
-    m_censorFilter = filter;
+    m_censorFilter = CensorFilter(filter);
 }
 
 QString LaunchTask::censorPrivateInfo(QString in)
 {
-    auto iter = m_censorFilter.begin();
-    while (iter != m_censorFilter.end()) {
-        in.replace(iter.key(), iter.value());
-        iter++;
-    }
-    return in;
+    return m_censorFilter.apply(in);
 }
 
 void LaunchTask::proceed()
@@ -231,43 +234,56 @@ bool LaunchTask::parseXmlLogs(QString const& line, MessageLevel level)
     parser->appendLine(line);
     auto items = parser->parseAvailable();
     if (auto err = parser->getError(); err.has_value()) {
-        auto& model = *getLogModel();
-        model.append(MessageLevel::Error, tr("[Log4j Parse Error] Failed to parse log4j log event: %1").arg(err.value().errMessage));
+        queueLogLine(MessageLevel::Error, tr("[Log4j Parse Error] Failed to parse log4j log event: %1").arg(err.value().errMessage));
         return false;
     }
 
     if (items.isEmpty())
         return true;
 
-    auto model = getLogModel();
     for (auto const& item : items) {
         if (std::holds_alternative<LogParser::LogEntry>(item)) {
             auto entry = std::get<LogParser::LogEntry>(item);
-            auto msg = QString("[%1] [%2/%3] [%4]: %5")
-                           .arg(entry.timestamp.toString("HH:mm:ss"))
-                           .arg(entry.thread)
-                           .arg(entry.levelText)
-                           .arg(entry.logger)
-                           .arg(entry.message);
-            msg = censorPrivateInfo(msg);
-            model->append(entry.level, msg);
+            queueLogLine(entry.level, censorPrivateInfo(Log4jTokenizer::format(entry)));
         } else if (std::holds_alternative<LogParser::PlainText>(item)) {
             auto msg = std::get<LogParser::PlainText>(item).message;
 
             MessageLevel newLevel = MessageLevel::takeFromLine(msg);
 
             if (newLevel == MessageLevel::Unknown)
-                newLevel = LogParser::guessLevel(line, model->previousLevel());
+                newLevel = LogParser::guessLevel(line, previousLogLevel());
 
             msg = censorPrivateInfo(msg);
 
-            model->append(newLevel, msg);
+            queueLogLine(newLevel, msg);
         }
     }
 
     return true;
 }
 
+void LaunchTask::onLogData(const QByteArray& data, MessageLevel level)
+{
+    traceGameOutput(level);
+    auto& tokenizer = level == MessageLevel::StdErr ? m_stderrTokenizer : m_stdoutTokenizer;
+    for (auto& item : tokenizer.feed(data)) {
+        if (auto entry = std::get_if<LogParser::LogEntry>(&item)) {
+            queueLogLine(entry->level, censorPrivateInfo(Log4jTokenizer::format(*entry)));
+        } else if (auto text = std::get_if<LogParser::PlainText>(&item)) {
+            auto msg = std::move(text->message);
+
+            MessageLevel newLevel = MessageLevel::takeFromLine(msg);
+
+            if (newLevel == MessageLevel::Unknown)
+                newLevel = LogParser::guessLevel(msg, previousLogLevel());
+
+            queueLogLine(newLevel, censorPrivateInfo(msg));
+        } else if (auto error = std::get_if<LogParser::Error>(&item)) {
+            queueLogLine(MessageLevel::Error, tr("[Log4j Parse Error] Failed to parse log4j log event: %1").arg(error->errMessage));
+        }
+    }
+}
+
 void LaunchTask::onLogLines(const QStringList& lines, MessageLevel defaultLevel)
 {
     for (auto& line : lines) {
@@ -277,6 +293,7 @@ void LaunchTask::onLogLines(const QStringList& lines, MessageLevel defaultLevel)
 
 void LaunchTask::onLogLine(QString line, MessageLevel level)
 {
+    traceGameOutput(level);
     if (parseXmlLogs(line, level)) {
         return;
     }
@@ -284,17 +301,78 @@ void LaunchTask::onLogLine(QString line, MessageLevel level)
     // censor private user info
     line = censorPrivateInfo(line);
 
-    getLogModel()->append(level, line);
+    queueLogLine(level, line);
+}
+
+void LaunchTask::queueLogLine(MessageLevel level, QString line)
+{
+    m_pendingLogLines.append({ level, std::move(line) });
+    if (!m_logFlushTimer.isActive())
+        m_logFlushTimer.start();
+}
+
+void LaunchTask::flushLogLines()
+{
+    m_logFlushTimer.stop();
+    if (!m_pendingLogLines.isEmpty())
+        getLogModel()->appendBatch(std::exchange(m_pendingLogLines, {}));
+}
+
+MessageLevel LaunchTask::previousLogLevel()
+{
+    if (!m_pendingLogLines.isEmpty())
+        return m_pendingLogLines.last().level;
+    return getLogModel()->previousLevel();
+}
+
+void LaunchTask::setPid(qint64 pid)
+{
+    m_pid = pid;
+    if (m_trace && pid > 0)
+        m_trace->mark("Game process started");
+}
+
+void LaunchTask::traceGameOutput(MessageLevel level)
+{
+    // the launch is over once the game prints something, the rest of the session doesn't belong in the trace
+    if (m_trace && m_pid > 0 && (level == MessageLevel::StdOut || level == MessageLevel::StdErr)) {
+        m_trace->mark("First game output");
+        finishTrace();
+    }
+}
+
+void LaunchTask::finishTrace()
+{
+    if (!m_trace)
+        return;
+    m_trace->stop();
+
+    queueLogLine(MessageLevel::Launcher, "Launch timing:");
+    for (auto& line : m_trace->summary())
+        queueLogLine(MessageLevel::Launcher, "  " + line);
+
+    const auto path = FS::PathCombine(m_instance->gameRoot(), "logs", "launch-trace.json");
+    try {
+        FS::write(path, m_trace->toChromeTrace(m_instance->name()));
+        queueLogLine(MessageLevel::Launcher, QString("Launch trace written to %1\n\n").arg(path));
+    } catch (const FS::FileSystemException& e) {
+        qWarning() << "Couldn't write the launch trace:" << e.cause();
+    }
+    m_trace.reset();
 }
 
 void LaunchTask::emitSucceeded()
 {
+    finishTrace();
+    flushLogLines();
     m_instance->setRunning(false);
     Task::emitSucceeded();
 }
 
 void LaunchTask::emitFailed(QString reason)
 {
+    finishTrace();
+    flushLogLines();
     m_instance->setRunning(false);
     m_instance->setCrashed(true);
     Task::emitFailed(reason);
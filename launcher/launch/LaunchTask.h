@@ -39,11 +39,15 @@
 #include <QObjectPtr.h>
 #include <minecraft/MinecraftInstance.h>
 #include <QProcess>
+#include <QTimer>
 #include "BaseInstance.h"
 #include "LaunchStep.h"
 #include "LogModel.h"
 #include "MessageLevel.h"
+#include "logs/CensorFilter.h"
+#include "logs/Log4jTokenizer.h"
 #include "logs/LogParser.h"
+#include "tasks/TaskTrace.h"
 
 class LaunchTask : public Task {
     Q_OBJECT
@@ -64,7 +68,7 @@ class LaunchTask : public Task {
 
     MinecraftInstancePtr instance() { return m_instance; }
 
-    void setPid(qint64 pid) { m_pid = pid; }
+    void setPid(qint64 pid);
 
     qint64 pid() { return m_pid; }
 
@@ -108,12 +112,19 @@ class LaunchTask : public Task {
    public slots:
     void onLogLines(const QStringList& lines, MessageLevel defaultLevel = MessageLevel::Launcher);
     void onLogLine(QString line, MessageLevel defaultLevel = MessageLevel::Launcher);
+    /** Raw UTF-8 game output, split into lines and log4j events here */
+    void onLogData(const QByteArray& data, MessageLevel level);
     void onReadyForLaunch();
     void onStepFinished();
     void onProgressReportingRequested();
 
    private: /*methods */
     void finalizeSteps(bool successful, const QString& error);
+    void queueLogLine(MessageLevel level, QString line);
+    void flushLogLines();
+    MessageLevel previousLogLevel();
+    void traceGameOutput(MessageLevel level);
+    void finishTrace();
 
    protected:
     bool parseXmlLogs(QString const& line, MessageLevel level);
@@ -122,10 +133,17 @@ class LaunchTask : public Task {
     MinecraftInstancePtr m_instance;
     shared_qobject_ptr<LogModel> m_logModel;
     QList<shared_qobject_ptr<LaunchStep>> m_steps;
-    QMap<QString, QString> m_censorFilter;
+    CensorFilter m_censorFilter;
     int currentStep = -1;
     State state = NotStarted;
     qint64 m_pid = -1;
     LogParser m_stdoutParser;
     LogParser m_stderrParser;
+    Log4jTokenizer m_stdoutTokenizer;
+    Log4jTokenizer m_stderrTokenizer;
+    // lines are handed to the log model at most once per frame, so the views don't redraw for every single one
+    QList<LogModel::entry> m_pendingLogLines;
+    QTimer m_logFlushTimer;
+    // how long each step and the tasks it ran took, until the game prints something
+    std::unique_ptr<TaskTrace> m_trace;
 };
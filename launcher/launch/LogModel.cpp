@@ -1,5 +1,7 @@
 #include "LogModel.h"
 
+#include <algorithm>
+
 LogModel::LogModel(QObject* parent) : QAbstractListModel(parent)
 {
     m_content.resize(m_maxLines);
@@ -32,28 +34,43 @@ QVariant LogModel::data(const QModelIndex& index, int role) const
 
 void LogModel::append(MessageLevel level, QString line)
 {
-    if (m_suspended) {
+    appendBatch({ entry{ level, std::move(line) } });
+}
+
+void LogModel::appendBatch(QList<entry> lines)
+{
+    if (m_suspended || lines.isEmpty()) {
         return;
     }
-    int lineNum = (m_firstLine + m_numLines) % m_maxLines;
-    // overflow
-    if (m_numLines == m_maxLines) {
-        if (m_stopOnOverflow) {
+    int first = 0;
+    int count = static_cast<int>(std::min<qsizetype>(lines.size(), m_maxLines));
+    if (m_stopOnOverflow) {
+        int room = m_maxLines - m_numLines;
+        if (room <= 0) {
             // nothing more to do, the buffer is full
             return;
         }
-        beginRemoveRows(QModelIndex(), 0, 0);
-        m_firstLine = (m_firstLine + 1) % m_maxLines;
-        m_numLines--;
+        if (count >= room) {
+            count = room;
+            lines[count - 1] = entry{ MessageLevel::Fatal, m_overflowMessage };
+        }
+    } else {
+        // only the newest lines would survive anyway
+        first = static_cast<int>(lines.size()) - count;
+    }
+    // overflow
+    int overflow = m_numLines + count - m_maxLines;
+    if (overflow > 0) {
+        beginRemoveRows(QModelIndex(), 0, overflow - 1);
+        m_firstLine = (m_firstLine + overflow) % m_maxLines;
+        m_numLines -= overflow;
         endRemoveRows();
-    } else if (m_numLines == m_maxLines - 1 && m_stopOnOverflow) {
-        level = MessageLevel::Fatal;
-        line = m_overflowMessage;
     }
-    beginInsertRows(QModelIndex(), m_numLines, m_numLines);
-    m_numLines++;
-    m_content[lineNum].level = level;
-    m_content[lineNum].line = line;
+    beginInsertRows(QModelIndex(), m_numLines, m_numLines + count - 1);
+    for (int i = first; i < first + count; i++) {
+        m_content[(m_firstLine + m_numLines) % m_maxLines] = std::move(lines[i]);
+        m_numLines++;
+    }
     endInsertRows();
 }
 
@@ -170,7 +187,7 @@ bool LogModel::isOverFlow()
 MessageLevel LogModel::previousLevel()
 {
     if (m_numLines > 0) {
-        return m_content[m_numLines - 1].level;
+        return m_content[(m_firstLine + m_numLines - 1) % m_maxLines].level;
     }
     return MessageLevel::Unknown;
 }
@@ -6,6 +6,12 @@
 
 class LogModel : public QAbstractListModel {
     Q_OBJECT
+   public /* types */:
+    struct entry {
+        MessageLevel level = MessageLevel::Unknown;
+        QString line;
+    };
+
    public:
     explicit LogModel(QObject* parent = 0);
 
@@ -13,6 +19,8 @@ class LogModel : public QAbstractListModel {
     QVariant data(const QModelIndex& index, int role) const;
 
     void append(MessageLevel, QString line);
+    // adds all of the lines with a single insertion (and at most one removal), for callers that get their lines in chunks
+    void appendBatch(QList<entry> lines);
     void clear();
 
     void suspend(bool suspend);
@@ -35,12 +43,6 @@ class LogModel : public QAbstractListModel {
 
     enum Roles { LevelRole = Qt::UserRole };
 
-   private /* types */:
-    struct entry {
-        MessageLevel level = MessageLevel::Unknown;
-        QString line;
-    };
-
    private: /* data */
     QList<entry> m_content;
     int m_maxLines = 1000;
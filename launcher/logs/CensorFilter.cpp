@@ -0,0 +1,113 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  Prism Launcher - Minecraft Launcher
+ *  Copyright (c) 2026 Prism Launcher Contributors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "CensorFilter.h"
+
+#include <algorithm>
+
+namespace {
+bool edgeBefore(const std::pair<char16_t, int>& edge, char16_t c)
+{
+    return edge.first < c;
+}
+}  // namespace
+
+CensorFilter::CensorFilter(const QMap<QString, QString>& replacements)
+{
+    m_nodes.emplace_back();
+    for (auto it = replacements.begin(); it != replacements.end(); ++it) {
+        if (it.key().isEmpty())
+            continue;
+        int node = 0;
+        for (auto c : it.key()) {
+            auto next = child(node, c.unicode());
+            if (next < 0) {
+                next = static_cast<int>(m_nodes.size());
+                m_nodes.emplace_back();
+                m_nodes[next].depth = m_nodes[node].depth + 1;
+                auto& edges = m_nodes[node].next;
+                edges.insert(std::lower_bound(edges.begin(), edges.end(), c.unicode(), edgeBefore), std::make_pair(c.unicode(), next));
+            }
+            node = next;
+        }
+        m_nodes[node].replacement = static_cast<int>(m_replacements.size());
+        m_nodes[node].matchLength = m_nodes[node].depth;
+        m_replacements.append(it.value());
+    }
+
+    // breadth first, so the fail target of a node is always done before the node itself
+    std::vector<int> queue{ 0 };
+    for (size_t i = 0; i < queue.size(); i++) {
+        const auto node = queue[i];
+        for (auto [c, next] : m_nodes[node].next) {
+            auto fail = 0;
+            if (node != 0) {
+                auto state = m_nodes[node].fail;
+                while ((fail = child(state, c)) < 0 && state != 0)
+                    state = m_nodes[state].fail;
+                fail = std::max(fail, 0);
+            }
+            m_nodes[next].fail = fail;
+            if (m_nodes[next].replacement < 0) {
+                m_nodes[next].replacement = m_nodes[fail].replacement;
+                m_nodes[next].matchLength = m_nodes[fail].matchLength;
+            }
+            queue.push_back(next);
+        }
+    }
+}
+
+int CensorFilter::child(int node, char16_t c) const
+{
+    auto& edges = m_nodes[node].next;
+    auto pos = std::lower_bound(edges.begin(), edges.end(), c, edgeBefore);
+    return pos != edges.end() && pos->first == c ? pos->second : -1;
+}
+
+QString CensorFilter::apply(const QString& in) const
+{
+    if (m_replacements.isEmpty())
+        return in;
+
+    QString out;
+    qsizetype copied = 0;
+    auto state = 0;
+    for (qsizetype i = 0; i < in.size(); i++) {
+        const auto c = in[i].unicode();
+        auto next = child(state, c);
+        while (next < 0 && state != 0) {
+            state = m_nodes[state].fail;
+            next = child(state, c);
+        }
+        state = std::max(next, 0);
+
+        auto& node = m_nodes[state];
+        if (node.replacement >= 0) {
+            if (copied == 0)
+                out.reserve(in.size());
+            const auto start = i + 1 - node.matchLength;
+            out.append(QStringView(in).sliced(copied, start - copied));
+            out.append(m_replacements[node.replacement]);
+            copied = i + 1;
+            state = 0;
+        }
+    }
+    if (copied == 0)
+        return in;
+    out.append(QStringView(in).sliced(copied));
+    return out;
+}
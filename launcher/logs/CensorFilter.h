@@ -0,0 +1,56 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  Prism Launcher - Minecraft Launcher
+ *  Copyright (c) 2026 Prism Launcher Contributors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <QList>
+#include <QMap>
+#include <QString>
+
+#include <utility>
+#include <vector>
+
+/**
+ * Replaces a fixed set of strings (tokens, profile IDs, ...) in log lines, all of them in a single pass over the line.
+ * The patterns are compiled once into an Aho-Corasick automaton. A match is replaced as soon as it ends; when several end at the
+ * same place, the longest one wins.
+ */
+class CensorFilter {
+   public:
+    CensorFilter() = default;
+    /** @param replacements maps each string to censor to what it is replaced with. Empty strings are ignored. */
+    explicit CensorFilter(const QMap<QString, QString>& replacements);
+
+    bool isEmpty() const { return m_replacements.isEmpty(); }
+
+    /** Returns the censored line, or the line itself (without copying it) when there was nothing to censor. */
+    QString apply(const QString& in) const;
+
+   private:
+    struct Node {
+        std::vector<std::pair<char16_t, int>> next;  // sorted by character
+        int fail = 0;
+        int replacement = -1;  // longest pattern ending here, including the ones reached through fail links
+        int matchLength = 0;
+        int depth = 0;
+    };
+
+    int child(int node, char16_t c) const;
+
+    std::vector<Node> m_nodes;
+    QList<QString> m_replacements;
+};
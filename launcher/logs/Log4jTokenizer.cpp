@@ -0,0 +1,323 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  Prism Launcher - Minecraft Launcher
+ *  Copyright (c) 2026 Prism Launcher Contributors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "Log4jTokenizer.h"
+
+#include <QDateTime>
+#include <QLatin1String>
+
+#include <algorithm>
+
+namespace {
+// tags are matched case insensitively, like LogParser does
+const QByteArrayView s_eventStart = "<log4j:Event";
+const QByteArrayView s_eventEnd = "</log4j:Event";
+const QByteArrayView s_messageStart = "<log4j:Message";
+const QByteArrayView s_messageEnd = "</log4j:Message";
+const QByteArrayView s_cdataStart = "<![CDATA[";
+const QByteArrayView s_cdataEnd = "]]>";
+// an event that hasn't ended by now is not going to
+constexpr qsizetype s_maxEventSize = 4 * 1024 * 1024;
+
+QLatin1String latin1(QByteArrayView data)
+{
+    return QLatin1String(data.data(), data.size());
+}
+
+qsizetype indexOf(QByteArrayView data, QByteArrayView pattern, qsizetype from)
+{
+    return latin1(data).indexOf(latin1(pattern), from, Qt::CaseInsensitive);
+}
+
+// 1 if the pattern is at pos, 0 if it isn't, -1 if the data ends before that is known
+int matchAt(QByteArrayView data, qsizetype pos, QByteArrayView pattern)
+{
+    const auto available = std::min(data.size() - pos, pattern.size());
+    if (latin1(data.sliced(pos, available)).compare(latin1(pattern.first(available)), Qt::CaseInsensitive) != 0)
+        return 0;
+    return available == pattern.size() ? 1 : -1;
+}
+
+bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+// text and attribute values, with the entities XML uses replaced
+QString decodeText(QByteArrayView data)
+{
+    auto text = QString::fromUtf8(data);
+    if (!text.contains(u'&'))
+        return text;
+
+    QString out;
+    out.reserve(text.size());
+    for (qsizetype i = 0; i < text.size(); i++) {
+        const auto end = text[i] == u'&' ? text.indexOf(u';', i) : -1;
+        if (end < 0) {
+            out += text[i];
+            continue;
+        }
+        const auto name = QStringView(text).sliced(i + 1, end - i - 1);
+        if (name == u"lt") {
+            out += u'<';
+        } else if (name == u"gt") {
+            out += u'>';
+        } else if (name == u"amp") {
+            out += u'&';
+        } else if (name == u"quot") {
+            out += u'"';
+        } else if (name == u"apos") {
+            out += u'\'';
+        } else if (name.startsWith(u'#')) {
+            bool ok = false;
+            const char32_t code = name.startsWith(u"#x") ? name.sliced(2).toUInt(&ok, 16) : name.sliced(1).toUInt(&ok);
+            if (ok)
+                out += QString::fromUcs4(&code, 1);
+            else
+                out += QStringView(text).sliced(i, end - i + 1);
+        } else {
+            out += QStringView(text).sliced(i, end - i + 1);
+        }
+        i = end;
+    }
+    return out;
+}
+}  // namespace
+
+QList<Log4jTokenizer::Item> Log4jTokenizer::feed(QByteArrayView data)
+{
+    QList<Item> items;
+    m_buffer.append(data);
+
+    // everything before this is done with
+    qsizetype consumed = 0;
+    while (true) {
+        if (m_eventStart >= 0) {
+            const auto scan = scanEvent();
+            if (scan == Scan::NeedMore && m_pos - m_eventStart <= s_maxEventSize)
+                break;
+
+            QString error = QStringLiteral("log4j:Event is too long");
+            if (scan == Scan::NeedMore)
+                m_eventEnd = m_pos;
+            const auto event = QByteArrayView(m_buffer).sliced(m_eventStart, m_eventEnd - m_eventStart);
+            if (auto entry = scan == Scan::Found ? parseEvent(event, error) : std::nullopt) {
+                items.append(std::move(*entry));
+            } else {
+                // show it as it is, nothing gets lost
+                items.append(LogParser::Error{ error, QXmlStreamReader::CustomError });
+                items.append(LogParser::PlainText{ QString::fromUtf8(event) });
+            }
+            consumed = m_pos = m_eventEnd;
+            m_eventStart = -1;
+            m_afterEvent = true;
+            continue;
+        }
+
+        const auto newline = m_buffer.indexOf('\n', m_pos);
+        if (newline < 0) {
+            m_pos = m_buffer.size();
+            break;
+        }
+        auto line = QByteArrayView(m_buffer).sliced(consumed, newline - consumed);
+        if (const auto start = indexOf(line, s_eventStart, 0); start >= 0) {
+            if (auto before = line.first(start); !before.trimmed().isEmpty())
+                items.append(LogParser::PlainText{ QString::fromUtf8(before) });
+            m_eventStart = consumed + start;
+            m_pos = m_eventStart + s_eventStart.size();
+            m_inCdata = false;
+            m_afterEvent = false;
+            consumed = m_eventStart;
+            continue;
+        }
+
+        if (line.endsWith('\r'))
+            line.chop(1);
+        if (!m_afterEvent || !line.trimmed().isEmpty())
+            items.append(LogParser::PlainText{ QString::fromUtf8(line) });
+        m_afterEvent = false;
+        consumed = m_pos = newline + 1;
+    }
+
+    if (consumed > 0) {
+        m_buffer.remove(0, consumed);
+        m_pos -= consumed;
+        if (m_eventStart >= 0)
+            m_eventStart -= consumed;
+    }
+    return items;
+}
+
+Log4jTokenizer::Scan Log4jTokenizer::scanEvent()
+{
+    const QByteArrayView data(m_buffer);
+    while (m_pos < data.size()) {
+        if (m_inCdata) {
+            const auto end = data.indexOf(s_cdataEnd, m_pos);
+            if (end < 0) {
+                // the end could be split between two chunks
+                m_pos = std::max(m_pos, data.size() - s_cdataEnd.size() + 1);
+                return Scan::NeedMore;
+            }
+            m_pos = end + s_cdataEnd.size();
+            m_inCdata = false;
+            continue;
+        }
+
+        const auto tag = data.indexOf('<', m_pos);
+        if (tag < 0) {
+            m_pos = data.size();
+            return Scan::NeedMore;
+        }
+        m_pos = tag;
+        const auto cdata = matchAt(data, tag, s_cdataStart);
+        const auto end = matchAt(data, tag, s_eventEnd);
+        if (cdata == 1) {
+            m_inCdata = true;
+            m_pos = tag + s_cdataStart.size();
+        } else if (end == 1) {
+            const auto close = data.indexOf('>', tag);
+            if (close < 0)
+                return Scan::NeedMore;
+            m_pos = m_eventEnd = close + 1;
+            return Scan::Found;
+        } else if (cdata < 0 || end < 0) {
+            return Scan::NeedMore;
+        } else {
+            m_pos = tag + 1;
+        }
+    }
+    return Scan::NeedMore;
+}
+
+std::optional<LogParser::LogEntry> Log4jTokenizer::parseEvent(QByteArrayView event, QString& error)
+{
+    LogParser::LogEntry entry{
+        "",
+        MessageLevel::Info,
+    };
+
+    // attributes of the start tag
+    auto pos = s_eventStart.size();
+    while (true) {
+        while (pos < event.size() && isSpace(event[pos]))
+            pos++;
+        if (pos >= event.size() || event[pos] == '>' || event[pos] == '/')
+            break;
+        const auto nameStart = pos;
+        while (pos < event.size() && event[pos] != '=' && event[pos] != '>' && !isSpace(event[pos]))
+            pos++;
+        const auto name = event.sliced(nameStart, pos - nameStart);
+        while (pos < event.size() && isSpace(event[pos]))
+            pos++;
+        if (pos < event.size() && event[pos] == '=')
+            pos++;
+        while (pos < event.size() && isSpace(event[pos]))
+            pos++;
+        const auto valueEnd = pos < event.size() && (event[pos] == '"' || event[pos] == '\'') ? event.indexOf(event[pos], pos + 1) : -1;
+        if (valueEnd < 0) {
+            error = QStringLiteral("log4j:Event Malformed attribute: %1").arg(QString::fromUtf8(name));
+            return {};
+        }
+        const auto value = event.sliced(pos + 1, valueEnd - pos - 1).trimmed();
+        pos = valueEnd + 1;
+
+        if (name == "logger") {
+            entry.logger = decodeText(value);
+        } else if (name == "timestamp") {
+            if (value.isEmpty()) {
+                error = QStringLiteral("log4j:Event Missing required attribute: timestamp");
+                return {};
+            }
+            // log4j writes milliseconds
+            entry.timestamp = QDateTime::fromMSecsSinceEpoch(value.toLongLong());
+        } else if (name == "level") {
+            entry.levelText = decodeText(value);
+            entry.level = MessageLevel::fromName(entry.levelText);
+        } else if (name == "thread") {
+            entry.thread = decodeText(value);
+        }
+    }
+    if (entry.logger.isEmpty()) {
+        error = QStringLiteral("log4j:Event Missing required attribute: logger");
+        return {};
+    }
+
+    const auto messageStart = indexOf(event, s_messageStart, pos);
+    const auto contentStart = messageStart < 0 ? -1 : event.indexOf('>', messageStart);
+    if (contentStart < 0) {
+        error = QStringLiteral("log4j:Event Missing required attribute: message");
+        return {};
+    }
+    QString message;
+    for (auto i = contentStart + 1; i < event.size();) {
+        if (event[i] != '<') {
+            auto next = event.indexOf('<', i);
+            if (next < 0)
+                next = event.size();
+            message += decodeText(event.sliced(i, next - i));
+            i = next;
+        } else if (matchAt(event, i, s_cdataStart) == 1) {
+            const auto begin = i + s_cdataStart.size();
+            const auto end = event.indexOf(s_cdataEnd, begin);
+            if (end < 0)
+                break;
+            message += QString::fromUtf8(event.sliced(begin, end - begin));
+            i = end + s_cdataEnd.size();
+        } else if (matchAt(event, i, s_messageEnd) == 1) {
+            entry.message = std::move(message);
+            return entry;
+        } else {
+            // some other element, only its text counts
+            const auto close = event.indexOf('>', i);
+            if (close < 0)
+                break;
+            i = close + 1;
+        }
+    }
+    error = QStringLiteral("log4j:Message is not closed");
+    return {};
+}
+
+QString Log4jTokenizer::format(const LogParser::LogEntry& entry)
+{
+    QString out;
+    out.reserve(entry.thread.size() + entry.levelText.size() + entry.logger.size() + entry.message.size() + 20);
+    out += u'[';
+    if (entry.timestamp.isValid()) {
+        const auto time = entry.timestamp.time();
+        auto twoDigits = [&out](int value) {
+            out += QChar(u'0' + value / 10);
+            out += QChar(u'0' + value % 10);
+        };
+        twoDigits(time.hour());
+        out += u':';
+        twoDigits(time.minute());
+        out += u':';
+        twoDigits(time.second());
+    }
+    out += u"] [";
+    out += entry.thread;
+    out += u'/';
+    out += entry.levelText;
+    out += u"] [";
+    out += entry.logger;
+    out += u"]: ";
+    out += entry.message;
+    return out;
+}
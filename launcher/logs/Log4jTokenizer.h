@@ -0,0 +1,55 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  Prism Launcher - Minecraft Launcher
+ *  Copyright (c) 2026 Prism Launcher Contributors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QList>
+#include <optional>
+#include <variant>
+
+#include "logs/LogParser.h"
+
+/**
+ * Splits raw UTF-8 game output into log4j XML events and plain text lines, as it arrives.
+ * Unlike LogParser, which restarts an XML reader over everything it has buffered for every line, this only looks at each byte
+ * once: it keeps track of where it stopped, and only decodes the parts of an event that end up in the entry.
+ */
+class Log4jTokenizer {
+   public:
+    using Item = std::variant<LogParser::LogEntry, LogParser::PlainText, LogParser::Error>;
+
+    /** Takes the next chunk of output, and returns the items it completed. Incomplete lines and events wait for the next chunk. */
+    QList<Item> feed(QByteArrayView data);
+
+    /** Formats an entry like the game would print it to the console: `[HH:mm:ss] [thread/LEVEL] [logger]: message` */
+    static QString format(const LogParser::LogEntry& entry);
+
+   private:
+    enum class Scan { Found, NeedMore };
+
+    Scan scanEvent();
+    static std::optional<LogParser::LogEntry> parseEvent(QByteArrayView event, QString& error);
+
+    QByteArray m_buffer;
+    qsizetype m_pos = 0;          // where scanning continues with the next chunk
+    qsizetype m_eventStart = -1;  // start of the event being read, -1 in between events
+    qsizetype m_eventEnd = 0;
+    bool m_inCdata = false;
+    bool m_afterEvent = false;  // the rest of the line an event ended on is dropped if there is nothing else on it
+};
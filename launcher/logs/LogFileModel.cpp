@@ -0,0 +1,244 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  Prism Launcher - Minecraft Launcher
+ *  Copyright (c) 2026 Prism Launcher Contributors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "LogFileModel.h"
+
+#include <QTemporaryFile>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <utility>
+
+#include "GZip.h"
+#include "launch/LogModel.h"
+#include "logs/LogParser.h"
+
+namespace {
+// continuation lines (stack traces) take the level of the line before, but only this far back
+constexpr int s_levelLookBehind = 256;
+}  // namespace
+
+LogFileModel::LogFileModel(QObject* parent) : QAbstractListModel(parent), m_guessLevel(&LogParser::guessLevel)
+{
+    connect(&m_loading, &QFutureWatcher<void>::finished, this, [this] {
+        // nothing pending means the load was cleared in the meantime
+        if (!m_pending)
+            return;
+        auto mapping = std::exchange(m_pending, nullptr);
+        if (!mapping->error.isEmpty()) {
+            emit failed(mapping->error);
+            return;
+        }
+        beginResetModel();
+        m_mapping = mapping;
+        m_levels.assign(m_mapping->lines.size(), -1);
+        endResetModel();
+        emit loaded();
+    });
+}
+
+LogFileModel::~LogFileModel()
+{
+    if (m_pending)
+        m_pending->canceled = true;
+}
+
+int LogFileModel::rowCount(const QModelIndex& parent) const
+{
+    if (parent.isValid() || !m_mapping)
+        return 0;
+    return static_cast<int>(std::min<size_t>(m_mapping->lines.size(), INT_MAX));
+}
+
+QVariant LogFileModel::data(const QModelIndex& index, int role) const
+{
+    if (index.row() < 0 || index.row() >= rowCount())
+        return QVariant();
+
+    if (role == Qt::DisplayRole || role == Qt::EditRole) {
+        return line(index.row());
+    }
+    if (role == LogModel::LevelRole) {
+        return static_cast<int>(level(index.row()));
+    }
+
+    return QVariant();
+}
+
+void LogFileModel::load(const QString& path)
+{
+    clear();
+    m_pending = std::make_shared<Mapping>();
+    // created here, so they belong to this thread
+    if (path.endsWith(".gz"))
+        m_pending->file = std::make_unique<QTemporaryFile>();
+    else
+        m_pending->file = std::make_unique<QFile>(path);
+    m_loading.setFuture(QtConcurrent::run([mapping = m_pending, path] { mapFile(*mapping, path); }));
+}
+
+void LogFileModel::clear()
+{
+    // the worker holds on to its own mapping, it only needs to know that nobody wants it anymore
+    if (m_pending) {
+        m_pending->canceled = true;
+        m_pending.reset();
+    }
+    beginResetModel();
+    m_mapping.reset();
+    m_levels.clear();
+    endResetModel();
+}
+
+void LogFileModel::mapFile(Mapping& mapping, const QString& path)
+{
+    if (auto cache = dynamic_cast<QTemporaryFile*>(mapping.file.get())) {
+        QFile source(path);
+        if (!source.open(QIODevice::ReadOnly) || !cache->open()) {
+            mapping.error = tr("Unable to open %1 for reading: %2").arg(path, source.errorString());
+            return;
+        }
+        bool written = true;
+        auto error = GZip::readGzFileByBlocks(&source, [cache, &mapping, &written](const QByteArray& block) {
+            written = cache->write(block) == block.size();
+            return written && !mapping.canceled;
+        });
+        if (mapping.canceled)
+            return;
+        if (!written)
+            error = cache->errorString();
+        if (!error.isEmpty() || !cache->flush()) {
+            mapping.error = tr("The file (%1) encountered an error when reading: %2.").arg(path, error);
+            return;
+        }
+    } else if (!mapping.file->open(QIODevice::ReadOnly)) {
+        mapping.error = tr("Unable to open %1 for reading: %2").arg(path, mapping.file->errorString());
+        return;
+    }
+
+    mapping.size = mapping.file->size();
+    if (mapping.size == 0)
+        return;
+    mapping.data = reinterpret_cast<const char*>(mapping.file->map(0, mapping.size));
+    if (!mapping.data) {
+        mapping.error = tr("Unable to map %1: %2").arg(path, mapping.file->errorString());
+        return;
+    }
+
+    // a rough guess of the line count, so the index isn't reallocated too often
+    mapping.lines.reserve(mapping.size / 100);
+    mapping.lines.push_back(0);
+    const auto end = mapping.data + mapping.size;
+    for (auto pos = mapping.data; pos < end && !mapping.canceled;) {
+        auto newline = static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+        if (!newline || newline + 1 == end)
+            break;
+        pos = newline + 1;
+        mapping.lines.push_back(pos - mapping.data);
+    }
+}
+
+QByteArrayView LogFileModel::Mapping::lineData(int row) const
+{
+    const auto start = lines[row];
+    const auto end = static_cast<size_t>(row) + 1 < lines.size() ? lines[row + 1] : size;
+    QByteArrayView line(data + start, end - start);
+    while (line.endsWith('\n') || line.endsWith('\r'))
+        line.chop(1);
+    return line;
+}
+
+QString LogFileModel::line(int row) const
+{
+    return QString::fromUtf8(m_mapping->lineData(row));
+}
+
+MessageLevel LogFileModel::level(int row) const
+{
+    if (m_levels[row] >= 0)
+        return static_cast<MessageLevel::Enum>(m_levels[row]);
+
+    // guess forward from the closest line that already has a level
+    auto first = row;
+    while (first > 0 && row - first < s_levelLookBehind && m_levels[first - 1] < 0)
+        first--;
+    MessageLevel previous = MessageLevel::Unknown;
+    if (first > 0 && m_levels[first - 1] >= 0)
+        previous = static_cast<MessageLevel::Enum>(m_levels[first - 1]);
+    for (auto i = first; i <= row; i++) {
+        previous = m_guessLevel(line(i), previous);
+        m_levels[i] = static_cast<qint8>(static_cast<int>(previous));
+    }
+    return previous;
+}
+
+QString LogFileModel::text(qint64 maxBytes) const
+{
+    if (!m_mapping)
+        return {};
+    qint64 start = 0;
+    if (maxBytes >= 0 && m_mapping->size > maxBytes) {
+        // start at a line, so no line (or character) gets cut in half
+        const auto& lines = m_mapping->lines;
+        auto it = std::lower_bound(lines.cbegin(), lines.cend(), m_mapping->size - maxBytes);
+        start = it == lines.cend() ? m_mapping->size : *it;
+    }
+    return QString::fromUtf8(m_mapping->data + start, m_mapping->size - start);
+}
+
+QFuture<int> LogFileModel::find(const QString& what, int from, bool reverse) const
+{
+    // the worker keeps the mapping alive, even if another file gets loaded in the meantime
+    return QtConcurrent::run([mapping = m_mapping, what, from, reverse] { return mapping ? findIn(*mapping, what, from, reverse) : -1; });
+}
+
+int LogFileModel::findIn(const Mapping& mapping, const QString& what, int from, bool reverse)
+{
+    if (what.isEmpty() || mapping.lines.empty())
+        return -1;
+
+    // ASCII is matched case insensitively right in the mapped bytes, anything else has to match exactly
+    const auto needle = what.toUtf8();
+    const bool ascii = needle.size() == what.size();
+    const QLatin1String haystack(mapping.data, mapping.size);
+    auto search = [&](qint64 pos) -> qint64 {
+        if (ascii) {
+            return reverse ? haystack.lastIndexOf(QLatin1String(needle), pos, Qt::CaseInsensitive)
+                           : haystack.indexOf(QLatin1String(needle), pos, Qt::CaseInsensitive);
+        }
+        const QByteArrayView bytes(mapping.data, mapping.size);
+        return reverse ? bytes.lastIndexOf(needle, pos) : bytes.indexOf(needle, pos);
+    };
+
+    qint64 start;
+    if (reverse) {
+        // anything starting before the current line
+        start = from > 0 && static_cast<size_t>(from) < mapping.lines.size() ? mapping.lines[from] - 1 : -1;
+    } else {
+        start = from >= 0 && static_cast<size_t>(from) + 1 < mapping.lines.size() ? mapping.lines[from + 1] : 0;
+    }
+    auto found = search(start);
+    if (found < 0 && start != (reverse ? -1 : 0))
+        found = search(reverse ? -1 : 0);
+    if (found < 0)
+        return -1;
+
+    auto line = std::upper_bound(mapping.lines.begin(), mapping.lines.end(), found) - mapping.lines.begin() - 1;
+    return static_cast<int>(std::min<qint64>(line, INT_MAX));
+}
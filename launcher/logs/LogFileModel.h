@@ -0,0 +1,93 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  Prism Launcher - Minecraft Launcher
+ *  Copyright (c) 2026 Prism Launcher Contributors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <QAbstractListModel>
+#include <QFile>
+#include <QFuture>
+#include <QFutureWatcher>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "MessageLevel.h"
+
+/**
+ * A read-only model over a log file of any size.
+ * The file is memory mapped (gzip files are unpacked into a temporary file first) and only the start of each line is kept in
+ * memory. Lines are decoded when they are asked for, and levels are guessed for the rows that actually get displayed.
+ */
+class LogFileModel : public QAbstractListModel {
+    Q_OBJECT
+   public:
+    /** Guesses the level of a line, given the level of the line before it. */
+    using LevelGuesser = std::function<MessageLevel(const QString& line, MessageLevel previous)>;
+
+    explicit LogFileModel(QObject* parent = nullptr);
+    ~LogFileModel() override;
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role) const override;
+
+    /** Maps and indexes the file on a worker thread, emits loaded() or failed() when done. */
+    void load(const QString& path);
+    /** Unmaps the current file. */
+    void clear();
+    bool isLoading() const { return m_pending != nullptr; }
+
+    void setLevelGuesser(LevelGuesser guesser) { m_guessLevel = std::move(guesser); }
+
+    QString line(int row) const;
+    MessageLevel level(int row) const;
+    /** The whole file, decoded. With a limit, only the last lines that fit into that many bytes. */
+    QString text(qint64 maxBytes = -1) const;
+    qint64 size() const { return m_mapping ? m_mapping->size : 0; }
+
+    /**
+     * Case insensitive search for the next line containing the text, after (or before, in reverse) the given row.
+     * Wraps around at the ends of the file. The result is the row, -1 if nothing matched.
+     */
+    QFuture<int> find(const QString& what, int from, bool reverse) const;
+
+   signals:
+    void loaded();
+    void failed(QString reason);
+
+   private:
+    struct Mapping {
+        std::unique_ptr<QFile> file;
+        const char* data = nullptr;
+        qint64 size = 0;
+        std::vector<qint64> lines;  // offset of the start of each line
+        QString error;
+        std::atomic_bool canceled = false;
+
+        QByteArrayView lineData(int row) const;
+    };
+
+    static void mapFile(Mapping& mapping, const QString& path);
+    static int findIn(const Mapping& mapping, const QString& what, int from, bool reverse);
+
+    std::shared_ptr<Mapping> m_mapping;
+    std::shared_ptr<Mapping> m_pending;
+    QFutureWatcher<void> m_loading;
+    mutable std::vector<qint8> m_levels;  // -1 until the line is displayed
+    LevelGuesser m_guessLevel;
+};
@@ -57,7 +57,7 @@ std::optional<LogParser::LogEntry> LogParser::parseAttributes()
                 m_parser.raiseError("log4j:Event Missing required attribute: timestamp");
                 return {};
             }
-            entry.timestamp = QDateTime::fromSecsSinceEpoch(value.trimmed().toLongLong());
+            entry.timestamp = QDateTime::fromMSecsSinceEpoch(value.trimmed().toLongLong());
         } else if (name == "level"_L1) {
             entry.levelText = value.trimmed().toString();
             entry.level = MessageLevel::fromName(entry.levelText);
@@ -34,18 +34,25 @@
  */
 
 #include <QCryptographicHash>
+#include <QDataStream>
 #include <QDebug>
 #include <QDir>
-#include <QDirIterator>
 #include <QFileInfo>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonParseError>
-#include <QVariant>
+#include <QMutex>
+#include <QSet>
+#include <QtConcurrent>
+
+#include <filesystem>
+#include <optional>
 
 #include "AssetsUtils.h"
 #include "BuildConfig.h"
 #include "FileSystem.h"
+#include "StringUtils.h"
+#include "modplatform/helpers/HashCache.h"
 #include "net/ApiDownload.h"
 #include "net/ChecksumValidator.h"
 #include "net/Download.h"
@@ -54,36 +61,122 @@
 #include "net/NetRequest.h"
 
 namespace {
-QSet<QString> collectPathsFromDir(QString dirPath)
+constexpr quint32 s_manifestMagic = 0x50524d46;  // "PRMF"
+constexpr quint32 s_manifestVersion = 2;
+
+// What a reconstructed folder was last built from, and the assets that couldn't be placed in it yet
+struct ReconstructManifest {
+    QByteArray indexSha1;
+    QStringList pending;
+    // when each folder assets go into was last changed, relative to the target. removing a file changes its folder's time,
+    // so only the assets in folders that changed since need to be looked for again
+    QHash<QString, qint64> folderTimes;
+};
+
+QString manifestPath(const QString& targetPath)
 {
-    QFileInfo dirInfo(dirPath);
+    auto key = QCryptographicHash::hash(QFileInfo(targetPath).absoluteFilePath().toUtf8(), QCryptographicHash::Sha1).toHex();
+    return FS::PathCombine("assets", "manifests", QString::fromLatin1(key) + ".dat");
+}
+
+std::optional<ReconstructManifest> readManifest(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QFile::ReadOnly))
+        return {};
 
-    if (!dirInfo.exists()) {
+    QDataStream in(&file);
+    quint32 magic, version;
+    ReconstructManifest manifest;
+    in >> magic >> version;
+    if (magic != s_manifestMagic || version != s_manifestVersion)
+        return {};
+    in >> manifest.indexSha1 >> manifest.pending >> manifest.folderTimes;
+    if (in.status() != QDataStream::Ok)
         return {};
+    return manifest;
+}
+
+void writeManifest(const QString& path, const ReconstructManifest& manifest)
+{
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out << s_manifestMagic << s_manifestVersion << manifest.indexSha1 << manifest.pending << manifest.folderTimes;
+
+    try {
+        FS::write(path, data);
+    } catch (const FS::FileSystemException& e) {
+        qWarning() << "Failed to save the assets manifest:" << e.cause();
     }
+}
 
-    QSet<QString> out;
+QString folderOf(const QString& assetPath)
+{
+    return QFileInfo(assetPath).path();
+}
 
-    QDirIterator iter(dirPath, QDirIterator::Subdirectories);
-    while (iter.hasNext()) {
-        QString value = iter.next();
-        QFileInfo info(value);
-        if (info.isFile()) {
-            out.insert(value);
-            qDebug() << value;
-        }
+// only compared for equality, so the file system's own (finer than milliseconds) resolution is used as it is
+QHash<QString, qint64> folderTimes(const QString& targetPath, const QSet<QString>& folders)
+{
+    QHash<QString, qint64> times;
+    times.reserve(folders.size());
+    for (const auto& folder : folders) {
+        std::error_code err;
+        auto time = std::filesystem::last_write_time(StringUtils::toStdString(FS::PathCombine(targetPath, folder)), err);
+        times.insert(folder, err ? -1 : static_cast<qint64>(time.time_since_epoch().count()));
+    }
+    return times;
+}
+
+struct Placement {
+    QString source;
+    QString target;
+};
+
+enum class PlacementMethod { Clone, HardLink, Copy };
+
+const char* placementMethodName(PlacementMethod method)
+{
+    switch (method) {
+        case PlacementMethod::Clone:
+            return "cloning";
+        case PlacementMethod::HardLink:
+            return "hard linking";
+        case PlacementMethod::Copy:
+        default:
+            return "copying";
+    }
+}
+
+bool place(const Placement& placement, PlacementMethod method)
+{
+    std::error_code err;
+    if (method == PlacementMethod::Clone && FS::reflink_file(placement.source, placement.target, err))
+        return true;
+    if (method == PlacementMethod::HardLink) {
+        std::filesystem::create_hard_link(StringUtils::toStdString(placement.source), StringUtils::toStdString(placement.target), err);
+        if (!err)
+            return true;
     }
-    return out;
+    return QFile::copy(placement.source, placement.target);
 }
+
+struct LoadedAssetsIndex {
+    Hashing::FileIdentity file;
+    AssetsIndex::Ptr index;
+};
+
+struct AssetsIndexCache {
+    QMutex mutex;
+    QHash<QString, LoadedAssetsIndex> indexes;
+};
+
+Q_GLOBAL_STATIC(AssetsIndexCache, s_indexCache)
 }  // namespace
 
 namespace AssetsUtils {
 
-/*
- * Returns true on success, with index populated
- * index is undefined otherwise
- */
-bool loadAssetsIndexJson(const QString& assetsId, const QString& path, AssetsIndex& index)
+AssetsIndex::Ptr parseAssetsIndex(const QString& assetsId, const QByteArray& data)
 {
     /*
     {
@@ -98,75 +191,83 @@ bool loadAssetsIndexJson(const QString& assetsId, const QString& path, AssetsInd
     }
     */
 
-    QFile file(path);
-
-    // Try to open the file and fail if we can't.
-    // TODO: We should probably report this error to the user.
-    if (!file.open(QIODevice::ReadOnly)) {
-        qCritical() << "Failed to read assets index file" << path;
-        return false;
-    }
-    index.id = assetsId;
-
-    // Read the file and close it.
-    QByteArray jsonData = file.readAll();
-    file.close();
-
     QJsonParseError parseError;
-    QJsonDocument jsonDoc = QJsonDocument::fromJson(jsonData, &parseError);
+    QJsonDocument jsonDoc = QJsonDocument::fromJson(data, &parseError);
 
     // Fail if the JSON is invalid.
     if (parseError.error != QJsonParseError::NoError) {
         qCritical() << "Failed to parse assets index file:" << parseError.errorString() << "at offset "
                     << QString::number(parseError.offset);
-        return false;
+        return nullptr;
     }
 
     // Make sure the root is an object.
     if (!jsonDoc.isObject()) {
-        qCritical() << "Invalid assets index JSON: Root should be an array.";
-        return false;
+        qCritical() << "Invalid assets index JSON: Root should be an object.";
+        return nullptr;
     }
 
     QJsonObject root = jsonDoc.object();
 
-    QJsonValue isVirtual = root.value("virtual");
-    if (!isVirtual.isUndefined()) {
-        index.isVirtual = isVirtual.toBool(false);
-    }
+    auto index = std::make_shared<AssetsIndex>();
+    index->id = assetsId;
+    index->sha1 = QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+    index->isVirtual = root.value("virtual").toBool(false);
+    index->mapToResources = root.value("map_to_resources").toBool(false);
 
-    QJsonValue mapToResources = root.value("map_to_resources");
-    if (!mapToResources.isUndefined()) {
-        index.mapToResources = mapToResources.toBool(false);
-    }
+    const QJsonObject objects = root.value("objects").toObject();
+    index->objects.reserve(objects.size());
+    index->objectsByPath.reserve(objects.size());
 
-    QJsonValue objects = root.value("objects");
-    QVariantMap map = objects.toVariant().toMap();
+    for (auto iter = objects.constBegin(); iter != objects.constEnd(); ++iter) {
+        const QJsonObject object = iter.value().toObject();
 
-    for (QVariantMap::const_iterator iter = map.begin(); iter != map.end(); ++iter) {
-        // qDebug() << iter.key();
+        const auto sha1 = QByteArray::fromHex(object.value("hash").toString().toLatin1());
+        if (sha1.size() != static_cast<qsizetype>(std::tuple_size_v<decltype(AssetObject::sha1)>)) {
+            qWarning() << "Ignoring asset" << iter.key() << "with an invalid hash";
+            continue;
+        }
 
-        QVariant variant = iter.value();
-        QVariantMap nested_objects = variant.toMap();
+        AssetObject asset;
+        asset.path = iter.key();
+        std::copy(sha1.cbegin(), sha1.cend(), asset.sha1.begin());
+        asset.size = object.value("size").toInteger();
 
-        AssetObject object;
+        index->objectsByPath.insert(asset.path, index->objects.size());
+        index->objects.append(std::move(asset));
+    }
 
-        for (QVariantMap::const_iterator nested_iter = nested_objects.begin(); nested_iter != nested_objects.end(); ++nested_iter) {
-            // qDebug() << nested_iter.key() << nested_iter.value().toString();
-            QString key = nested_iter.key();
-            QVariant value = nested_iter.value();
+    return index;
+}
 
-            if (key == "hash") {
-                object.hash = value.toString();
-            } else if (key == "size") {
-                object.size = value.toLongLong();
-            }
-        }
+AssetsIndex::Ptr loadAssetsIndex(const QString& assetsId, const QString& path)
+{
+    auto identity = Hashing::FileIdentity::of(path);
+    if (!identity.isValid()) {
+        qCritical() << "Failed to read assets index file" << path;
+        return nullptr;
+    }
 
-        index.objects.insert(iter.key(), object);
+    {
+        QMutexLocker lock(&s_indexCache->mutex);
+        auto loaded = s_indexCache->indexes.constFind(assetsId);
+        if (loaded != s_indexCache->indexes.constEnd() && loaded->file == identity)
+            return loaded->index;
     }
 
-    return true;
+    // TODO: We should probably report this error to the user.
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCritical() << "Failed to read assets index file" << path;
+        return nullptr;
+    }
+
+    auto index = parseAssetsIndex(assetsId, file.readAll());
+    if (index) {
+        QMutexLocker lock(&s_indexCache->mutex);
+        s_indexCache->indexes.insert(assetsId, { identity, index });
+    }
+    return index;
 }
 
 // FIXME: ugly code duplication
@@ -186,22 +287,20 @@ QDir getAssetsDir(const QString& assetsId, const QString& resourcesFolder)
         return virtualRoot;
     }
 
-    AssetsIndex index;
-    if (!AssetsUtils::loadAssetsIndexJson(assetsId, indexPath, index)) {
+    auto index = AssetsUtils::loadAssetsIndex(assetsId, indexPath);
+    if (!index) {
         qCritical() << "Failed to load asset index file" << indexPath << "; can't determine assets path!";
         return virtualRoot;
     }
 
-    QString targetPath;
-    if (index.isVirtual) {
+    if (index->isVirtual) {
         return virtualRoot;
-    } else if (index.mapToResources) {
+    } else if (index->mapToResources) {
         return QDir(resourcesFolder);
     }
     return virtualRoot;
 }
 
-// FIXME: ugly code duplication
 bool reconstructAssets(QString assetsId, QString resourcesFolder)
 {
     QDir assetsDir = QDir("assets/");
@@ -218,99 +317,153 @@ bool reconstructAssets(QString assetsId, QString resourcesFolder)
         return false;
     }
 
-    qDebug() << "reconstructAssets" << assetsDir.path() << indexDir.path() << objectDir.path() << virtualDir.path() << virtualRoot.path();
-
-    AssetsIndex index;
-    if (!AssetsUtils::loadAssetsIndexJson(assetsId, indexPath, index)) {
+    auto index = AssetsUtils::loadAssetsIndex(assetsId, indexPath);
+    if (!index) {
         qCritical() << "Failed to load asset index file" << indexPath << "; can't reconstruct assets!";
         return false;
     }
 
     QString targetPath;
-    bool removeLeftovers = false;
-    if (index.isVirtual) {
+    if (index->isVirtual) {
         targetPath = virtualRoot.path();
-        removeLeftovers = true;
-        qDebug() << "Reconstructing virtual assets folder at" << targetPath;
-    } else if (index.mapToResources) {
+    } else if (index->mapToResources) {
         targetPath = resourcesFolder;
-        qDebug() << "Reconstructing resources folder at" << targetPath;
+    } else {
+        return true;
     }
 
-    if (!targetPath.isNull()) {
-        auto presentFiles = collectPathsFromDir(targetPath);
-        for (QString map : index.objects.keys()) {
-            AssetObject asset_object = index.objects.value(map);
-            QString target_path = FS::PathCombine(targetPath, map);
-            QFile target(target_path);
+    const auto manifestFile = manifestPath(targetPath);
+    auto manifest = readManifest(manifestFile);
 
-            QString tlk = asset_object.hash.left(2);
-
-            QString original_path = FS::PathCombine(objectDir.path(), tlk, asset_object.hash);
-            QFile original(original_path);
-            if (!original.exists())
-                continue;
+    QStringList candidates;
+    QSet<QString> folders;
+    candidates.reserve(index->objects.size());
+    for (const auto& asset_object : index->objects) {
+        candidates.append(asset_object.path);
+        folders.insert(folderOf(asset_object.path));
+    }
 
-            presentFiles.remove(target_path);
+    if (manifest && manifest->indexSha1 == index->sha1 && QFileInfo(targetPath).isDir()) {
+        // the index didn't change, but assets may have been deleted since. only look in the folders that changed,
+        // and for the assets that couldn't be placed before
+        const auto times = folderTimes(targetPath, folders);
+        const auto pending = QSet<QString>(manifest->pending.cbegin(), manifest->pending.cend());
+        QStringList changed;
+        for (const auto& path : std::as_const(candidates)) {
+            const auto folder = folderOf(path);
+            if (pending.contains(path) || manifest->folderTimes.value(folder, -2) != times.value(folder))
+                changed.append(path);
+        }
+        candidates = QtConcurrent::blockingFiltered(changed, [&targetPath](const QString& path) {
+            return !QFileInfo::exists(FS::PathCombine(targetPath, path));
+        });
+        if (candidates.isEmpty()) {
+            qDebug() << "Assets at" << targetPath << "are up to date";
+            if (!manifest->pending.isEmpty() || manifest->folderTimes != times)
+                writeManifest(manifestFile, { index->sha1, {}, times });
+            return true;
+        }
+    }
 
-            if (!target.exists()) {
-                QFileInfo info(target_path);
-                QDir target_dir = info.dir();
+    ReconstructManifest result{ index->sha1, {}, {} };
+    QList<Placement> placements;
+    QSet<QString> targetDirs;
+    for (const auto& path : candidates) {
+        auto asset_object = index->find(path);
+        if (!asset_object)
+            continue;
+
+        Placement placement{ FS::PathCombine(objectDir.path(), asset_object->getRelPath()), FS::PathCombine(targetPath, path) };
+        if (!QFileInfo::exists(placement.source)) {
+            result.pending.append(path);
+            continue;
+        }
+        if (QFileInfo::exists(placement.target))
+            continue;
 
-                qDebug() << target_dir.path();
-                FS::ensureFolderPathExists(target_dir.path());
+        targetDirs.insert(QFileInfo(placement.target).path());
+        placements.append(placement);
+    }
 
-                bool couldCopy = original.copy(target_path);
-                qDebug() << " Copying" << original_path << "to" << target_path << QString::number(couldCopy);
-            }
+    if (!placements.isEmpty()) {
+        auto method = PlacementMethod::Copy;
+        if (FS::canClone(objectDir.absolutePath(), targetPath)) {
+            method = PlacementMethod::Clone;
+        } else if (index->isVirtual && FS::statFS(objectDir.absolutePath()).rootPath == FS::statFS(targetPath).rootPath) {
+            // the virtual folder is ours, but the resources folder belongs to the instance and may get edited in place,
+            // which must not reach through to the shared objects
+            method = PlacementMethod::HardLink;
         }
+        qDebug() << "Reconstructing" << placements.size() << "assets at" << targetPath << "by" << placementMethodName(method);
+
+        for (const auto& dir : std::as_const(targetDirs))
+            FS::ensureFolderPathExists(dir);
 
-        // TODO: Write last used time to virtualRoot/.lastused
-        if (removeLeftovers) {
-            for (auto& file : presentFiles) {
-                qDebug() << "Would remove" << file;
+        const auto placed = QtConcurrent::blockingMapped<QList<bool>>(placements, [method](const Placement& placement) { return place(placement, method); });
+        for (qsizetype i = 0; i < placements.size(); i++) {
+            if (!placed.at(i)) {
+                qWarning() << "Failed to place asset" << placements.at(i).source << "at" << placements.at(i).target;
+                result.pending.append(QDir(targetPath).relativeFilePath(placements.at(i).target));
             }
         }
     }
+
+    if (!result.pending.isEmpty())
+        qDebug() << result.pending.size() << "assets at" << targetPath << "are not available yet";
+    // after placing, which changed the folders
+    result.folderTimes = folderTimes(targetPath, folders);
+    writeManifest(manifestFile, result);
     return true;
 }
 
 }  // namespace AssetsUtils
 
-Net::NetRequest::Ptr AssetObject::getDownloadAction()
+Net::NetRequest::Ptr AssetObject::getDownloadAction() const
 {
     QFileInfo objectFile(getLocalPath());
     if ((!objectFile.isFile()) || (objectFile.size() != size)) {
         auto objectDL = Net::ApiDownload::makeFile(getUrl(), objectFile.filePath());
-        if (hash.size()) {
-            objectDL->addValidator(new Net::ChecksumValidator(QCryptographicHash::Sha1, hash));
-        }
+        auto expected = QByteArray(reinterpret_cast<const char*>(sha1.data()), sha1.size());
+        objectDL->addValidator(new Net::ChecksumValidator(QCryptographicHash::Sha1, expected));
         objectDL->setProgress(objectDL->getProgress(), size);
+        objectDL->setExpectedSize(size);
         return objectDL;
     }
     return nullptr;
 }
 
-QString AssetObject::getLocalPath()
+QString AssetObject::hash() const
+{
+    return QString::fromLatin1(QByteArray::fromRawData(reinterpret_cast<const char*>(sha1.data()), sha1.size()).toHex());
+}
+
+QString AssetObject::getLocalPath() const
 {
     return "assets/objects/" + getRelPath();
 }
 
-QUrl AssetObject::getUrl()
+QUrl AssetObject::getUrl() const
 {
     auto resourceURL = APPLICATION->settings()->get("ResourceURL").toString();
     return resourceURL + getRelPath();
 }
 
-QString AssetObject::getRelPath()
+QString AssetObject::getRelPath() const
+{
+    auto hex = hash();
+    return hex.left(2) + "/" + hex;
+}
+
+const AssetObject* AssetsIndex::find(const QString& path) const
 {
-    return hash.left(2) + "/" + hash;
+    auto it = objectsByPath.constFind(path);
+    return it != objectsByPath.constEnd() ? &objects.at(*it) : nullptr;
 }
 
-NetJob::Ptr AssetsIndex::getDownloadJob()
+NetJob::Ptr AssetsIndex::getDownloadJob() const
 {
     auto job = makeShared<NetJob>(QObject::tr("Assets for %1").arg(id), APPLICATION->network());
-    for (auto& object : objects.values()) {
+    for (const auto& object : objects) {
         auto dl = object.getDownloadAction();
         if (dl) {
             job->addNetAction(dl);
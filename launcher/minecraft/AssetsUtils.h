@@ -15,36 +15,63 @@
 
 #pragma once
 
-#include <QMap>
+#include <QHash>
+#include <QList>
 #include <QString>
+#include <array>
+#include <memory>
 #include "net/NetJob.h"
 #include "net/NetRequest.h"
 
 struct AssetObject {
-    QString getRelPath();
-    QUrl getUrl();
-    QString getLocalPath();
-    Net::NetRequest::Ptr getDownloadAction();
+    QString getRelPath() const;
+    QUrl getUrl() const;
+    QString getLocalPath() const;
+    Net::NetRequest::Ptr getDownloadAction() const;
 
-    QString hash;
-    qint64 size;
+    // hex form of 'sha1', as used in object paths and URLs
+    QString hash() const;
+
+    QString path;  // where the asset goes in a virtual/resources folder, e.g. "icons/icon_16x16.png"
+    std::array<quint8, 20> sha1{};
+    qint64 size = 0;
 };
 
+/**
+ * A parsed asset index. The objects are kept in one contiguous list in index order, with a hash from their path
+ * on the side, as they are mostly walked in full and only sometimes looked up.
+ *
+ * Shared between everyone who loads the same index, so it must not be changed once loaded.
+ */
 struct AssetsIndex {
-    NetJob::Ptr getDownloadJob();
+    using Ptr = std::shared_ptr<const AssetsIndex>;
+
+    NetJob::Ptr getDownloadJob() const;
+    const AssetObject* find(const QString& path) const;
 
     QString id;
-    QMap<QString, AssetObject> objects;
+    QByteArray sha1;  // of the index file, to tell versions of the same index apart
+    QList<AssetObject> objects;
+    QHash<QString, qsizetype> objectsByPath;
     bool isVirtual = false;
     bool mapToResources = false;
 };
 
-/// FIXME: this is absolutely horrendous. REDO!!!!
 namespace AssetsUtils {
-bool loadAssetsIndexJson(const QString& id, const QString& file, AssetsIndex& index);
+/** Parses the contents of an index file. Returns nullptr if it isn't a valid index. */
+AssetsIndex::Ptr parseAssetsIndex(const QString& id, const QByteArray& data);
+
+/** Loads the index 'id' from 'file', reusing the copy parsed earlier in this process while the file stays the same.
+ *  Thread-safe. */
+AssetsIndex::Ptr loadAssetsIndex(const QString& id, const QString& file);
 
 QDir getAssetsDir(const QString& assetsId, const QString& resourcesFolder);
 
-/// Reconstruct a virtual assets folder for the given assets ID and return the folder
+/** Reconstructs the virtual assets or resources folder for the given assets ID, if it uses one.
+ *
+ *  What index the folder was built from is remembered in a manifest under assets/manifests, so relaunching with the same
+ *  index only checks which assets are missing from the folder instead of placing them all again. Blocks while checking
+ *  and placing the assets on the global thread pool, so don't call it from the GUI thread.
+ */
 bool reconstructAssets(QString assetsId, QString resourcesFolder);
 }  // namespace AssetsUtils
@@ -103,12 +103,14 @@ void Library::getApplicableFiles(const RuntimeContext& runtimeContext,
  * @param cache Pointer to the HTTP meta cache.
  * @param failedLocalFiles List to store paths for failed local files.
  * @param overridePath Optional path to override the default storage path.
+ * @param resolved Cache entries that were already resolved, by storage path, e.g. by HttpMetaCache::resolveEntries().
  * @return QList<Net::NetRequest::Ptr> List of download requests.
  */
 QList<Net::NetRequest::Ptr> Library::getDownloads(const RuntimeContext& runtimeContext,
                                                   class HttpMetaCache* cache,
                                                   QStringList& failedLocalFiles,
-                                                  const QString& overridePath) const
+                                                  const QString& overridePath,
+                                                  const QHash<QString, MetaEntryPtr>& resolved) const
 {
     QList<Net::NetRequest::Ptr> out;
     bool stale = isAlwaysStale();
@@ -128,11 +130,14 @@ QList<Net::NetRequest::Ptr> Library::getDownloads(const RuntimeContext& runtimeC
     };
 
     // Lambda function to add a download request
-    auto add_download = [this, local, check_local_file, cache, stale, &out](QString storage, QString url, QString sha1) {
+    auto add_download = [this, local, check_local_file, cache, stale, &resolved, &out](QString storage, QString url, QString sha1,
+                                                                                      qint64 size) {
         if (local) {
             return check_local_file(storage);
         }
-        auto entry = cache->resolveEntry("libraries", storage);
+        auto entry = resolved.value(storage);
+        if (!entry)
+            entry = cache->resolveEntry("libraries", storage);
         if (stale) {
             entry->setStale(true);
         }
@@ -149,15 +154,50 @@ QList<Net::NetRequest::Ptr> Library::getDownloads(const RuntimeContext& runtimeC
         if (sha1.size()) {
             auto dl = Net::ApiDownload::makeCached(url, entry, options);
             dl->addValidator(new Net::ChecksumValidator(QCryptographicHash::Sha1, sha1));
+            dl->setExpectedSize(size);
             qDebug() << "Checksummed Download for:" << rawName().serialize() << "storage:" << storage << "url:" << url;
             out.append(dl);
         } else {
-            out.append(Net::ApiDownload::makeCached(url, entry, options));
+            auto dl = Net::ApiDownload::makeCached(url, entry, options);
+            dl->setExpectedSize(size);
+            out.append(dl);
             qDebug() << "Download for:" << rawName().serialize() << "storage:" << storage << "url:" << url;
         }
         return true;
     };
 
+    forEachDownload(runtimeContext, add_download);
+    return out;
+}
+
+/**
+ * @brief Get the cache storage paths of the files this library downloads.
+ *
+ * These are the paths getDownloads() resolves in the "libraries" cache base,
+ * which allows validating all of them at once beforehand.
+ *
+ * @param runtimeContext The current runtime context.
+ * @return QStringList Storage paths, relative to the libraries folder. Empty for local libraries.
+ */
+QStringList Library::getCacheStoragePaths(const RuntimeContext& runtimeContext) const
+{
+    QStringList out;
+    if (isLocal()) {
+        return out;
+    }
+    forEachDownload(runtimeContext, [&out](QString storage, QString, QString, qint64) { out.append(storage); });
+    return out;
+}
+
+/**
+ * @brief Enumerate the files of the library that apply to the runtime context.
+ *
+ * @param runtimeContext The current runtime context.
+ * @param visit Called with the storage path, URL, sha1 (possibly empty) and size (-1 if unknown) of every file.
+ */
+void Library::forEachDownload(const RuntimeContext& runtimeContext,
+                              const std::function<void(QString, QString, QString, qint64)>& visit) const
+{
     QString raw_storage = storageSuffix(runtimeContext);
     if (m_mojangDownloads) {
         if (isNative()) {
@@ -172,18 +212,18 @@ QList<Net::NetRequest::Ptr> Library::getDownloads(const RuntimeContext& runtimeC
                     if (nat32info) {
                         auto cooked_storage = raw_storage;
                         cooked_storage.replace("${arch}", "32");
-                        add_download(cooked_storage, nat32info->url, nat32info->sha1);
+                        visit(cooked_storage, nat32info->url, nat32info->sha1, nat32info->size);
                     }
                     auto nat64info = m_mojangDownloads->getDownloadInfo(nat64Classifier);
                     if (nat64info) {
                         auto cooked_storage = raw_storage;
                         cooked_storage.replace("${arch}", "64");
-                        add_download(cooked_storage, nat64info->url, nat64info->sha1);
+                        visit(cooked_storage, nat64info->url, nat64info->sha1, nat64info->size);
                     }
                 } else {
                     auto info = m_mojangDownloads->getDownloadInfo(nativeClassifier);
                     if (info) {
-                        add_download(raw_storage, info->url, info->sha1);
+                        visit(raw_storage, info->url, info->sha1, info->size);
                     }
                 }
             } else {
@@ -192,7 +232,7 @@ QList<Net::NetRequest::Ptr> Library::getDownloads(const RuntimeContext& runtimeC
         } else {
             if (m_mojangDownloads->artifact) {
                 auto artifact = m_mojangDownloads->artifact;
-                add_download(raw_storage, artifact->url, artifact->sha1);
+                visit(raw_storage, artifact->url, artifact->sha1, artifact->size);
             } else {
                 qDebug() << "Ignoring java library" << m_name.serialize() << "because it has no artifact";
             }
@@ -216,15 +256,14 @@ QList<Net::NetRequest::Ptr> Library::getDownloads(const RuntimeContext& runtimeC
         if (raw_storage.contains("${arch}")) {
             QString cooked_storage = raw_storage;
             QString cooked_dl = raw_dl;
-            add_download(cooked_storage.replace("${arch}", "32"), cooked_dl.replace("${arch}", "32"), QString());
+            visit(cooked_storage.replace("${arch}", "32"), cooked_dl.replace("${arch}", "32"), QString(), -1);
             cooked_storage = raw_storage;
             cooked_dl = raw_dl;
-            add_download(cooked_storage.replace("${arch}", "64"), cooked_dl.replace("${arch}", "64"), QString());
+            visit(cooked_storage.replace("${arch}", "64"), cooked_dl.replace("${arch}", "64"), QString(), -1);
         } else {
-            add_download(raw_storage, raw_dl, QString());
+            visit(raw_storage, raw_dl, QString(), -1);
         }
     }
-    return out;
 }
 
 /**
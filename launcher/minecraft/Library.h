@@ -35,12 +35,14 @@
 
 #pragma once
 #include <QDir>
+#include <QHash>
 #include <QList>
 #include <QMap>
 #include <QPair>
 #include <QString>
 #include <QStringList>
 #include <QUrl>
+#include <functional>
 #include <memory>
 
 #include "GradleSpecifier.h"
@@ -143,14 +145,18 @@ class Library {
     /// Return true if the library requires forge XZ hacks
     bool isForge() const;
 
-    // Get a list of downloads for this library
+    // Get a list of downloads for this library. Entries already in `resolved`, by storage path, are used as they are.
     QList<Net::NetRequest::Ptr> getDownloads(const RuntimeContext& runtimeContext,
                                              class HttpMetaCache* cache,
                                              QStringList& failedLocalFiles,
-                                             const QString& overridePath) const;
+                                             const QString& overridePath,
+                                             const QHash<QString, std::shared_ptr<class MetaEntry>>& resolved = {}) const;
 
     QString getCompatibleNative(const RuntimeContext& runtimeContext) const;
 
+    // Get the cache storage paths of the files getDownloads() resolves
+    QStringList getCacheStoragePaths(const RuntimeContext& runtimeContext) const;
+
    private: /* methods */
     /// the default storage prefix used by Prism Launcher
     static QString defaultStoragePrefix();
@@ -161,6 +167,9 @@ class Library {
     /// Get the relative file path where the library should be saved
     QString storageSuffix(const RuntimeContext& runtimeContext) const;
 
+    /// Call visit with the storage path, URL and sha1 of every file that applies to the runtime context
+    void forEachDownload(const RuntimeContext& runtimeContext, const std::function<void(QString, QString, QString, qint64)>& visit) const;
+
     QString hint() const { return m_hint; }
 
    protected: /* data */
@@ -358,6 +358,8 @@ QString MinecraftInstance::binRoot() const
 
 QString MinecraftInstance::getNativePath() const
 {
+    if (!m_nativePath.isEmpty())
+        return m_nativePath;
     QDir natives_dir(FS::PathCombine(instanceRoot(), "natives/"));
     return natives_dir.absolutePath();
 }
@@ -1184,14 +1186,14 @@ shared_qobject_ptr<LaunchTask> MinecraftInstance::createLaunchTask(AuthSessionPt
         process->appendStep(makeShared<ScanModFolders>(pptr));
     }
 
-    // print some instance info here...
+    // extract native jars if needed
     {
-        process->appendStep(makeShared<PrintInstanceInfo>(pptr, session, targetToJoin));
+        process->appendStep(makeShared<ExtractNatives>(pptr));
     }
 
-    // extract native jars if needed
+    // print some instance info here, once we know where the natives are...
     {
-        process->appendStep(makeShared<ExtractNatives>(pptr));
+        process->appendStep(makeShared<PrintInstanceInfo>(pptr, session, targetToJoin));
     }
 
     // reconstruct assets if needed
@@ -99,6 +99,8 @@ class MinecraftInstance : public BaseInstance {
 
     // where to put the natives during/before launch
     QString getNativePath() const;
+    // set while launching, when the natives come from the shared cache instead. an empty path goes back to the default
+    void setNativePath(const QString& path) { m_nativePath = path; }
 
     // where the instance-local libraries should be
     QString getLocalLibraryPath() const;
@@ -171,6 +173,7 @@ class MinecraftInstance : public BaseInstance {
     mutable std::shared_ptr<TexturePackFolderModel> m_texture_pack_list;
     mutable std::shared_ptr<DataPackFolderModel> m_data_pack_list;
     mutable std::shared_ptr<WorldList> m_world_list;
+    QString m_nativePath;
 };
 
 using MinecraftInstancePtr = std::shared_ptr<MinecraftInstance>;
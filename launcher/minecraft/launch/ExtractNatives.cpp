@@ -17,10 +17,16 @@
 #include <launch/LaunchTask.h>
 #include <minecraft/MinecraftInstance.h>
 
+#include <QCryptographicHash>
+#include <QDateTime>
 #include <QDir>
+#include <QTemporaryDir>
+#include <filesystem>
 #include "FileSystem.h"
+#include "StringUtils.h"
 #include "archive/ArchiveReader.h"
 #include "archive/ArchiveWriter.h"
+#include "modplatform/helpers/HashUtils.h"
 
 #ifdef major
 #undef major
@@ -57,6 +63,74 @@ static bool unzipNatives(QString source, QString targetFolder, bool applyJnilibH
     });
 }
 
+// bump whenever the way natives get extracted changes, so folders extracted the old way aren't used anymore
+static constexpr int s_nativesCacheVersion = 1;
+// natives folders no launch used for this long get removed
+static constexpr qint64 s_nativesCacheMaxAgeSecs = 30 * 24 * 60 * 60;
+// staging folders this old were left behind by a launch that didn't finish extracting
+static constexpr qint64 s_nativesStagingMaxAgeSecs = 24 * 60 * 60;
+
+static QString nativesCacheKey(const QStringList& jars, bool applyJnilibHack)
+{
+    QCryptographicHash key(QCryptographicHash::Sha1);
+    key.addData(QByteArray::number(s_nativesCacheVersion));
+    key.addData(applyJnilibHack ? QByteArrayView("jnilib") : QByteArrayView("-"));
+    // kept in order, as later jars overwrite files of the earlier ones
+    for (const auto& jar : jars) {
+        auto hash = Hashing::hash(jar, Hashing::Algorithm::Sha1);
+        if (hash.isEmpty())
+            return {};
+        key.addData(hash.toLatin1());
+    }
+    return QString::fromLatin1(key.result().toHex());
+}
+
+static void pruneNativesCache(const QDir& cacheDir)
+{
+    auto now = QDateTime::currentDateTime();
+    for (const auto& info : cacheDir.entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+        // staging folders are named "<key>-XXXXXX"
+        bool staging = info.fileName().contains('-');
+        if (info.lastModified() < now.addSecs(-(staging ? s_nativesStagingMaxAgeSecs : s_nativesCacheMaxAgeSecs)))
+            FS::deletePath(info.absoluteFilePath());
+    }
+}
+
+/** Returns a folder holding the natives in 'jars', shared with every instance using the same ones.
+ *  The folder is never changed once it exists, so it doesn't need cleaning up after the game exits. */
+static QString extractToCache(const QStringList& jars, bool applyJnilibHack)
+{
+    auto key = nativesCacheKey(jars, applyJnilibHack);
+    if (key.isEmpty())
+        return {};
+
+    QDir cacheDir("cache/natives");
+    auto target = cacheDir.absoluteFilePath(key);
+    if (QFileInfo(target).isDir()) {
+        // mark it as used, so it doesn't get pruned
+        std::error_code err;
+        std::filesystem::last_write_time(StringUtils::toStdString(target), std::filesystem::file_time_type::clock::now(), err);
+        return target;
+    }
+
+    // extract next to the final folder and move it in place at once, so nobody ever sees it half-extracted
+    FS::ensureFolderPathExists(cacheDir.absolutePath());
+    pruneNativesCache(cacheDir);
+    QTemporaryDir staging(cacheDir.absoluteFilePath(key + "-XXXXXX"));
+    if (!staging.isValid())
+        return {};
+
+    for (const auto& source : jars) {
+        if (!unzipNatives(source, staging.path(), applyJnilibHack))
+            return {};
+    }
+
+    // another launch may have won the race, which is fine as it extracted the same files
+    if (!cacheDir.rename(staging.path(), target) && !QFileInfo(target).isDir())
+        return {};
+    return target;
+}
+
 void ExtractNatives::executeTask()
 {
     auto instance = m_parent->instance();
@@ -67,15 +141,25 @@ void ExtractNatives::executeTask()
     }
     auto settings = instance->settings();
 
-    auto outputPath = instance->getNativePath();
-    FS::ensureFolderPathExists(outputPath);
     auto javaVersion = instance->getJavaVersion();
     bool jniHackEnabled = javaVersion.major() >= 8;
+
+    auto cached = extractToCache(toExtract, jniHackEnabled);
+    if (!cached.isEmpty()) {
+        instance->setNativePath(cached);
+        emitSucceeded();
+        return;
+    }
+    emit logLine("Couldn't use the shared natives cache, extracting natives into the instance instead.", MessageLevel::Warning);
+
+    auto outputPath = instance->getNativePath();
+    FS::ensureFolderPathExists(outputPath);
     for (const auto& source : toExtract) {
         if (!unzipNatives(source, outputPath, jniHackEnabled)) {
             const char* reason = QT_TR_NOOP("Couldn't extract native jar '%1' to destination '%2'");
             emit logLine(QString(reason).arg(source, outputPath), MessageLevel::Fatal);
             emitFailed(tr(reason).arg(source, outputPath));
+            return;
         }
     }
     emitSucceeded();
@@ -84,6 +168,9 @@ void ExtractNatives::executeTask()
 void ExtractNatives::finalize()
 {
     auto instance = m_parent->instance();
+    instance->setNativePath({});
+
+    // only used when the shared cache isn't, and by older versions of the launcher
     QString target_dir = FS::PathCombine(instance->instanceRoot(), "natives/");
     QDir dir(target_dir);
     dir.removeRecursively();
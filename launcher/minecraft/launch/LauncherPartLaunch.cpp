@@ -38,6 +38,8 @@
 #include <QRegularExpression>
 #include <QStandardPaths>
 
+#include <algorithm>
+
 #include "Application.h"
 #include "Commandline.h"
 #include "FileSystem.h"
@@ -52,20 +54,41 @@ LauncherPartLaunch::LauncherPartLaunch(LaunchTask* parent)
     : LaunchStep(parent)
     , m_process(parent->instance()->getJavaVersion().defaultsToUtf8() ? QStringConverter::Utf8 : QStringConverter::System)
 {
+    // UTF-8 output is handed over as it is, and split into lines and log4j events in one go by LaunchTask
+    const bool rawOutput = parent->instance()->getJavaVersion().defaultsToUtf8();
+    m_process.setRawOutput(rawOutput);
+
     if (parent->instance()->settings()->get("CloseAfterLaunch").toBool()) {
         static const QRegularExpression s_settingUser(".*Setting user.+", QRegularExpression::CaseInsensitiveOption);
         std::shared_ptr<QMetaObject::Connection> connection{ new QMetaObject::Connection };
-        *connection =
-            connect(&m_process, &LoggedProcess::log, this, [connection](const QStringList& lines, [[maybe_unused]] MessageLevel level) {
-                qDebug() << lines;
-                if (lines.filter(s_settingUser).length() != 0) {
-                    APPLICATION->closeAllWindows();
-                    disconnect(*connection);
-                }
-            });
+        if (rawOutput) {
+            // the marker could be split between two chunks, so keep the end of the previous one around
+            auto tail = std::make_shared<QByteArray>();
+            *connection = connect(&m_process, &LoggedProcess::output, this,
+                                  [connection, tail](const QByteArray& data, [[maybe_unused]] MessageLevel level) {
+                                      static const QLatin1String s_marker("Setting user");
+                                      tail->append(data);
+                                      if (QLatin1String(tail->constData(), tail->size()).contains(s_marker, Qt::CaseInsensitive)) {
+                                          APPLICATION->closeAllWindows();
+                                          disconnect(*connection);
+                                          return;
+                                      }
+                                      tail->remove(0, std::max<qsizetype>(0, tail->size() - s_marker.size()));
+                                  });
+        } else {
+            *connection =
+                connect(&m_process, &LoggedProcess::log, this, [connection](const QStringList& lines, [[maybe_unused]] MessageLevel level) {
+                    qDebug() << lines;
+                    if (lines.filter(s_settingUser).length() != 0) {
+                        APPLICATION->closeAllWindows();
+                        disconnect(*connection);
+                    }
+                });
+        }
     }
 
     connect(&m_process, &LoggedProcess::log, this, &LauncherPartLaunch::logLines);
+    connect(&m_process, &LoggedProcess::output, this, &LauncherPartLaunch::logData);
     connect(&m_process, &LoggedProcess::stateChanged, this, &LauncherPartLaunch::on_state);
 }
 
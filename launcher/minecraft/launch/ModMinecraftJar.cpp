@@ -34,11 +34,100 @@
  */
 
 #include "ModMinecraftJar.h"
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QTemporaryFile>
+#include <system_error>
 #include "FileSystem.h"
 #include "MMCZip.h"
 #include "launch/LaunchTask.h"
 #include "minecraft/MinecraftInstance.h"
 #include "minecraft/PackProfile.h"
+#include "modplatform/helpers/HashUtils.h"
+
+// bump whenever createModdedJar() starts building different jars, so the old ones aren't used anymore.
+// 2: jars were hard linked into instances before, and may have been changed through them
+static constexpr int s_jarCacheVersion = 2;
+// merged jars no launch used for this long get removed
+static constexpr qint64 s_jarCacheMaxAgeSecs = 30 * 24 * 60 * 60;
+
+/** Identifies the jar createModdedJar() builds from these inputs, or returns an empty string if it can't be cached. */
+static QString moddedJarCacheKey(const QString& sourceJarPath, const QList<Mod*>& jarMods)
+{
+    QCryptographicHash key(QCryptographicHash::Sha1);
+    key.addData(QByteArray::number(s_jarCacheVersion));
+
+    auto addFile = [&key](const QString& path) {
+        auto hash = Hashing::hash(path, Hashing::Algorithm::Sha1);
+        key.addData(hash.toLatin1());
+        return !hash.isEmpty();
+    };
+
+    if (!addFile(sourceJarPath))
+        return {};
+    // in order, as later mods win over earlier ones
+    for (const auto* mod : jarMods) {
+        if (!mod->enabled())
+            continue;
+        switch (mod->type()) {
+            case ResourceType::ZIPFILE:
+                key.addData("zip:");
+                break;
+            case ResourceType::SINGLEFILE:
+                // the file name ends up as the entry name
+                key.addData("file:" + mod->fileinfo().fileName().toUtf8());
+                break;
+            default:
+                // folders would need every file in them hashed, just build those every time
+                return {};
+        }
+        if (!addFile(mod->fileinfo().absoluteFilePath()))
+            return {};
+    }
+    return QString::fromLatin1(key.result().toHex());
+}
+
+static void pruneJarCache(const QDir& cacheDir)
+{
+    auto oldest = QDateTime::currentDateTime().addSecs(-s_jarCacheMaxAgeSecs);
+    for (const auto& info : cacheDir.entryInfoList({ "*.jar" }, QDir::Files)) {
+        if (info.lastModified() < oldest)
+            QFile::remove(info.absoluteFilePath());
+    }
+}
+
+/** Returns the cached jar for 'key', building it first if needed. Returns an empty string if that fails. */
+static QString cachedModdedJar(const QString& key, const QString& sourceJarPath, const QList<Mod*>& jarMods)
+{
+    QDir cacheDir("cache/jars");
+    auto cachedPath = cacheDir.absoluteFilePath(key + ".jar");
+
+    if (QFile::exists(cachedPath)) {
+        // mark it as used, so it doesn't get pruned
+        QFile cached(cachedPath);
+        if (cached.open(QFile::ReadWrite))
+            cached.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+        return cachedPath;
+    }
+
+    FS::ensureFolderPathExists(cacheDir.absolutePath());
+    pruneJarCache(cacheDir);
+
+    // build it next to its final place and move it there once complete, so a half-written jar is never used
+    QTemporaryFile staging(cacheDir.absoluteFilePath(key + "-XXXXXX.part"));
+    if (!staging.open())
+        return {};
+    staging.close();
+
+    // the cached jar never gets deflated again, so don't spend time compressing it
+    if (!MMCZip::createModdedJar(sourceJarPath, staging.fileName(), jarMods, true))
+        return {};
+
+    // another launch may have built the same jar in the meantime, which is fine
+    if (!QFile::rename(staging.fileName(), cachedPath) && !QFile::exists(cachedPath))
+        return {};
+    return cachedPath;
+}
 
 void ModMinecraftJar::executeTask()
 {
@@ -51,11 +140,13 @@ void ModMinecraftJar::executeTask()
     // nuke obsolete stripped jar(s) if needed
     if (!FS::ensureFolderPathExists(m_inst->binRoot())) {
         emitFailed(tr("Couldn't create the bin folder for Minecraft.jar"));
+        return;
     }
 
     auto finalJarPath = QDir(m_inst->binRoot()).absoluteFilePath("minecraft.jar");
     if (!removeJar()) {
         emitFailed(tr("Couldn't remove stale jar file: %1").arg(finalJarPath));
+        return;
     }
 
     // create temporary modded jar, if needed
@@ -67,7 +158,23 @@ void ModMinecraftJar::executeTask()
         QStringList jars, temp1, temp2, temp3, temp4;
         mainJar->getApplicableFiles(m_inst->runtimeContext(), jars, temp1, temp2, temp3, m_inst->getLocalLibraryPath());
         auto sourceJarPath = jars[0];
-        if (!MMCZip::createModdedJar(sourceJarPath, finalJarPath, jarMods)) {
+
+        if (auto key = moddedJarCacheKey(sourceJarPath, jarMods); !key.isEmpty()) {
+            auto cachedPath = cachedModdedJar(key, sourceJarPath, jarMods);
+            if (cachedPath.isEmpty()) {
+                emitFailed(tr("Failed to create the custom Minecraft jar file."));
+                return;
+            }
+            // never a hard link: anything writing to the instance's jar would change the cached one for every instance
+            std::error_code err;
+            if (!FS::canClone(cachedPath, m_inst->binRoot()) || !FS::reflink_file(cachedPath, finalJarPath, err)) {
+                QFile::remove(finalJarPath);
+                if (!QFile::copy(cachedPath, finalJarPath)) {
+                    emitFailed(tr("Couldn't copy the custom Minecraft jar file to %1").arg(finalJarPath));
+                    return;
+                }
+            }
+        } else if (!MMCZip::createModdedJar(sourceJarPath, finalJarPath, jarMods)) {
             emitFailed(tr("Failed to create the custom Minecraft jar file."));
             return;
         }
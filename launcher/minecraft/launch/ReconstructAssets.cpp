@@ -14,6 +14,7 @@
  */
 
 #include "ReconstructAssets.h"
+#include <QtConcurrent>
 #include "launch/LaunchTask.h"
 #include "minecraft/AssetsUtils.h"
 #include "minecraft/MinecraftInstance.h"
@@ -26,9 +27,12 @@ void ReconstructAssets::executeTask()
     auto profile = components->getProfile();
     auto assets = profile->getMinecraftAssets();
 
-    if (!AssetsUtils::reconstructAssets(assets->id, instance->resourcesDir())) {
-        emit logLine("Failed to reconstruct Minecraft assets.", MessageLevel::Error);
-    }
-
-    emitSucceeded();
+    connect(&m_watcher, &QFutureWatcher<bool>::finished, this, [this] {
+        if (!m_watcher.result()) {
+            emit logLine("Failed to reconstruct Minecraft assets.", MessageLevel::Error);
+        }
+        emitSucceeded();
+    });
+    m_watcher.setFuture(QtConcurrent::run(
+        [assetsId = assets->id, resourcesDir = instance->resourcesDir()] { return AssetsUtils::reconstructAssets(assetsId, resourcesDir); }));
 }
@@ -16,6 +16,7 @@
 #pragma once
 
 #include <launch/LaunchStep.h>
+#include <QFutureWatcher>
 #include <memory>
 
 class ReconstructAssets : public LaunchStep {
@@ -26,4 +27,7 @@ class ReconstructAssets : public LaunchStep {
 
     void executeTask() override;
     bool canAbort() const override { return false; }
+
+   private:
+    QFutureWatcher<bool> m_watcher;
 };
@@ -270,6 +270,9 @@ QPixmap Mod::icon(QSize size, Qt::AspectRatioMode mode) const
         qDebug() << "Mod" << name() << "Had it's icon evicted from the cache. reloading...";
         PixmapCache::markCacheMissByEviciton();
     }
+    if (!m_iconThumbnail.isNull()) {
+        return pixmap_transform(setIcon(m_iconThumbnail));
+    }
     // Image got evicted from the cache or an attempt to load it has not been made. load it and retry.
     m_packImageCacheKey.wasReadAttempt = true;
     if (ModUtils::loadIconFile(*this, &cached_image)) {
@@ -77,6 +77,8 @@ class Mod : public Resource {
     QPixmap icon(QSize size, Qt::AspectRatioMode mode = Qt::AspectRatioMode::IgnoreAspectRatio) const;
     /** Thread-safe. */
     QPixmap setIcon(QImage new_image) const;
+    /** Icon already read by the parse task (or cached from an earlier one), used instead of opening the file again. */
+    void setIconThumbnail(QImage thumbnail) { m_iconThumbnail = std::move(thumbnail); }
 
     void setDetails(const ModDetails& details);
 
@@ -94,6 +96,7 @@ class Mod : public Resource {
 
    protected:
     ModDetails m_local_details;
+    QImage m_iconThumbnail;
 
     mutable QMutex m_data_lock;
 
@@ -0,0 +1,154 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  Prism Launcher - Minecraft Launcher
+ *  Copyright (c) 2026 Prism Launcher Contributors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "ModDetailsIndex.h"
+
+#include <QBuffer>
+#include <QDataStream>
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+
+#include "FileSystem.h"
+
+namespace {
+constexpr quint32 s_magic = 0x504d4449;  // "PMDI"
+// bump this whenever LocalModParseTask starts extracting something new, so old results get parsed again
+constexpr quint32 s_version = 1;
+}  // namespace
+
+static QDataStream& operator<<(QDataStream& out, const ModLicense& license)
+{
+    return out << license.name << license.id << license.url << license.description;
+}
+
+static QDataStream& operator>>(QDataStream& in, ModLicense& license)
+{
+    return in >> license.name >> license.id >> license.url >> license.description;
+}
+
+static QDataStream& operator<<(QDataStream& out, const ModDetails& details)
+{
+    return out << details.mod_id << details.name << details.version << details.mcversion << details.homeurl << details.description
+               << details.authors << details.issue_tracker << details.licenses << details.icon_file;
+}
+
+static QDataStream& operator>>(QDataStream& in, ModDetails& details)
+{
+    return in >> details.mod_id >> details.name >> details.version >> details.mcversion >> details.homeurl >> details.description >>
+           details.authors >> details.issue_tracker >> details.licenses >> details.icon_file;
+}
+
+ModDetailsIndex::ModDetailsIndex(QString path) : m_path(std::move(path))
+{
+    m_saveTimer.setSingleShot(true);
+    m_saveTimer.setTimerType(Qt::VeryCoarseTimer);
+    m_saveTimer.callOnTimeout([this] { save(); });
+    load();
+}
+
+ModDetailsIndex::~ModDetailsIndex()
+{
+    m_saveTimer.stop();
+    save();
+}
+
+auto ModDetailsIndex::lookup(const QString& filePath) -> std::optional<Entry>
+{
+    const auto file = Hashing::FileIdentity::of(filePath);
+    auto it = m_entries.constFind(file.path);
+    if (!file.isValid() || it == m_entries.constEnd() || it->file != file)
+        return {};
+
+    Entry entry{ it->file, it->details, {} };
+    if (!it->icon.isEmpty())
+        entry.icon = QImage::fromData(it->icon, "PNG");
+    return entry;
+}
+
+void ModDetailsIndex::insert(const Hashing::FileIdentity& file, const ModDetails& details, const QImage& icon)
+{
+    if (!file.isValid())
+        return;
+
+    StoredEntry entry{ file, details, {} };
+    if (!icon.isNull()) {
+        QBuffer buffer(&entry.icon);
+        buffer.open(QIODevice::WriteOnly);
+        icon.save(&buffer, "PNG");
+    }
+    m_entries.insert(file.path, entry);
+    m_dirty = true;
+    saveEventually();
+}
+
+void ModDetailsIndex::saveEventually()
+{
+    m_saveTimer.start(10000);
+}
+
+void ModDetailsIndex::load()
+{
+    QFile file(m_path);
+    if (!file.open(QFile::ReadOnly))
+        return;
+
+    QDataStream in(&file);
+    quint32 magic, version, count;
+    in >> magic >> version;
+    if (magic != s_magic || version != s_version)
+        return;
+
+    in >> count;
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; i++) {
+        StoredEntry entry;
+        in >> entry.file.path >> entry.file.size >> entry.file.mtime >> entry.file.inode >> entry.details >> entry.icon;
+        m_entries.insert(entry.file.path, entry);
+    }
+    if (in.status() != QDataStream::Ok) {
+        qWarning() << "Mod index" << m_path << "is corrupted, starting over";
+        m_entries.clear();
+    }
+}
+
+void ModDetailsIndex::save()
+{
+    if (!m_dirty)
+        return;
+    m_dirty = false;
+
+    // forget about mods that were removed from the folder
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (!QFileInfo::exists(it.key()))
+            it = m_entries.erase(it);
+        else
+            ++it;
+    }
+
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out << s_magic << s_version << quint32(m_entries.size());
+    for (const auto& entry : std::as_const(m_entries))
+        out << entry.file.path << entry.file.size << entry.file.mtime << entry.file.inode << entry.details << entry.icon;
+
+    try {
+        FS::write(m_path, data);
+    } catch (const FS::FileSystemException& e) {
+        qWarning() << "Failed to save the mod index:" << e.cause();
+    }
+}
@@ -0,0 +1,70 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  Prism Launcher - Minecraft Launcher
+ *  Copyright (c) 2026 Prism Launcher Contributors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QImage>
+#include <QString>
+#include <QTimer>
+#include <optional>
+
+#include "minecraft/mod/ModDetails.h"
+#include "modplatform/helpers/HashCache.h"
+
+/**
+ * On-disk record of what parsing the mods of one folder found, so reloading the folder (or launching the instance)
+ * doesn't open every jar again. Entries are tied to the identity of the file they were parsed from, and a changed
+ * file is simply parsed again.
+ *
+ * Hashes are not stored here, the launcher-wide Hashing::HashCache already keeps them under the same identity.
+ * Not thread-safe, it is only used by the model on the GUI thread.
+ */
+class ModDetailsIndex {
+   public:
+    struct Entry {
+        Hashing::FileIdentity file;
+        ModDetails details;
+        QImage icon;
+    };
+
+    explicit ModDetailsIndex(QString path);
+    ~ModDetailsIndex();
+
+    std::optional<Entry> lookup(const QString& filePath);
+    void insert(const Hashing::FileIdentity& file, const ModDetails& details, const QImage& icon);
+
+    void save();
+
+   private:
+    struct StoredEntry {
+        Hashing::FileIdentity file;
+        ModDetails details;
+        // png, only decoded when the entry is used
+        QByteArray icon;
+    };
+
+    void load();
+    void saveEventually();
+
+    QString m_path;
+    QHash<QString, StoredEntry> m_entries;
+    bool m_dirty = false;
+
+    QTimer m_saveTimer;
+};
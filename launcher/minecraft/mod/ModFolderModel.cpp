@@ -38,6 +38,7 @@
 #include "ModFolderModel.h"
 
 #include <FileSystem.h>
+#include <QCryptographicHash>
 #include <QDebug>
 #include <QFileSystemWatcher>
 #include <QHeaderView>
@@ -49,6 +50,8 @@
 #include <QUrl>
 #include <QUuid>
 
+#include "Application.h"
+
 #include "minecraft/mod/tasks/LocalModParseTask.h"
 
 ModFolderModel::ModFolderModel(const QDir& dir, BaseInstance* instance, bool is_indexed, bool create_dir, QObject* parent)
@@ -65,6 +68,11 @@ ModFolderModel::ModFolderModel(const QDir& dir, BaseInstance* instance, bool is_
                               QHeaderView::Interactive, QHeaderView::Interactive, QHeaderView::Interactive, QHeaderView::Interactive,
                               QHeaderView::Interactive, QHeaderView::Interactive, QHeaderView::Interactive };
     m_columnsHideable = { false, true, false, true, true, true, true, true, true, true, true };
+
+    if (APPLICATION_DYN) {
+        auto folderHash = QCryptographicHash::hash(m_dir.absolutePath().toUtf8(), QCryptographicHash::Sha1).toHex();
+        m_detailsIndex = std::make_unique<ModDetailsIndex>(FS::PathCombine(QDir("cache/mod_index").absolutePath(), folderHash + ".dat"));
+    }
 }
 
 QVariant ModFolderModel::data(const QModelIndex& index, int role) const
@@ -212,6 +220,19 @@ Task* ModFolderModel::createParseTask(Resource& resource)
     return new LocalModParseTask(m_next_resolution_ticket, resource.type(), resource.fileinfo());
 }
 
+void ModFolderModel::resolveResource(Resource::Ptr res)
+{
+    if (m_detailsIndex && res->shouldResolve()) {
+        if (auto cached = m_detailsIndex->lookup(res->fileinfo().absoluteFilePath())) {
+            auto mod = static_cast<Mod*>(res.get());
+            mod->setIconThumbnail(cached->icon);
+            mod->finishResolvingWithDetails(std::move(cached->details));
+            return;
+        }
+    }
+    ResourceFolderModel::resolveResource(res);
+}
+
 bool ModFolderModel::isValid()
 {
     return m_dir.exists() && m_dir.isReadable();
@@ -233,8 +254,13 @@ void ModFolderModel::onParseSucceeded(int ticket, QString mod_id)
     auto resource = find(mod_id);
 
     auto result = cast_task->result();
-    if (result && resource)
-        static_cast<Mod*>(resource.get())->finishResolvingWithDetails(std::move(result->details));
+    if (result && resource) {
+        if (m_detailsIndex)
+            m_detailsIndex->insert(result->file, result->details, result->icon);
+        auto mod = static_cast<Mod*>(resource.get());
+        mod->setIconThumbnail(result->icon);
+        mod->finishResolvingWithDetails(std::move(result->details));
+    }
 
     emit dataChanged(index(row), index(row, columnCount(QModelIndex()) - 1));
 }
@@ -45,6 +45,7 @@
 #include <QString>
 
 #include "Mod.h"
+#include "ModDetailsIndex.h"
 #include "ResourceFolderModel.h"
 
 class BaseInstance;
@@ -83,10 +84,16 @@ class ModFolderModel : public ResourceFolderModel {
     [[nodiscard]] Resource* createResource(const QFileInfo& file) override { return new Mod(file); }
     [[nodiscard]] Task* createParseTask(Resource&) override;
 
+    void resolveResource(Resource::Ptr res) override;
+
     bool isValid();
 
     RESOURCE_HELPERS(Mod)
 
    private slots:
     void onParseSucceeded(int ticket, QString resource_id) override;
+
+   private:
+    // null in tests, where there is no launcher cache folder
+    std::unique_ptr<ModDetailsIndex> m_detailsIndex;
 };
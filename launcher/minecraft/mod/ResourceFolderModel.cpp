@@ -16,6 +16,7 @@
 #include "Application.h"
 #include "FileSystem.h"
 
+#include "minecraft/mod/ResourceParseScheduler.h"
 #include "minecraft/mod/tasks/ResourceFolderLoadTask.h"
 
 #include "Json.h"
@@ -38,14 +39,12 @@ ResourceFolderModel::ResourceFolderModel(const QDir& dir, BaseInstance* instance
     m_dir.setSorting(QDir::Name | QDir::IgnoreCase | QDir::LocaleAware);
 
     connect(&m_watcher, &QFileSystemWatcher::directoryChanged, this, &ResourceFolderModel::directoryChanged);
-    connect(&m_helper_thread_task, &ConcurrentTask::finished, this, [this] { m_helper_thread_task.clear(); });
-    if (APPLICATION_DYN) {  // in tests the application macro doesn't work
-        m_helper_thread_task.setMaxConcurrent(APPLICATION->settings()->get("NumberOfConcurrentTasks").toInt());
-    }
 }
 
 ResourceFolderModel::~ResourceFolderModel()
 {
+    ResourceParseScheduler::instance().cancelAll(this);
+    // the folder update task still runs on the global pool
     while (!QThreadPool::globalInstance()->waitForDone(100))
         QCoreApplication::processEvents();
 }
@@ -382,13 +381,42 @@ void ResourceFolderModel::resolveResource(Resource::Ptr res)
         },
         Qt::ConnectionType::QueuedConnection);
 
-    m_helper_thread_task.addTask(task);
+    auto superseded = ResourceParseScheduler::instance().schedule(this, res->fileinfo().absoluteFilePath(), task);
+    if (superseded)
+        dropParseTask(superseded.get());
+}
 
-    if (!m_helper_thread_task.isRunning()) {
-        QThreadPool::globalInstance()->start(&m_helper_thread_task);
+void ResourceFolderModel::abortParseTask(int ticket)
+{
+    auto task = m_active_parse_tasks.value(ticket);
+    if (!task)
+        return;
+
+    if (ResourceParseScheduler::instance().cancel(task.get()))
+        dropParseTask(task.get());
+    else
+        task->abort();
+}
+
+void ResourceFolderModel::dropParseTask(const Task* task)
+{
+    // a task taken out of the scheduler's queue never ran, so it won't report back on its own
+    for (auto it = m_active_parse_tasks.begin(); it != m_active_parse_tasks.end(); ++it) {
+        if (it->get() == task) {
+            m_active_parse_tasks.erase(it);
+            emit parseFinished();
+            return;
+        }
     }
 }
 
+void ResourceFolderModel::prioritize(int row) const
+{
+    auto const& res = m_resources.at(row);
+    if (res->isResolving())
+        ResourceParseScheduler::instance().prioritize(this, res->fileinfo().absoluteFilePath());
+}
+
 void ResourceFolderModel::onUpdateSucceeded()
 {
     auto update_results = static_cast<ResourceFolderLoadTask*>(m_current_update_task.get())->result();
@@ -812,13 +840,8 @@ void ResourceFolderModel::applyUpdates(QSet<QString>& current_set, QSet<QString>
 
             // If the resource is resolving, but something about it changed, we don't want to
             // continue the resolving.
-            if (current_resource->isResolving()) {
-                auto ticket = current_resource->resolutionTicket();
-                if (m_active_parse_tasks.contains(ticket)) {
-                    auto task = (*m_active_parse_tasks.find(ticket)).get();
-                    task->abort();
-                }
-            }
+            if (current_resource->isResolving())
+                abortParseTask(current_resource->resolutionTicket());
 
             m_resources[row].reset(new_resource);
             resolveResource(m_resources.at(row));
@@ -842,13 +865,8 @@ void ResourceFolderModel::applyUpdates(QSet<QString>& current_set, QSet<QString>
 
             Q_ASSERT(removed_it != m_resources.end());
 
-            if ((*removed_it)->isResolving()) {
-                auto ticket = (*removed_it)->resolutionTicket();
-                if (m_active_parse_tasks.contains(ticket)) {
-                    auto task = (*m_active_parse_tasks.find(ticket)).get();
-                    task->abort();
-                }
-            }
+            if ((*removed_it)->isResolving())
+                abortParseTask((*removed_it)->resolutionTicket());
 
             beginRemoveRows(QModelIndex(), removed_index, removed_index);
             m_resources.erase(removed_it);
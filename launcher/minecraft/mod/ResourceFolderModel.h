@@ -172,6 +172,10 @@ class ResourceFolderModel : public QAbstractListModel {
     SortType columnToSortKey(size_t column) const;
     QList<QHeaderView::ResizeMode> columnResizeModes() const { return m_column_resize_modes; }
 
+    /** Lets the parse task of the resource at 'row', if it's still waiting, go ahead of the ones not on screen.
+     *  Views call it for the rows they show, whenever those change. */
+    void prioritize(int row) const;
+
     class ProxyModel : public QSortFilterProxyModel {
        public:
         explicit ProxyModel(QObject* parent = nullptr) : QSortFilterProxyModel(parent) {}
@@ -215,6 +219,10 @@ class ResourceFolderModel : public QAbstractListModel {
      */
     void applyUpdates(QSet<QString>& current_set, QSet<QString>& new_set, QMap<QString, Resource::Ptr>& new_resources);
 
+    /** Stops the parse task with the given ticket, taking it out of the queue if it didn't start yet. */
+    void abortParseTask(int ticket);
+    void dropParseTask(const Task* task);
+
    protected slots:
     void directoryChanged(QString);
 
@@ -261,7 +269,6 @@ class ResourceFolderModel : public QAbstractListModel {
     // Represents the relationship between a resource's internal ID and it's row position on the model.
     QMap<QString, int> m_resources_index;
 
-    ConcurrentTask m_helper_thread_task;
     QMap<int, Task::Ptr> m_active_parse_tasks;
     std::atomic<int> m_next_resolution_ticket = 0;
 };
@@ -0,0 +1,261 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  Prism Launcher - Minecraft Launcher
+ *  Copyright (c) 2026 Prism Launcher Contributors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "ResourceParseScheduler.h"
+
+#include <QDebug>
+#include <QEventLoop>
+#include <QFileInfo>
+#include <QFutureWatcher>
+#include <QThread>
+#include <QtConcurrentRun>
+
+#include <algorithm>
+
+#if defined(LAUNCHER_APPLICATION)
+#include "Application.h"
+#endif
+
+Q_GLOBAL_STATIC(ResourceParseScheduler, s_scheduler)
+
+ResourceParseScheduler::ResourceParseScheduler()
+{
+    m_pool.setMaxThreadCount(configuredMaxConcurrent());
+    m_pool.setObjectName("ResourceParse");
+}
+
+ResourceParseScheduler::~ResourceParseScheduler()
+{
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+
+ResourceParseScheduler& ResourceParseScheduler::instance()
+{
+    return *s_scheduler;
+}
+
+int ResourceParseScheduler::configuredMaxConcurrent()
+{
+#if defined(LAUNCHER_APPLICATION)
+    if (APPLICATION_DYN)
+        return qMax(1, APPLICATION->settings()->get("NumberOfConcurrentTasks").toInt());
+#endif
+    // leave a core for the UI, and don't hammer the disk with more readers than it can feed
+    return qBound(1, QThread::idealThreadCount() - 1, 4);
+}
+
+Task::Ptr ResourceParseScheduler::schedule(const QObject* owner, const QString& key, Task::Ptr task, Priority priority)
+{
+    auto it = m_queues.find(owner);
+    if (it == m_queues.end()) {
+        it = m_queues.insert(owner, Queue{});
+        it->folder = QFileInfo(key).absolutePath();
+        m_owners.append(owner);
+    }
+    auto& queue = *it;
+
+    if (queue.idle())
+        queue.busy.start();
+
+    Task::Ptr superseded;
+    if (auto previous = queue.keys.constFind(key); previous != queue.keys.constEnd()) {
+        auto& waiting = queue.waiting[static_cast<int>(*previous)];
+        auto request = std::find_if(waiting.begin(), waiting.end(), [&key](const Request& r) { return r.key == key; });
+        Q_ASSERT(request != waiting.end());
+        superseded = request->task;
+        waiting.erase(request);
+        priority = std::max(priority, *previous);
+    }
+
+    queue.keys.insert(key, priority);
+    queue.waiting[static_cast<int>(priority)].append({ key, std::move(task) });
+
+    scheduleDispatch();
+    return superseded;
+}
+
+void ResourceParseScheduler::prioritize(const QObject* owner, const QString& key)
+{
+    auto it = m_queues.find(owner);
+    if (it == m_queues.end())
+        return;
+
+    auto priority = it->keys.find(key);
+    if (priority == it->keys.end())
+        return;
+
+    // visible ones move too, to the front of the line, as the view shows them again
+    auto& waiting = it->waiting[static_cast<int>(*priority)];
+    auto request = std::find_if(waiting.begin(), waiting.end(), [&key](const Request& r) { return r.key == key; });
+    Q_ASSERT(request != waiting.end());
+
+    auto moved = std::move(*request);
+    waiting.erase(request);
+    it->waiting[static_cast<int>(Priority::Visible)].append(std::move(moved));
+    *priority = Priority::Visible;
+}
+
+bool ResourceParseScheduler::cancel(const Task* task)
+{
+    for (auto it = m_queues.begin(); it != m_queues.end(); ++it) {
+        for (auto& waiting : it->waiting) {
+            auto request = std::find_if(waiting.begin(), waiting.end(), [task](const Request& r) { return r.task.get() == task; });
+            if (request == waiting.end())
+                continue;
+
+            it->keys.remove(request->key);
+            waiting.erase(request);
+            if (it->idle())
+                drained(*it);
+            return true;
+        }
+    }
+    return false;
+}
+
+void ResourceParseScheduler::cancelAll(const QObject* owner)
+{
+    auto it = m_queues.find(owner);
+    if (it == m_queues.end())
+        return;
+
+    for (auto& waiting : it->waiting)
+        waiting.clear();
+    it->keys.clear();
+
+    QList<QFuture<void>> unfinished;
+    for (auto& running : it->running) {
+        running.task->abort();
+        if (!running.future.isFinished())
+            unfinished.append(running.future);
+    }
+
+    // Parse tasks may need the GUI thread (e.g. the pixmap cache), so the event loop has to keep going while they wind down
+    if (!unfinished.isEmpty()) {
+        QEventLoop loop;
+        auto left = unfinished.size();
+        for (const auto& future : std::as_const(unfinished)) {
+            auto watcher = new QFutureWatcher<void>(&loop);
+            connect(watcher, &QFutureWatcher<void>::finished, &loop, [&loop, &left] {
+                if (--left == 0)
+                    loop.quit();
+            });
+            watcher->setFuture(future);
+        }
+        loop.exec(QEventLoop::ExcludeUserInputEvents);
+    }
+
+    m_queues.remove(owner);
+    auto index = m_owners.indexOf(owner);
+    m_owners.removeAt(index);
+    if (m_nextOwner > index)
+        --m_nextOwner;
+}
+
+auto ResourceParseScheduler::throughput(const QObject* owner) const -> Throughput
+{
+    auto it = m_queues.constFind(owner);
+    if (it == m_queues.constEnd())
+        return {};
+
+    auto throughput = it->throughput;
+    if (it->busy.isValid())
+        throughput.busyMsecs += it->busy.elapsed();
+    return throughput;
+}
+
+void ResourceParseScheduler::scheduleDispatch()
+{
+    if (m_dispatchScheduled)
+        return;
+    m_dispatchScheduled = true;
+    QMetaObject::invokeMethod(this, &ResourceParseScheduler::dispatch, Qt::QueuedConnection);
+}
+
+void ResourceParseScheduler::dispatch()
+{
+    m_dispatchScheduled = false;
+    // the setting may have changed since the last time
+    m_pool.setMaxThreadCount(configuredMaxConcurrent());
+
+    const QObject* owner = nullptr;
+    Request request;
+    while (m_running < m_pool.maxThreadCount() && takeNext(owner, request)) {
+        auto& queue = m_queues[owner];
+        ++m_running;
+
+        auto future = QtConcurrent::run(&m_pool, [this, owner, task = request.task] {
+            task->start();
+            QMetaObject::invokeMethod(this, [this, owner, task] { onTaskDone(owner, task); }, Qt::QueuedConnection);
+        });
+        queue.running.append({ std::move(request.task), std::move(future) });
+    }
+}
+
+bool ResourceParseScheduler::takeNext(const QObject*& owner, Request& request)
+{
+    if (m_owners.isEmpty())
+        return false;
+
+    for (auto priority : { Priority::Visible, Priority::Background }) {
+        for (qsizetype i = 0; i < m_owners.size(); ++i) {
+            auto index = (m_nextOwner + i) % m_owners.size();
+            auto& queue = m_queues[m_owners.at(index)];
+            auto& waiting = queue.waiting[static_cast<int>(priority)];
+            if (waiting.isEmpty())
+                continue;
+
+            // the rows prioritized last are the ones on screen now, the background ones go in folder order
+            request = priority == Priority::Visible ? waiting.takeLast() : waiting.takeFirst();
+            queue.keys.remove(request.key);
+
+            owner = m_owners.at(index);
+            m_nextOwner = (index + 1) % m_owners.size();
+            return true;
+        }
+    }
+    return false;
+}
+
+void ResourceParseScheduler::onTaskDone(const QObject* owner, Task::Ptr task)
+{
+    --m_running;
+
+    // the owner may be gone already, or even replaced by a new one at the same address
+    auto it = m_queues.find(owner);
+    if (it != m_queues.end() && it->running.removeIf([&task](const Running& running) { return running.task == task; }) > 0) {
+        it->throughput.parsed++;
+        if (it->idle())
+            drained(*it);
+    }
+
+    scheduleDispatch();
+}
+
+void ResourceParseScheduler::drained(Queue& queue)
+{
+    if (!queue.busy.isValid())
+        return;
+
+    queue.throughput.busyMsecs += queue.busy.elapsed();
+    queue.busy.invalidate();
+
+    qDebug() << "Parsed" << queue.throughput.parsed << "resources in" << queue.folder << "so far, at"
+             << qRound(queue.throughput.perSecond()) << "per second";
+}
@@ -0,0 +1,114 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  Prism Launcher - Minecraft Launcher
+ *  Copyright (c) 2026 Prism Launcher Contributors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <QElapsedTimer>
+#include <QFuture>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QThreadPool>
+
+#include "tasks/Task.h"
+
+/**
+ * Runs the parse tasks of the resource folder models on a pool of their own, so a big folder can't starve the
+ * thread pool shared with thumbnailing, hashing and the rest of the launcher. The pool is as large as the
+ * NumberOfConcurrentTasks setting allows.
+ *
+ * Requests are grouped by the model that made them and served round-robin between models, so opening several
+ * instance pages at once lets all of them make progress. Inside a model, rows that are on screen go first.
+ *
+ * Only used from the GUI thread.
+ */
+class ResourceParseScheduler : public QObject {
+    Q_OBJECT
+   public:
+    enum class Priority { Background, Visible };
+
+    struct Throughput {
+        int parsed = 0;
+        qint64 busyMsecs = 0;
+
+        [[nodiscard]] double perSecond() const { return busyMsecs > 0 ? parsed * 1000. / busyMsecs : 0.; }
+    };
+
+    ResourceParseScheduler();
+    ~ResourceParseScheduler() override;
+
+    static ResourceParseScheduler& instance();
+
+    /** Queues 'task', which parses the file at 'key' for 'owner'.
+     *
+     *  Tasks are only started once control is back in the event loop, so it's fine to connect to them after this.
+     *  If a request for the same file was still waiting it is dropped in favour of the new one, and returned so the
+     *  caller can forget about it, as it will never run.
+     */
+    [[nodiscard]] Task::Ptr schedule(const QObject* owner, const QString& key, Task::Ptr task, Priority priority = Priority::Background);
+
+    /** Moves the request for 'key', if it's still waiting, in front of the background ones of 'owner'.
+     *  Of the requests moved this way, the last one goes first. */
+    void prioritize(const QObject* owner, const QString& key);
+
+    /** Takes 'task' out of the queue. Returns false if it wasn't waiting, e.g. because it is already running. */
+    bool cancel(const Task* task);
+
+    /** Drops everything 'owner' has waiting, aborts what it has running and waits for it to return. */
+    void cancelAll(const QObject* owner);
+
+    [[nodiscard]] Throughput throughput(const QObject* owner) const;
+
+    [[nodiscard]] int maxConcurrent() const { return m_pool.maxThreadCount(); }
+
+   private:
+    struct Request {
+        QString key;
+        Task::Ptr task;
+    };
+    struct Running {
+        Task::Ptr task;
+        QFuture<void> future;
+    };
+
+    struct Queue {
+        QString folder;
+        QList<Request> waiting[2];  // indexed by Priority
+        QHash<QString, Priority> keys;
+        // until onTaskDone() gets to them, which may be after their worker returned
+        QList<Running> running;
+
+        Throughput throughput;
+        QElapsedTimer busy;
+
+        [[nodiscard]] bool idle() const { return keys.isEmpty() && running.isEmpty(); }
+    };
+
+    static int configuredMaxConcurrent();
+    void scheduleDispatch();
+    void dispatch();
+    void onTaskDone(const QObject* owner, Task::Ptr task);
+    bool takeNext(const QObject*& owner, Request& request);
+    void drained(Queue& queue);
+
+    QThreadPool m_pool;
+    QHash<const QObject*, Queue> m_queues;
+    QList<const QObject*> m_owners;  // round-robin order
+    qsizetype m_nextOwner = 0;
+    int m_running = 0;
+    bool m_dispatchScheduled = false;
+};
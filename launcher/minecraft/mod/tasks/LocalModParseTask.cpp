@@ -12,6 +12,7 @@
 #include "FileSystem.h"
 #include "Json.h"
 #include "archive/ArchiveReader.h"
+#include "archive/ZipIndex.h"
 #include "minecraft/mod/ModDetails.h"
 #include "settings/INIFile.h"
 
@@ -465,12 +466,23 @@ bool process(Mod& mod, ProcessingLevel level)
     }
 }
 
+// Reads a single file from the archive through its central directory, so the rest of the jar isn't touched.
+static std::optional<QByteArray> readArchiveFile(const QString& archivePath, const QString& filePath)
+{
+    MMCZip::ZipIndex index(archivePath);
+    if (index.open())
+        return index.read(filePath);
+
+    MMCZip::ArchiveReader zip(archivePath);
+    if (auto file = zip.goToFile(filePath); file)
+        return file->readAll();
+    return {};
+}
+
 bool processZIP(Mod& mod, [[maybe_unused]] ProcessingLevel level)
 {
     ModDetails details;
 
-    MMCZip::ArchiveReader zip(mod.fileinfo().filePath());
-
     bool baseForgePopulated = false;
     bool isNilMod = false;
     bool isValid = false;
@@ -478,85 +490,98 @@ bool processZIP(Mod& mod, [[maybe_unused]] ProcessingLevel level)
     QByteArray nilData = {};
     QString nilFilePath = {};
 
-    if (!zip.parse([&details, &baseForgePopulated, &manifestVersion, &isValid, &nilData, &isNilMod, &nilFilePath](
-                       MMCZip::ArchiveReader::File* file, bool& stop) {
-            auto filePath = file->filename();
-
-            if (filePath == "META-INF/mods.toml" || filePath == "META-INF/neoforge.mods.toml") {
-                details = ReadMCModTOML(file->readAll());
-                isValid = true;
-                if (details.version == "${file.jarVersion}" && !manifestVersion.isEmpty()) {
-                    details.version = manifestVersion;
-                }
-                stop = details.version != "${file.jarVersion}";
-                baseForgePopulated = true;
-                return true;
+    // readAll() is only called for the entries we are interested in, the rest are never decompressed
+    auto handleFile = [&details, &baseForgePopulated, &manifestVersion, &isValid, &nilData, &isNilMod, &nilFilePath](
+                          const QString& filePath, const auto& readAll, bool& stop) {
+        if (filePath == "META-INF/mods.toml" || filePath == "META-INF/neoforge.mods.toml") {
+            details = ReadMCModTOML(readAll());
+            isValid = true;
+            if (details.version == "${file.jarVersion}" && !manifestVersion.isEmpty()) {
+                details.version = manifestVersion;
             }
-            if (filePath == "META-INF/MANIFEST.MF") {
-                // quick and dirty line-by-line parser
-                auto manifestLines = QString(file->readAll()).split(s_newlineRegex);
-                manifestVersion = "";
-                for (auto& line : manifestLines) {
-                    if (line.startsWith("Implementation-Version: ", Qt::CaseInsensitive)) {
-                        manifestVersion = line.remove("Implementation-Version: ", Qt::CaseInsensitive);
-                        break;
-                    }
-                }
-
-                // some mods use ${projectversion} in their build.gradle, causing this mess to show up in MANIFEST.MF
-                // also keep with forge's behavior of setting the version to "NONE" if none is found
-                if (manifestVersion.contains("task ':jar' property 'archiveVersion'") || manifestVersion == "") {
-                    manifestVersion = "NONE";
-                }
-                if (baseForgePopulated) {
-                    details.version = manifestVersion;
-                    stop = true;
+            stop = details.version != "${file.jarVersion}";
+            baseForgePopulated = true;
+            return;
+        }
+        if (filePath == "META-INF/MANIFEST.MF") {
+            // quick and dirty line-by-line parser
+            auto manifestLines = QString(readAll()).split(s_newlineRegex);
+            manifestVersion = "";
+            for (auto& line : manifestLines) {
+                if (line.startsWith("Implementation-Version: ", Qt::CaseInsensitive)) {
+                    manifestVersion = line.remove("Implementation-Version: ", Qt::CaseInsensitive);
+                    break;
                 }
-                return true;
             }
-            if (filePath == "mcmod.info") {
-                details = ReadMCModInfo(file->readAll());
-                isValid = true;
-                stop = true;
-                return true;
-            }
-            if (filePath == "quilt.mod.json") {
-                details = ReadQuiltModInfo(file->readAll());
-                isValid = true;
-                stop = true;
-                return true;
-            }
-            if (filePath == "fabric.mod.json") {
-                details = ReadFabricModInfo(file->readAll());
-                isValid = true;
-                stop = true;
-                return true;
+
+            // some mods use ${projectversion} in their build.gradle, causing this mess to show up in MANIFEST.MF
+            // also keep with forge's behavior of setting the version to "NONE" if none is found
+            if (manifestVersion.contains("task ':jar' property 'archiveVersion'") || manifestVersion == "") {
+                manifestVersion = "NONE";
             }
-            if (filePath == "forgeversion.properties") {
-                details = ReadForgeInfo(file->readAll());
-                isValid = true;
+            if (baseForgePopulated) {
+                details.version = manifestVersion;
                 stop = true;
-                return true;
-            }
-            if (filePath == "META-INF/nil/mappings.json") {
-                // nilloader uses the filename of the metadata file for the modid, so we can't know the exact filename
-                // thankfully, there is a good file to use as a canary so we don't look for nil meta all the time
-                isNilMod = true;
-                stop = !nilFilePath.isEmpty();
-                file->skip();
-                return true;
             }
-            // nilmods can shade nilloader to be able to run as a standalone agent - which includes nilloader's own meta file
-            if (filePath.endsWith(".nilmod.css") && filePath != "nilloader.nilmod.css") {
-                nilData = file->readAll();
-                nilFilePath = filePath;
-                stop = isNilMod;
+            return;
+        }
+        if (filePath == "mcmod.info") {
+            details = ReadMCModInfo(readAll());
+            isValid = true;
+            stop = true;
+            return;
+        }
+        if (filePath == "quilt.mod.json") {
+            details = ReadQuiltModInfo(readAll());
+            isValid = true;
+            stop = true;
+            return;
+        }
+        if (filePath == "fabric.mod.json") {
+            details = ReadFabricModInfo(readAll());
+            isValid = true;
+            stop = true;
+            return;
+        }
+        if (filePath == "forgeversion.properties") {
+            details = ReadForgeInfo(readAll());
+            isValid = true;
+            stop = true;
+            return;
+        }
+        if (filePath == "META-INF/nil/mappings.json") {
+            // nilloader uses the filename of the metadata file for the modid, so we can't know the exact filename
+            // thankfully, there is a good file to use as a canary so we don't look for nil meta all the time
+            isNilMod = true;
+            stop = !nilFilePath.isEmpty();
+            return;
+        }
+        // nilmods can shade nilloader to be able to run as a standalone agent - which includes nilloader's own meta file
+        if (filePath.endsWith(".nilmod.css") && filePath != "nilloader.nilmod.css") {
+            nilData = readAll();
+            nilFilePath = filePath;
+            stop = isNilMod;
+            return;
+        }
+    };
+
+    MMCZip::ZipIndex index(mod.fileinfo().filePath());
+    if (index.open()) {
+        bool stop = false;
+        for (const auto& entry : index.entries()) {
+            handleFile(entry.name, [&index, &entry] { return index.read(entry).value_or(QByteArray()); }, stop);
+            if (stop)
+                break;
+        }
+    } else {
+        // not something the central directory reader understands, stream it through libarchive instead
+        MMCZip::ArchiveReader zip(mod.fileinfo().filePath());
+        if (!zip.parse([&handleFile](MMCZip::ArchiveReader::File* file, bool& stop) {
+                handleFile(file->filename(), [file] { return file->readAll(); }, stop);
                 return true;
-            }
-            file->skip();
-            return true;
-        })) {
-        return false;
+            })) {
+            return false;
+        }
     }
     if (isNilMod) {
         details = ReadNilModInfo(nilData, nilFilePath);
@@ -594,10 +619,8 @@ bool processLitemod(Mod& mod, [[maybe_unused]] ProcessingLevel level)
 {
     ModDetails details;
 
-    MMCZip::ArchiveReader zip(mod.fileinfo().filePath());
-
-    if (auto file = zip.goToFile("litemod.json"); file) {
-        details = ReadLiteModInfo(file->readAll());
+    if (auto data = readArchiveFile(mod.fileinfo().filePath(), "litemod.json"); data) {
+        details = ReadLiteModInfo(*data);
 
         mod.setDetails(details);
         return true;
@@ -659,12 +682,8 @@ bool loadIconFile(const Mod& mod, QPixmap* pixmap)
             return png_invalid("file '" + icon_info.filePath() + "' does not exists or is not a file");
         }
         case ResourceType::ZIPFILE: {
-            MMCZip::ArchiveReader zip(mod.fileinfo().filePath());
-            auto file = zip.goToFile(mod.iconPath());
-            if (file) {
-                auto data = file->readAll();
-
-                bool icon_result = ModUtils::processIconPNG(mod, std::move(data), pixmap);
+            if (auto data = readArchiveFile(mod.fileinfo().filePath(), mod.iconPath()); data) {
+                bool icon_result = ModUtils::processIconPNG(mod, std::move(*data), pixmap);
 
                 if (!icon_result) {
                     return png_invalid("invalid png image");  // icon png invalid
@@ -682,6 +701,35 @@ bool loadIconFile(const Mod& mod, QPixmap* pixmap)
     }
 }
 
+QImage loadIconThumbnail(const Mod& mod)
+{
+    if (mod.iconPath().isEmpty())
+        return {};
+
+    std::optional<QByteArray> data;
+    switch (mod.type()) {
+        case ResourceType::FOLDER: {
+            QFile icon(FS::PathCombine(mod.fileinfo().filePath(), mod.iconPath()));
+            if (icon.open(QIODevice::ReadOnly))
+                data = icon.readAll();
+            break;
+        }
+        case ResourceType::ZIPFILE:
+            data = readArchiveFile(mod.fileinfo().filePath(), mod.iconPath());
+            break;
+        default:
+            break;
+    }
+    if (!data)
+        return {};
+
+    auto img = QImage::fromData(*data);
+    if (img.isNull())
+        return {};
+    // same size Mod::setIcon keeps in the pixmap cache
+    return img.scaled({ 64, 64 }, Qt::AspectRatioMode::KeepAspectRatioByExpanding, Qt::SmoothTransformation);
+}
+
 }  // namespace ModUtils
 
 LocalModParseTask::LocalModParseTask(int token, ResourceType type, const QFileInfo& modFile)
@@ -696,10 +744,14 @@ bool LocalModParseTask::abort()
 
 void LocalModParseTask::executeTask()
 {
+    // taken before parsing, so a file replaced while we read it doesn't get cached under its new identity
+    m_result->file = Hashing::FileIdentity::of(m_modFile.absoluteFilePath());
+
     Mod mod{ m_modFile };
     ModUtils::process(mod, ModUtils::ProcessingLevel::Full);
 
     m_result->details = mod.details();
+    m_result->icon = ModUtils::loadIconThumbnail(mod);
 
     if (m_aborted)
         emitAborted();
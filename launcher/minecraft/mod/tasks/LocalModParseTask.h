@@ -5,6 +5,7 @@
 
 #include "minecraft/mod/Mod.h"
 #include "minecraft/mod/ModDetails.h"
+#include "modplatform/helpers/HashCache.h"
 
 #include "tasks/Task.h"
 
@@ -28,13 +29,17 @@ bool validate(QFileInfo file);
 
 bool processIconPNG(const Mod& mod, QByteArray&& raw_data, QPixmap* pixmap);
 bool loadIconFile(const Mod& mod, QPixmap* pixmap);
+/** Reads the icon of the mod and scales it down to a thumbnail. Unlike loadIconFile, this can be used off the GUI thread. */
+QImage loadIconThumbnail(const Mod& mod);
 }  // namespace ModUtils
 
 class LocalModParseTask : public Task {
     Q_OBJECT
    public:
     struct Result {
+        Hashing::FileIdentity file;
         ModDetails details;
+        QImage icon;
     };
     using ResultPtr = std::shared_ptr<Result>;
     ResultPtr result() const { return m_result; }
@@ -16,6 +16,42 @@ void LibrariesTask::executeTask()
     qDebug() << m_inst->name() << ": downloading libraries";
     MinecraftInstance* inst = (MinecraftInstance*)m_inst;
 
+    auto profile = inst->getPackProfile()->getProfile();
+
+    // validate all the cached files in one batch on worker threads, so resolving them one by one doesn't touch the disk
+    QStringList cachedStorage;
+    for (auto lib : artifactPool() + profile->getJarMods()) {
+        if (lib)
+            cachedStorage.append(lib->getCacheStoragePaths(inst->runtimeContext()));
+    }
+    APPLICATION->metacache()->resolveEntries("libraries", cachedStorage, this, [this, cachedStorage](QList<MetaEntryPtr> entries) {
+        QHash<QString, MetaEntryPtr> resolved;
+        for (qsizetype i = 0; i < entries.size(); i++)
+            resolved.insert(cachedStorage[i], entries[i]);
+        downloadLibraries(resolved);
+    });
+}
+
+QList<LibraryPtr> LibrariesTask::artifactPool() const
+{
+    auto profile = m_inst->getPackProfile()->getProfile();
+    QList<LibraryPtr> libArtifactPool;
+    libArtifactPool.append(profile->getLibraries());
+    libArtifactPool.append(profile->getNativeLibraries());
+    libArtifactPool.append(profile->getMavenFiles());
+    for (auto agent : profile->getAgents()) {
+        libArtifactPool.append(agent->library());
+    }
+    libArtifactPool.append(profile->getMainJar());
+    return libArtifactPool;
+}
+
+void LibrariesTask::downloadLibraries(const QHash<QString, MetaEntryPtr>& resolved)
+{
+    if (!isRunning())
+        return;
+    MinecraftInstance* inst = (MinecraftInstance*)m_inst;
+
     // Build a list of URLs that will need to be downloaded.
     auto components = inst->getPackProfile();
     auto profile = components->getProfile();
@@ -25,13 +61,14 @@ void LibrariesTask::executeTask()
 
     auto metacache = APPLICATION->metacache();
 
-    auto processArtifactPool = [this, inst, metacache](const QList<LibraryPtr>& pool, QStringList& errors, const QString& localPath) {
+    auto processArtifactPool = [this, inst, metacache, &resolved](const QList<LibraryPtr>& pool, QStringList& errors,
+                                                                 const QString& localPath) {
         for (auto lib : pool) {
             if (!lib) {
                 emitFailed(tr("Null jar is specified in the metadata, aborting."));
                 return false;
             }
-            auto dls = lib->getDownloads(inst->runtimeContext(), metacache.get(), errors, localPath);
+            auto dls = lib->getDownloads(inst->runtimeContext(), metacache.get(), errors, localPath, resolved);
             for (auto dl : dls) {
                 downloadJob->addNetAction(dl);
             }
@@ -40,15 +77,7 @@ void LibrariesTask::executeTask()
     };
 
     QStringList failedLocalLibraries;
-    QList<LibraryPtr> libArtifactPool;
-    libArtifactPool.append(profile->getLibraries());
-    libArtifactPool.append(profile->getNativeLibraries());
-    libArtifactPool.append(profile->getMavenFiles());
-    for (auto agent : profile->getAgents()) {
-        libArtifactPool.append(agent->library());
-    }
-    libArtifactPool.append(profile->getMainJar());
-    processArtifactPool(libArtifactPool, failedLocalLibraries, inst->getLocalLibraryPath());
+    processArtifactPool(artifactPool(), failedLocalLibraries, inst->getLocalLibraryPath());
 
     QStringList failedLocalJarMods;
     processArtifactPool(profile->getJarMods(), failedLocalJarMods, inst->jarModsDir());
@@ -85,8 +114,8 @@ bool LibrariesTask::abort()
 {
     if (downloadJob) {
         return downloadJob->abort();
-    } else {
-        qWarning() << "Prematurely aborted LibrariesTask";
     }
+    // still checking the cached files, downloadLibraries() won't start anything once aborted
+    emitAborted();
     return true;
 }
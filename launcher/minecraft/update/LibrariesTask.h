@@ -1,4 +1,6 @@
 #pragma once
+#include "minecraft/Library.h"
+#include "net/HttpMetaCache.h"
 #include "net/NetJob.h"
 #include "tasks/Task.h"
 class MinecraftInstance;
@@ -19,6 +21,10 @@ class LibrariesTask : public Task {
    public slots:
     bool abort() override;
 
+   private:
+    QList<LibraryPtr> artifactPool() const;
+    void downloadLibraries(const QHash<QString, MetaEntryPtr>& resolved);
+
    private:
     MinecraftInstance* m_inst;
     NetJob::Ptr downloadJob;
@@ -186,6 +186,7 @@ void Flame::FileResolvingTask::netJobFinished()
                         // let the user download it manually.
                         if (!file.loaders || hasSingleModLoaderSelected(file.loaders)) {
                             out.version.downloadUrl = file.downloadUrl;
+                            out.version.size = file.size;
                             qDebug() << "Found alternative on modrinth " << out.version.fileName;
                         }
                     } catch (Json::JsonException& e) {
@@ -66,6 +66,7 @@
 #include "minecraft/World.h"
 #include "minecraft/mod/tasks/LocalResourceParse.h"
 #include "net/ApiDownload.h"
+#include "net/ChecksumValidator.h"
 #include "ui/pages/modplatform/OptionalModDialog.h"
 
 static const FlameAPI api;
@@ -583,7 +584,11 @@ void FlameCreationTask::setupDownloadJob(QEventLoop& loop)
 
         if (!result.version.downloadUrl.isEmpty()) {
             qDebug() << "Will download" << result.version.downloadUrl << "to" << path;
-            auto dl = Net::ApiDownload::makeFile(result.version.downloadUrl, path);
+            auto dl = Net::ApiDownload::makeFile(result.version.downloadUrl, path, Net::Download::Option::UseContentStore);
+            if (result.version.hash_type == "sha1" && !result.version.hash.isEmpty()) {
+                dl->addValidator(new Net::ChecksumValidator(QCryptographicHash::Sha1, result.version.hash));
+            }
+            dl->setExpectedSize(result.version.size);
             m_filesJob->addNetAction(dl);
         }
     }
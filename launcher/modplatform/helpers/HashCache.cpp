@@ -0,0 +1,204 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  Prism Launcher - Minecraft Launcher
+ *  Copyright (c) 2026 Prism Launcher Contributors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "HashCache.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+
+#include "FileSystem.h"
+#include "modplatform/helpers/HashUtils.h"
+
+#if !defined(Q_OS_WIN)
+#include <sys/stat.h>
+#endif
+
+namespace Hashing {
+
+namespace {
+constexpr quint32 s_magic = 0x50484348;  // "PHCH"
+constexpr quint32 s_version = 1;
+
+// entries of files that haven't been looked at in this long are dropped on save
+constexpr qint64 s_maxUnusedSecs = 90 * 24 * 60 * 60;
+// how stale the last use of an entry may be before looking it up is worth writing the cache again
+constexpr qint64 s_lastUsedResolutionSecs = 24 * 60 * 60;
+}  // namespace
+
+FileIdentity FileIdentity::of(const QString& path)
+{
+    FileIdentity identity;
+    identity.path = QFileInfo(path).absoluteFilePath();
+#if defined(Q_OS_WIN)
+    // no cheap inode equivalent, path, size and mtime have to do
+    QFileInfo info(identity.path);
+    if (info.isFile()) {
+        identity.size = info.size();
+        identity.mtime = info.lastModified().toMSecsSinceEpoch();
+    }
+#else
+    struct stat st;
+    if (::stat(QFile::encodeName(identity.path).constData(), &st) == 0 && S_ISREG(st.st_mode)) {
+        identity.size = st.st_size;
+#if defined(Q_OS_MACOS)
+        identity.mtime = qint64(st.st_mtimespec.tv_sec) * 1000000000 + st.st_mtimespec.tv_nsec;
+#else
+        identity.mtime = qint64(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+#endif
+        identity.inode = st.st_ino;
+    }
+#endif
+    return identity;
+}
+
+HashCache::HashCache(QString path) : m_path(std::move(path))
+{
+    m_saveTimer.setSingleShot(true);
+    m_saveTimer.setTimerType(Qt::VeryCoarseTimer);
+    m_saveTimer.callOnTimeout([this] { save(); });
+    load();
+}
+
+HashCache::~HashCache()
+{
+    m_saveTimer.stop();
+    save();
+}
+
+QString HashCache::lookup(const FileIdentity& file, Algorithm type)
+{
+    if (!file.isValid())
+        return {};
+
+    QString hash;
+    {
+        QMutexLocker locker(&m_mutex);
+        auto it = m_entries.find(file.path);
+        if (it == m_entries.end() || it->file != file)
+            return {};
+        hash = it->hashes.value(type);
+
+        // files that are still in use must not be dropped as unused the next time the cache is saved
+        const auto now = QDateTime::currentSecsSinceEpoch();
+        if (now - it->lastUsed < s_lastUsedResolutionSecs)
+            return hash;
+        it->lastUsed = now;
+        m_dirty = true;
+    }
+    saveEventually();
+    return hash;
+}
+
+void HashCache::insert(const FileIdentity& file, Algorithm type, const QString& hash)
+{
+    if (!file.isValid() || hash.isEmpty())
+        return;
+
+    {
+        QMutexLocker locker(&m_mutex);
+        auto& entry = m_entries[file.path];
+        if (entry.file != file) {
+            entry.file = file;
+            entry.hashes.clear();
+        }
+        entry.hashes.insert(type, hash);
+        entry.lastUsed = QDateTime::currentSecsSinceEpoch();
+        m_dirty = true;
+    }
+    saveEventually();
+}
+
+void HashCache::saveEventually()
+{
+    // hashes are inserted from the worker threads, the timer lives on the thread that created the cache
+    QMetaObject::invokeMethod(&m_saveTimer, [this] { m_saveTimer.start(30000); });
+}
+
+void HashCache::load()
+{
+    QFile file(m_path);
+    if (!file.open(QFile::ReadOnly))
+        return;
+
+    QDataStream in(&file);
+    quint32 magic, version;
+    in >> magic >> version;
+    if (magic != s_magic || version != s_version) {
+        qWarning() << "Ignoring hash cache" << m_path << "with unknown format";
+        return;
+    }
+
+    quint32 count;
+    in >> count;
+    QMutexLocker locker(&m_mutex);
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; i++) {
+        Entry entry;
+        quint8 hashCount;
+        in >> entry.file.path >> entry.file.size >> entry.file.mtime >> entry.file.inode >> entry.lastUsed >> hashCount;
+        for (quint8 j = 0; j < hashCount; j++) {
+            quint8 type;
+            QString hash;
+            in >> type >> hash;
+            entry.hashes.insert(static_cast<Algorithm>(type), hash);
+        }
+        m_entries.insert(entry.file.path, entry);
+    }
+    if (in.status() != QDataStream::Ok) {
+        qWarning() << "Hash cache" << m_path << "is corrupted, starting over";
+        m_entries.clear();
+    }
+}
+
+void HashCache::save()
+{
+    QByteArray data;
+    {
+        QMutexLocker locker(&m_mutex);
+        if (!m_dirty)
+            return;
+        m_dirty = false;
+
+        const auto oldest = QDateTime::currentSecsSinceEpoch() - s_maxUnusedSecs;
+        for (auto it = m_entries.begin(); it != m_entries.end();) {
+            if (it->lastUsed < oldest)
+                it = m_entries.erase(it);
+            else
+                ++it;
+        }
+
+        QDataStream out(&data, QIODevice::WriteOnly);
+        out << s_magic << s_version << quint32(m_entries.size());
+        for (const auto& entry : std::as_const(m_entries)) {
+            out << entry.file.path << entry.file.size << entry.file.mtime << entry.file.inode << entry.lastUsed
+                << quint8(entry.hashes.size());
+            for (auto it = entry.hashes.cbegin(); it != entry.hashes.cend(); ++it)
+                out << quint8(it.key()) << it.value();
+        }
+    }
+
+    try {
+        FS::write(m_path, data);
+    } catch (const FS::FileSystemException& e) {
+        qWarning() << "Failed to save the hash cache:" << e.cause();
+    }
+}
+
+}  // namespace Hashing
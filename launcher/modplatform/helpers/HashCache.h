@@ -0,0 +1,77 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  Prism Launcher - Minecraft Launcher
+ *  Copyright (c) 2026 Prism Launcher Contributors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <QHash>
+#include <QMap>
+#include <QMutex>
+#include <QString>
+#include <QTimer>
+
+namespace Hashing {
+
+enum class Algorithm;
+
+// What a cached hash is tied to. Any change to the size, modification time or inode means the file was replaced.
+struct FileIdentity {
+    QString path;
+    qint64 size = -1;
+    qint64 mtime = 0;
+    quint64 inode = 0;
+
+    bool isValid() const { return size >= 0; }
+    bool operator==(const FileIdentity& other) const = default;
+
+    static FileIdentity of(const QString& path);
+};
+
+/**
+ * On-disk cache of file hashes shared by the whole launcher, so unchanged mods aren't read again every time
+ * something needs their hash. Safe to use from the hashing worker threads.
+ */
+class HashCache {
+   public:
+    explicit HashCache(QString path);
+    ~HashCache();
+
+    // the cached hash, or an empty string if the file changed or was never hashed with the algorithm
+    QString lookup(const FileIdentity& file, Algorithm type);
+    void insert(const FileIdentity& file, Algorithm type, const QString& hash);
+
+    void save();
+
+   private:
+    struct Entry {
+        FileIdentity file;
+        QMap<Algorithm, QString> hashes;
+        qint64 lastUsed = 0;
+    };
+
+    void load();
+    void saveEventually();
+
+    QString m_path;
+
+    QMutex m_mutex;
+    QHash<QString, Entry> m_entries;
+    bool m_dirty = false;
+
+    QTimer m_saveTimer;
+};
+
+}  // namespace Hashing
@@ -2,11 +2,21 @@
 
 #include <QBuffer>
 #include <QDebug>
+#include <QDirIterator>
 #include <QFile>
+#include <QThread>
+#include <QtConcurrentMap>
 #include <QtConcurrentRun>
 
+#include <memory>
+#include <optional>
+#include <vector>
+
 #include <MurmurHash2.h>
 
+#include "Application.h"
+#include "modplatform/helpers/HashCache.h"
+
 namespace Hashing {
 
 Hasher::Ptr createHasher(QString file_path, ModPlatform::ResourceProvider provider)
@@ -28,6 +38,37 @@ Hasher::Ptr createHasher(QString file_path, QString type)
     return makeShared<Hasher>(file_path, type);
 }
 
+BatchHasher::Ptr createFolderHasher(QString folder, QList<Algorithm> types)
+{
+    QStringList paths;
+    QDirIterator it(folder, QDir::Files | QDir::Hidden | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+    while (it.hasNext())
+        paths.append(it.next());
+    return makeShared<BatchHasher>(paths, types);
+}
+
+namespace {
+struct HashingPool : public QThreadPool {
+    // hashing is mostly I/O bound, more threads than this just makes the disk seek around
+    HashingPool() { setMaxThreadCount(qBound(1, QThread::idealThreadCount(), 4)); }
+};
+}  // namespace
+
+Q_GLOBAL_STATIC(HashingPool, s_pool)
+
+QThreadPool* pool()
+{
+    return s_pool();
+}
+
+// the launcher-wide cache, null in tests
+static std::shared_ptr<HashCache> hashCache()
+{
+    if (auto app = APPLICATION_DYN)
+        return app->hashCache();
+    return {};
+}
+
 class QIODeviceReader : public Murmur2::Reader {
    public:
     QIODeviceReader(QIODevice* device) : m_device(device) {}
@@ -35,12 +76,33 @@ class QIODeviceReader : public Murmur2::Reader {
     virtual int read(char* s, int n) { return m_device->read(s, n); }
     virtual bool eof() { return m_device->atEnd(); }
     virtual void goToBeginning() { m_device->seek(0); }
-    virtual void close() { m_device->close(); }
 
    private:
     QIODevice* m_device;
 };
 
+// streams the device twice, murmur2 needs the filtered length before it can start
+static uint32_t murmur2Stream(QIODevice* device)
+{
+    auto should_filter_out = [](char c) { return (c == 9 || c == 10 || c == 13 || c == 32); };
+    QIODeviceReader reader(device);
+    return Murmur2::hash(&reader, 4 * MiB, should_filter_out);
+}
+
+// CurseForge fingerprint of the whole device. Files are mapped so the jar is only read once; anything else
+// (or a file that cannot be mapped) is streamed.
+static QString murmur2Fingerprint(QIODevice* device)
+{
+    if (auto* file = qobject_cast<QFile*>(device); file && file->size() > 0) {
+        if (auto* data = file->map(0, file->size())) {
+            auto result = Murmur2::hash(reinterpret_cast<const char*>(data), file->size(), true);
+            file->unmap(data);
+            return QString::number(result);
+        }
+    }
+    return QString::number(murmur2Stream(device));
+}
+
 QString algorithmToString(Algorithm type)
 {
     switch (type) {
@@ -80,6 +142,113 @@ Algorithm algorithmFromString(QString type)
     return Algorithm::Unknown;
 }
 
+static std::optional<QCryptographicHash::Algorithm> cryptographicAlgorithm(Algorithm type)
+{
+    switch (type) {
+        case Algorithm::Md4:
+            return QCryptographicHash::Md4;
+        case Algorithm::Md5:
+            return QCryptographicHash::Md5;
+        case Algorithm::Sha1:
+            return QCryptographicHash::Sha1;
+        case Algorithm::Sha256:
+            return QCryptographicHash::Sha256;
+        case Algorithm::Sha512:
+            return QCryptographicHash::Sha512;
+        default:
+            return {};
+    }
+}
+
+static Digests readDigests(const QString& fileName, const QList<Algorithm>& types)
+{
+    Digests digests{ fileName };
+
+    QFile file(fileName);
+    if (!file.open(QFile::ReadOnly)) {
+        digests.error = file.errorString();
+        return digests;
+    }
+    digests.size = file.size();
+
+    bool murmur2 = false;
+    std::vector<std::pair<Algorithm, std::unique_ptr<QCryptographicHash>>> hashers;
+    for (auto type : types) {
+        if (type == Algorithm::Murmur2)
+            murmur2 = true;
+        else if (auto alg = cryptographicAlgorithm(type))
+            hashers.emplace_back(type, std::make_unique<QCryptographicHash>(*alg));
+    }
+
+    // feed every hasher the same chunk while it is still in cache
+    constexpr qint64 chunkSize = 1024 * 1024;
+    auto feed = [&hashers](const char* data, qint64 size) {
+        for (auto& [type, hasher] : hashers)
+            hasher->addData(QByteArrayView(data, size));
+    };
+
+    if (auto* mapped = digests.size > 0 ? file.map(0, digests.size) : nullptr) {
+        auto* data = reinterpret_cast<const char*>(mapped);
+        for (qint64 offset = 0; offset < digests.size; offset += chunkSize)
+            feed(data + offset, qMin(chunkSize, digests.size - offset));
+        if (murmur2)
+            digests.hashes.insert(Algorithm::Murmur2, QString::number(Murmur2::hash(data, digests.size, true)));
+        file.unmap(mapped);
+    } else {
+        while (!file.atEnd()) {
+            auto block = file.read(chunkSize);
+            if (block.isEmpty())
+                break;
+            feed(block.constData(), block.size());
+        }
+        if (file.error() != QFileDevice::NoError) {
+            digests.error = file.errorString();
+            return digests;
+        }
+        if (murmur2) {
+            auto result = murmur2Stream(&file);
+            if (file.error() != QFileDevice::NoError) {
+                digests.error = file.errorString();
+                return digests;
+            }
+            digests.hashes.insert(Algorithm::Murmur2, QString::number(result));
+        }
+    }
+
+    for (auto& [type, hasher] : hashers)
+        digests.hashes.insert(type, QString::fromLatin1(hasher->result().toHex()));
+    return digests;
+}
+
+Digests hashAll(const QString& fileName, const QList<Algorithm>& types)
+{
+    auto cache = hashCache();
+    if (!cache)
+        return readDigests(fileName, types);
+
+    Digests cached{ fileName };
+    QList<Algorithm> missing;
+    const auto identity = FileIdentity::of(fileName);
+    for (auto type : types) {
+        if (auto hash = cache->lookup(identity, type); !hash.isEmpty())
+            cached.hashes.insert(type, hash);
+        else
+            missing.append(type);
+    }
+    if (missing.isEmpty()) {
+        cached.size = identity.size;
+        return cached;
+    }
+
+    auto digests = readDigests(fileName, missing);
+    if (!digests.ok())
+        return digests;
+    for (auto it = digests.hashes.cbegin(); it != digests.hashes.cend(); ++it)
+        cache->insert(identity, it.key(), it.value());
+    digests.hashes.insert(cached.hashes);
+    return digests;
+}
+
 QString hash(QIODevice* device, Algorithm type)
 {
     if (!device->isOpen() && !device->open(QFile::ReadOnly))
@@ -102,9 +271,7 @@ QString hash(QIODevice* device, Algorithm type)
             alg = QCryptographicHash::Algorithm::Sha512;
             break;
         case Algorithm::Murmur2: {  // CF-specific
-            auto should_filter_out = [](char c) { return (c == 9 || c == 10 || c == 13 || c == 32); };
-            auto reader = std::make_unique<QIODeviceReader>(device);
-            auto result = QString::number(Murmur2::hash(reader.get(), 4 * MiB, should_filter_out));
+            auto result = murmur2Fingerprint(device);
             device->close();
             return result;
         }
@@ -125,8 +292,20 @@ QString hash(QIODevice* device, Algorithm type)
 
 QString hash(QString fileName, Algorithm type)
 {
+    auto cache = hashCache();
+    if (!cache) {
+        QFile file(fileName);
+        return hash(&file, type);
+    }
+
+    const auto identity = FileIdentity::of(fileName);
+    if (auto cached = cache->lookup(identity, type); !cached.isEmpty())
+        return cached;
+
     QFile file(fileName);
-    return hash(&file, type);
+    auto result = hash(&file, type);
+    cache->insert(identity, type, result);
+    return result;
 }
 
 QString hash(QByteArray data, Algorithm type)
@@ -137,8 +316,7 @@ QString hash(QByteArray data, Algorithm type)
 
 void Hasher::executeTask()
 {
-    m_future = QtConcurrent::run(
-        QThreadPool::globalInstance(), [](QString fileName, Algorithm type) { return hash(fileName, type); }, m_path, m_alg);
+    m_future = QtConcurrent::run(pool(), [](QString fileName, Algorithm type) { return hash(fileName, type); }, m_path, m_alg);
     connect(&m_watcher, &QFutureWatcher<QString>::finished, this, [this] {
         if (m_future.isCanceled()) {
             emitAborted();
@@ -162,4 +340,32 @@ bool Hasher::abort()
     }
     return false;
 }
+
+void BatchHasher::executeTask()
+{
+    setProgress(0, m_paths.size());
+
+    m_future = QtConcurrent::mapped(pool(), m_paths, [types = m_types](const QString& path) { return hashAll(path, types); });
+    connect(&m_watcher, &QFutureWatcher<Digests>::progressValueChanged, this,
+            [this](int value) { setProgress(value, m_paths.size()); });
+    connect(&m_watcher, &QFutureWatcher<Digests>::finished, this, [this] {
+        if (m_future.isCanceled()) {
+            emitAborted();
+        } else {
+            m_results = m_future.results();
+            emitSucceeded();
+        }
+    });
+    m_watcher.setFuture(m_future);
+}
+
+bool BatchHasher::abort()
+{
+    if (m_future.isRunning()) {
+        m_future.cancel();
+        // emitAborted() happens once the watcher reports the future as finished
+        return true;
+    }
+    return false;
+}
 }  // namespace Hashing
@@ -3,7 +3,9 @@
 #include <QCryptographicHash>
 #include <QFuture>
 #include <QFutureWatcher>
+#include <QMap>
 #include <QString>
+#include <QThreadPool>
 
 #include "modplatform/ModIndex.h"
 #include "tasks/Task.h"
@@ -18,6 +20,23 @@ QString hash(QIODevice* device, Algorithm type);
 QString hash(QString fileName, Algorithm type);
 QString hash(QByteArray data, Algorithm type);
 
+// All the digests requested for a single file.
+struct Digests {
+    QString path;
+    qint64 size = -1;
+    QMap<Algorithm, QString> hashes;
+    QString error;
+
+    bool ok() const { return error.isEmpty(); }
+    QString get(Algorithm type) const { return hashes.value(type); }
+};
+
+// Computes every algorithm in `types` with a single read of the file.
+Digests hashAll(const QString& fileName, const QList<Algorithm>& types);
+
+// Bounded pool the hashing tasks run on, so hashing a large folder doesn't take over the global pool.
+QThreadPool* pool();
+
 class Hasher : public Task {
     Q_OBJECT
    public:
@@ -45,7 +64,31 @@ class Hasher : public Task {
     QFutureWatcher<QString> m_watcher;
 };
 
+class BatchHasher : public Task {
+    Q_OBJECT
+   public:
+    using Ptr = shared_qobject_ptr<BatchHasher>;
+
+    BatchHasher(QStringList paths, QList<Algorithm> types) : m_paths(paths), m_types(types) {}
+
+    bool abort() override;
+
+    void executeTask() override;
+
+    // One entry per input path, in the same order. Files that couldn't be read have an error set.
+    QList<Digests> results() const { return m_results; }
+
+   private:
+    QStringList m_paths;
+    QList<Algorithm> m_types;
+    QList<Digests> m_results;
+
+    QFuture<Digests> m_future;
+    QFutureWatcher<Digests> m_watcher;
+};
+
 Hasher::Ptr createHasher(QString file_path, ModPlatform::ResourceProvider provider);
 Hasher::Ptr createHasher(QString file_path, QString type);
+BatchHasher::Ptr createFolderHasher(QString folder, QList<Algorithm> types);
 
 }  // namespace Hashing
@@ -11,8 +11,6 @@
 #include "modplatform/ModIndex.h"
 #include "modplatform/helpers/HashUtils.h"
 
-#include "tasks/ConcurrentTask.h"
-
 static ModrinthAPI api;
 
 ModrinthCheckUpdate::ModrinthCheckUpdate(QList<Resource*>& resources,
@@ -52,27 +50,32 @@ void ModrinthCheckUpdate::executeTask()
     setStatus(tr("Preparing resources for Modrinth..."));
     setProgress(0, (m_loadersList.isEmpty() ? 1 : m_loadersList.length()) * 2 + 1);
 
-    auto hashing_task =
-        makeShared<ConcurrentTask>("MakeModrinthHashesTask", APPLICATION->settings()->get("NumberOfConcurrentTasks").toInt());
-    bool startHasing = false;
+    // Sadly the API can only handle one hash type per call, se we
+    // need to generate a new hash if the current one is innadequate
+    // (though it will rarely happen, if at all)
+    QStringList paths;
+    QHash<QString, Resource*> pathMappings;
     for (auto* resource : m_resources) {
-        auto hash = resource->metadata()->hash;
-
-        // Sadly the API can only handle one hash type per call, se we
-        // need to generate a new hash if the current one is innadequate
-        // (though it will rarely happen, if at all)
         if (resource->metadata()->hash_format != m_hashType) {
-            auto hash_task = Hashing::createHasher(resource->fileinfo().absoluteFilePath(), ModPlatform::ResourceProvider::MODRINTH);
-            connect(hash_task.get(), &Hashing::Hasher::resultsReady, [this, resource](QString hash) { m_mappings.insert(hash, resource); });
-            connect(hash_task.get(), &Task::failed, [this] { failed("Failed to generate hash"); });
-            hashing_task->addTask(hash_task);
-            startHasing = true;
+            auto path = resource->fileinfo().absoluteFilePath();
+            paths.append(path);
+            pathMappings.insert(path, resource);
         } else {
-            m_mappings.insert(hash, resource);
+            m_mappings.insert(resource->metadata()->hash, resource);
         }
     }
 
-    if (startHasing) {
+    if (!paths.isEmpty()) {
+        auto hashing_task = makeShared<Hashing::BatchHasher>(paths, QList<Hashing::Algorithm>{ Hashing::algorithmFromString(m_hashType) });
+        connect(hashing_task.get(), &Task::succeeded, this, [this, hashing_task = hashing_task.get(), pathMappings] {
+            for (const auto& digests : hashing_task->results()) {
+                if (!digests.ok()) {
+                    failed("Failed to generate hash");
+                    continue;
+                }
+                m_mappings.insert(digests.get(Hashing::algorithmFromString(m_hashType)), pathMappings.value(digests.path));
+            }
+        });
         connect(hashing_task.get(), &Task::finished, this, &ModrinthCheckUpdate::checkNextLoader);
         m_job = hashing_task;
         hashing_task->start();
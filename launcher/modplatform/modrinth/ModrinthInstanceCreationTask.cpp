@@ -271,16 +271,18 @@ bool ModrinthCreationTask::createInstance()
             return false;
         }
         qDebug() << "Will try to download" << file.downloads.front() << "to" << file_path;
-        auto dl = Net::ApiDownload::makeFile(file.downloads.dequeue(), file_path);
+        auto dl = Net::ApiDownload::makeFile(file.downloads.dequeue(), file_path, Net::Download::Option::UseContentStore);
         dl->addValidator(new Net::ChecksumValidator(file.hashAlgorithm, file.hash));
+        dl->setExpectedSize(file.size);
         downloadMods->addNetAction(dl);
         if (!file.downloads.empty()) {
             // FIXME: This really needs to be put into a ConcurrentTask of
             // MultipleOptionsTask's , once those exist :)
             auto param = dl.toWeakRef();
             connect(dl.get(), &Task::failed, [&file, file_path, param, downloadMods] {
-                auto ndl = Net::ApiDownload::makeFile(file.downloads.dequeue(), file_path);
+                auto ndl = Net::ApiDownload::makeFile(file.downloads.dequeue(), file_path, Net::Download::Option::UseContentStore);
                 ndl->addValidator(new Net::ChecksumValidator(file.hashAlgorithm, file.hash));
+                ndl->setExpectedSize(file.size);
                 downloadMods->addNetAction(ndl);
                 if (auto shared = param.lock())
                     shared->succeeded();
@@ -395,6 +397,7 @@ bool ModrinthCreationTask::parseManifest(const QString& index_path,
                 QJsonObject hashes = Json::requireObject(modInfo, "hashes");
                 file.hash = QByteArray::fromHex(Json::requireString(hashes, "sha512").toLatin1());
                 file.hashAlgorithm = QCryptographicHash::Sha512;
+                file.size = modInfo["fileSize"].toInteger(-1);
 
                 // Do not use requireUrl, which uses StrictMode, instead use QUrl's default TolerantMode
                 // (as Modrinth seems to incorrectly handle spaces)
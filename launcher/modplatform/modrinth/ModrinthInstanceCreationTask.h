@@ -20,6 +20,7 @@ class ModrinthCreationTask final : public InstanceCreationTask {
         QCryptographicHash::Algorithm hashAlgorithm;
         QByteArray hash;
         QQueue<QUrl> downloads;
+        qint64 size = -1;
         bool required = true;
     };
 
@@ -94,9 +94,8 @@ void ModrinthPackExportTask::collectFiles()
 void ModrinthPackExportTask::collectHashes()
 {
     setStatus(tr("Finding file hashes..."));
+    QStringList paths;
     for (const QFileInfo& file : files) {
-        QCoreApplication::processEvents();
-
         const QString relative = gameRoot.relativeFilePath(file.absoluteFilePath());
         // require sensible file types
         if (!std::any_of(PREFIXES.begin(), PREFIXES.end(), [&relative](const QString& prefix) { return relative.startsWith(prefix); }))
@@ -105,21 +104,35 @@ void ModrinthPackExportTask::collectHashes()
                 return relative.endsWith('.' + extension) || relative.endsWith('.' + extension + ".disabled");
             }))
             continue;
+        paths.append(file.absoluteFilePath());
+    }
 
-        QFile openFile(file.absoluteFilePath());
-        if (!openFile.open(QFile::ReadOnly)) {
-            qWarning() << "Could not open" << file << "for hashing";
-            continue;
-        }
+    // both digests come out of a single read of each file
+    auto hashTask =
+        makeShared<Hashing::BatchHasher>(paths, QList<Hashing::Algorithm>{ Hashing::Algorithm::Sha512, Hashing::Algorithm::Sha1 });
+    connect(hashTask.get(), &Task::succeeded, this, [this, hashTask = hashTask.get()] { resolveHashes(hashTask->results()); });
+    connect(hashTask.get(), &Task::failed, this, &ModrinthPackExportTask::emitFailed);
+    connect(hashTask.get(), &Task::aborted, this, &ModrinthPackExportTask::emitAborted);
+    task = hashTask;
+    setAbortable(true);
+    hashTask->start();
+}
 
-        const QByteArray data = openFile.readAll();
-        if (openFile.error() != QFileDevice::NoError) {
-            qWarning() << "Could not read" << file;
+void ModrinthPackExportTask::resolveHashes(const QList<Hashing::Digests>& digests)
+{
+    task = nullptr;
+
+    auto allMods = mcInstance->loaderModList()->allMods();
+    for (const auto& digest : digests) {
+        const QFileInfo file(digest.path);
+        if (!digest.ok()) {
+            qWarning() << "Could not read" << file << "for hashing:" << digest.error;
             continue;
         }
-        auto sha512 = Hashing::hash(data, Hashing::Algorithm::Sha512);
 
-        auto allMods = mcInstance->loaderModList()->allMods();
+        const QString relative = gameRoot.relativeFilePath(digest.path);
+        auto sha512 = digest.get(Hashing::Algorithm::Sha512);
+
         if (auto modIter = std::find_if(allMods.begin(), allMods.end(), [&file](Mod* mod) { return mod->fileinfo() == file; });
             modIter != allMods.end()) {
             const Mod* mod = *modIter;
@@ -129,9 +142,9 @@ void ModrinthPackExportTask::collectHashes()
                 if (!url.isEmpty() && BuildConfig.MODRINTH_MRPACK_HOSTS.contains(url.host())) {
                     qDebug() << "Resolving" << relative << "from index";
 
-                    auto sha1 = Hashing::hash(data, Hashing::Algorithm::Sha1);
+                    auto sha1 = digest.get(Hashing::Algorithm::Sha1);
 
-                    ResolvedFile resolvedFile{ sha1, sha512, url.toEncoded(), openFile.size(), mod->metadata()->side };
+                    ResolvedFile resolvedFile{ sha1, sha512, url.toEncoded(), digest.size, mod->metadata()->side };
                     resolvedFiles[relative] = resolvedFile;
 
                     // nice! we've managed to resolve based on local metadata!
@@ -145,7 +158,6 @@ void ModrinthPackExportTask::collectHashes()
         pendingHashes[relative] = sha512;
     }
 
-    setAbortable(true);
     makeApiRequest();
 }
 
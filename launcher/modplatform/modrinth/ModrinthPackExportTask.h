@@ -24,6 +24,7 @@
 #include "MMCZip.h"
 #include "minecraft/MinecraftInstance.h"
 #include "modplatform/ModIndex.h"
+#include "modplatform/helpers/HashUtils.h"
 #include "modplatform/modrinth/ModrinthAPI.h"
 #include "tasks/Task.h"
 
@@ -69,6 +70,7 @@ class ModrinthPackExportTask : public Task {
 
     void collectFiles();
     void collectHashes();
+    void resolveHashes(const QList<Hashing::Digests>& digests);
     void makeApiRequest();
     void parseApiResponse(std::shared_ptr<QByteArray> response);
     void buildZip();
@@ -0,0 +1,160 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  Prism Launcher - Minecraft Launcher
+ *  Copyright (c) 2026 Prism Launcher Contributors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "ContentStore.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+#include "FileSystem.h"
+#include "net/Logging.h"
+
+namespace Net {
+
+namespace {
+QString algorithmDirectory(QCryptographicHash::Algorithm algorithm)
+{
+    switch (algorithm) {
+        case QCryptographicHash::Sha1:
+            return "sha1";
+        case QCryptographicHash::Sha512:
+            return "sha512";
+        default:
+            return {};
+    }
+}
+}  // namespace
+
+bool ContentStore::supports(QCryptographicHash::Algorithm algorithm)
+{
+    // weaker hashes are not good enough to tell files apart from each other
+    return !algorithmDirectory(algorithm).isEmpty();
+}
+
+QString ContentStore::blobPath(QCryptographicHash::Algorithm algorithm, const QByteArray& hash) const
+{
+    auto hex = QString::fromLatin1(hash.toHex());
+    return FS::PathCombine(m_root, algorithmDirectory(algorithm), hex.left(2), hex);
+}
+
+bool ContentStore::contains(QCryptographicHash::Algorithm algorithm, const QByteArray& hash) const
+{
+    return supports(algorithm) && !hash.isEmpty() && QFileInfo(blobPath(algorithm, hash)).isFile();
+}
+
+bool ContentStore::materialize(QCryptographicHash::Algorithm algorithm, const QByteArray& hash, const QString& destination)
+{
+    if (!contains(algorithm, hash))
+        return false;
+
+    if (!FS::ensureFilePathExists(destination))
+        return false;
+
+    // whatever was there is being replaced by the download anyway
+    if (QFileInfo::exists(destination) && !QFile::remove(destination))
+        return false;
+
+    auto blob = blobPath(algorithm, hash);
+    if (!verify(algorithm, hash, blob))
+        return false;
+    if (!place(blob, destination, methodFor(destination))) {
+        qCWarning(taskNetLogC) << "Failed to place" << blob << "at" << destination;
+        return false;
+    }
+    qCDebug(taskNetLogC) << "Placed" << destination << "from the content store";
+    return true;
+}
+
+bool ContentStore::insert(QCryptographicHash::Algorithm algorithm, const QByteArray& hash, const QString& source)
+{
+    if (!supports(algorithm) || hash.isEmpty())
+        return false;
+
+    auto blob = blobPath(algorithm, hash);
+    if (QFileInfo(blob).isFile())
+        return true;
+
+    if (!FS::ensureFilePathExists(blob))
+        return false;
+
+    // don't let a half-written blob be picked up by anyone
+    auto partial = blob + ".part";
+    QFile::remove(partial);
+    if (!place(source, partial, methodFor(source)) || !FS::move(partial, blob)) {
+        qCWarning(taskNetLogC) << "Failed to add" << source << "to the content store";
+        QFile::remove(partial);
+        return false;
+    }
+    return true;
+}
+
+bool ContentStore::verify(QCryptographicHash::Algorithm algorithm, const QByteArray& hash, const QString& blob)
+{
+    QFile file(blob);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    QCryptographicHash hasher(algorithm);
+    if (hasher.addData(&file) && hasher.result() == hash)
+        return true;
+    file.close();
+
+    // it would only be downloaded again, and then kept out of the store because the blob already exists
+    qCWarning(taskNetLogC) << "Removing" << blob << "from the content store, its contents don't match its hash";
+    QFile::remove(blob);
+    return false;
+}
+
+ContentStore::Method ContentStore::methodFor(const QString& path)
+{
+    auto folder = QFileInfo(path).absolutePath();
+
+    QMutexLocker locker(&m_methodsMutex);
+    auto it = m_methods.constFind(folder);
+    if (it != m_methods.cend())
+        return it.value();
+
+    // reflinks can't cross devices, so check where both ends actually live
+    FS::ensureFolderPathExists(m_root);
+    auto store = FS::statFS(m_root);
+    auto other = FS::statFS(folder);
+
+    auto method = Method::Copy;
+    if (store.rootPath == other.rootPath && store.fsType == other.fsType && FS::canCloneOnFS(store))
+        method = Method::Clone;
+    m_methods.insert(folder, method);
+    return method;
+}
+
+bool ContentStore::place(const QString& source, const QString& destination, Method method)
+{
+    std::error_code err;
+    switch (method) {
+        case Method::Clone:
+            if (FS::clone_file(source, destination, err))
+                return true;
+            break;
+        case Method::Copy:
+            break;
+    }
+    if (err)
+        qCDebug(taskNetLogC) << "Falling back to copying" << source << ":" << QString::fromStdString(err.message());
+    return QFile::copy(source, destination);
+}
+
+}  // namespace Net
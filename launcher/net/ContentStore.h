@@ -0,0 +1,67 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  Prism Launcher - Minecraft Launcher
+ *  Copyright (c) 2026 Prism Launcher Contributors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <QCryptographicHash>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+
+namespace Net {
+
+/**
+ * A store of downloaded files shared by all instances, addressed by their hash.
+ *
+ * Blobs live at `<root>/<algorithm>/<first two hex digits>/<hex hash>`, like assets do in `assets/objects`.
+ * They are placed into instances as reflinks when the file system supports it, and copied otherwise. Never as hard links:
+ * instance files get edited in place, and that must not change the blob, nor the files of other instances.
+ */
+class ContentStore {
+   public:
+    explicit ContentStore(QString root) : m_root(std::move(root)) {}
+
+    // whether files hashed with the algorithm can be stored
+    static bool supports(QCryptographicHash::Algorithm algorithm);
+
+    QString blobPath(QCryptographicHash::Algorithm algorithm, const QByteArray& hash) const;
+
+    bool contains(QCryptographicHash::Algorithm algorithm, const QByteArray& hash) const;
+
+    // place the blob with the hash at destination. false if it isn't stored, doesn't match its hash anymore, or couldn't be placed.
+    bool materialize(QCryptographicHash::Algorithm algorithm, const QByteArray& hash, const QString& destination);
+
+    // add a file whose hash was already verified to the store
+    bool insert(QCryptographicHash::Algorithm algorithm, const QByteArray& hash, const QString& source);
+
+   private:
+    enum class Method { Clone, Copy };
+
+    // whether the blob still has the contents its name says. blobs that don't are removed.
+    bool verify(QCryptographicHash::Algorithm algorithm, const QByteArray& hash, const QString& blob);
+
+    // the cheapest way of getting files from the store to the folder of path
+    Method methodFor(const QString& path);
+    bool place(const QString& source, const QString& destination, Method method);
+
+    QString m_root;
+
+    QMutex m_methodsMutex;
+    QHash<QString, Method> m_methods;
+};
+
+}  // namespace Net
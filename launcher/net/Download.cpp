@@ -79,7 +79,9 @@ auto Download::makeFile(QUrl url, QString path, Options options) -> Download::Pt
     dl->m_url = url;
     dl->setObjectName(QString("FILE:") + url.toString());
     dl->m_options = options;
-    dl->m_sink.reset(new FileSink(path));
+    auto sink = new FileSink(path);
+    sink->setUseContentStore(options.testFlag(Option::UseContentStore));
+    dl->m_sink.reset(sink);
     return dl;
 }
 
@@ -35,12 +35,30 @@
 
 #include "FileSink.h"
 
+#include <QRegularExpression>
+
+#include <filesystem>
+#include <system_error>
+
 #include "FileSystem.h"
+#include "StringUtils.h"
 
+#include "net/ChecksumValidator.h"
 #include "net/Logging.h"
 
+#if defined(LAUNCHER_APPLICATION)
+#include "Application.h"
+#include "net/ContentStore.h"
+#endif
+
 namespace Net {
 
+FileSink::~FileSink()
+{
+    // whatever is left was never completed, and nobody is going to resume it anymore
+    discardPartial();
+}
+
 Task::State FileSink::init(QNetworkRequest& request)
 {
     auto result = initCache(request);
@@ -48,7 +66,17 @@ Task::State FileSink::init(QNetworkRequest& request)
         return result;
     }
 
-    // create a new save file and open it for writing
+#if defined(LAUNCHER_APPLICATION)
+    // somebody already downloaded this exact file, no need to ask the network
+    if (auto validator = contentStoreValidator()) {
+        if (APPLICATION->contentStore()->materialize(validator->algorithm(), validator->expected(), m_filename)) {
+            discardPartial();
+            return Task::State::Succeeded;
+        }
+    }
+#endif
+
+    // create a new partial file and open it for writing
     if (!FS::ensureFilePathExists(m_filename)) {
         qCCritical(taskNetLogC) << "Could not create folder for " + m_filename;
         m_fail_reason = "Could not create folder";
@@ -56,8 +84,20 @@ Task::State FileSink::init(QNetworkRequest& request)
     }
 
     m_wroteAnyData = false;
-    m_output_file.reset(new PSaveFile(m_filename));
-    if (!m_output_file->open(QIODevice::WriteOnly)) {
+    m_segmented = false;
+    m_resumeOffset = 0;
+    m_output_file.reset();
+    setPartialLocked(true);
+
+    const QFileInfo partial(partialFilename());
+    if (!m_resumeValidator.isEmpty() && partial.exists() && partial.size() > 0 && resumePartial(request, partial.size()))
+        return Task::State::Running;
+
+    m_resumeValidator.clear();
+    m_validatedBytes = 0;
+    m_output_file.reset(new QFile(partialFilename()));
+    // readable too, a segmented download is read back for the validators
+    if (!m_output_file->open(QIODevice::ReadWrite | QIODevice::Truncate)) {
         qCCritical(taskNetLogC) << "Could not open " + m_filename + " for writing";
         m_fail_reason = "Could not open file";
         return Task::State::Failed;
@@ -69,27 +109,147 @@ Task::State FileSink::init(QNetworkRequest& request)
     return Task::State::Failed;
 }
 
+bool FileSink::resumePartial(QNetworkRequest& request, qint64 size)
+{
+    m_output_file.reset(new QFile(partialFilename()));
+    if (!m_output_file->open(QIODevice::ReadWrite))
+        return false;
+
+    // the validators keep their state between attempts, unless something reset them
+    if (m_validatedBytes != size) {
+        if (!initAllValidators(request))
+            return false;
+        m_validatedBytes = 0;
+        while (!m_output_file->atEnd()) {
+            auto chunk = m_output_file->read(1024 * 1024);
+            if (chunk.isEmpty() || !writeAllValidators(chunk))
+                return false;
+            m_validatedBytes += chunk.size();
+        }
+    }
+    if (m_validatedBytes != size || !m_output_file->seek(size))
+        return false;
+
+    request.setRawHeader("Range", "bytes=" + QByteArray::number(size) + "-");
+    request.setRawHeader("If-Range", m_resumeValidator);
+    m_resumeOffset = size;
+    qCDebug(taskNetLogC) << "Resuming download of" << m_filename << "after" << size << "bytes";
+    return true;
+}
+
+Task::State FileSink::headersReceived(QNetworkReply& reply)
+{
+    const int statusCode = reply.attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (statusCode == 206 && m_resumeOffset > 0) {
+        static const QRegularExpression s_contentRangeExpr("^bytes (\\d+)-");
+        const auto start = s_contentRangeExpr.match(QString::fromLatin1(reply.rawHeader("Content-Range"))).captured(1);
+        if (start.toLongLong() != m_resumeOffset) {
+            qCWarning(taskNetLogC) << "Server resumed" << m_filename << "at" << start << "instead of" << m_resumeOffset;
+            m_fail_reason = "Server resumed the download at the wrong offset";
+            discardPartial();
+            return Task::State::Failed;
+        }
+        return Task::State::Running;
+    }
+    if (statusCode == 416) {
+        // whatever the partial file holds doesn't match the file anymore
+        m_fail_reason = "Requested range not satisfiable";
+        discardPartial();
+        return Task::State::Failed;
+    }
+    if (statusCode != 200 && statusCode != 203)
+        return Task::State::Running;
+
+    if (m_resumeOffset > 0) {
+        // the file changed since the partial download (or the server ignores ranges), so this is all of it
+        qCDebug(taskNetLogC) << "Server sent all of" << m_filename << "again, dropping the partial download";
+        auto request = reply.request();
+        if (!m_output_file->resize(0) || !m_output_file->seek(0) || !initAllValidators(request)) {
+            m_fail_reason = "Failed to restart the download";
+            discardPartial();
+            return Task::State::Failed;
+        }
+        m_resumeOffset = 0;
+        m_validatedBytes = 0;
+        m_wroteAnyData = false;
+    }
+
+    // weak ETags can't be used for ranges
+    m_resumeValidator.clear();
+    auto etag = reply.rawHeader("ETag");
+    if (!etag.isEmpty() && !etag.startsWith("W/"))
+        m_resumeValidator = etag;
+    else if (reply.hasRawHeader("Last-Modified"))
+        m_resumeValidator = reply.rawHeader("Last-Modified");
+    return Task::State::Running;
+}
+
 Task::State FileSink::write(QByteArray& data)
 {
     if (!writeAllValidators(data) || m_output_file->write(data) != data.size()) {
         qCCritical(taskNetLogC) << "Failed writing into " + m_filename;
-        m_output_file->cancelWriting();
-        m_output_file.reset();
+        discardPartial();
         m_wroteAnyData = false;
         m_fail_reason = "Failed to write validators";
         return Task::State::Failed;
     }
 
+    m_validatedBytes += data.size();
     m_wroteAnyData = true;
     return Task::State::Running;
 }
 
+bool FileSink::beginSegments(qint64 size)
+{
+    // only from the start of a fresh download, the validators haven't seen anything yet
+    if (!m_output_file || m_resumeOffset > 0 || m_validatedBytes > 0 || m_wroteAnyData)
+        return false;
+    if (!m_output_file->resize(size)) {
+        qCWarning(taskNetLogC) << "Could not allocate" << size << "bytes for" << m_filename;
+        return false;
+    }
+    m_segmented = true;
+    // a partial file with holes in it can't be resumed
+    m_resumeValidator.clear();
+    return true;
+}
+
+Task::State FileSink::writeAt(qint64 offset, QByteArray& data)
+{
+    if (!m_segmented || !m_output_file->seek(offset) || m_output_file->write(data) != data.size()) {
+        qCCritical(taskNetLogC) << "Failed writing into " + m_filename;
+        discardPartial();
+        m_wroteAnyData = false;
+        m_fail_reason = "Failed to write segment";
+        return Task::State::Failed;
+    }
+
+    m_wroteAnyData = true;
+    return Task::State::Running;
+}
+
+bool FileSink::validateSegmented(QNetworkReply& reply)
+{
+    auto request = reply.request();
+    if (!initAllValidators(request) || !m_output_file->flush() || !m_output_file->seek(0))
+        return false;
+    while (!m_output_file->atEnd()) {
+        auto chunk = m_output_file->read(1024 * 1024);
+        if (chunk.isEmpty() || !writeAllValidators(chunk))
+            return false;
+    }
+    return true;
+}
+
 Task::State FileSink::abort()
 {
     if (m_output_file) {
-        m_output_file->cancelWriting();
+        m_output_file->close();
+        m_output_file.reset();
     }
-    failAllValidators();
+    // keep what we have if the next attempt can ask for just the rest
+    if (m_resumeValidator.isEmpty() || m_validatedBytes == 0)
+        discardPartial();
     return Task::State::Failed;
 }
 
@@ -101,34 +261,80 @@ Task::State FileSink::finalize(QNetworkReply& reply)
     int statusCode = statusCodeV.toInt(&validStatus);
     if (validStatus) {
         // this leaves out 304 Not Modified
-        gotFile = statusCode == 200 || statusCode == 203;
+        gotFile = statusCode == 200 || statusCode == 203 || statusCode == 206;
     }
 
-    // if we wrote any data to the save file, we try to commit the data to the real file.
+    // if we wrote any data to the partial file, we try to move it in place of the real file.
     // if it actually got a proper file, we write it even if it was empty
     if (gotFile || m_wroteAnyData) {
         // ask validators for data consistency
         // we only do this for actual downloads, not 'your data is still the same' cache hits
-        if (!finalizeAllValidators(reply)) {
+        if ((m_segmented && !validateSegmented(reply)) || !finalizeAllValidators(reply)) {
             m_fail_reason = "Failed to finalize validators";
+            // the data is bad, don't build on it in the next attempt
+            discardPartial();
             return Task::State::Failed;
         }
 
-        // nothing went wrong...
-        if (!m_output_file->commit()) {
-            qCCritical(taskNetLogC) << "Failed to commit changes to " << m_filename;
-            m_output_file->cancelWriting();
+        // nothing went wrong, replace the old file in one step so it never goes missing (MoveFileEx with REPLACE_EXISTING on Windows)
+        m_output_file->close();
+        std::error_code err;
+        if (m_output_file->error() == QFileDevice::NoError)
+            std::filesystem::rename(StringUtils::toStdString(partialFilename()), StringUtils::toStdString(m_filename), err);
+        if (m_output_file->error() != QFileDevice::NoError || err) {
+            qCCritical(taskNetLogC) << "Failed to commit changes to " << m_filename << QString::fromStdString(err.message());
+            discardPartial();
             m_fail_reason = "Failed to commit changes";
             return Task::State::Failed;
         }
     }
 
-    // then get rid of the save file
+    // then get rid of the partial file
     m_output_file.reset();
+    discardPartial();
+
+#if defined(LAUNCHER_APPLICATION)
+    if (gotFile || m_wroteAnyData) {
+        if (auto validator = contentStoreValidator()) {
+            APPLICATION->contentStore()->insert(validator->algorithm(), validator->expected(), m_filename);
+        }
+    }
+#endif
 
     return finalizeCache(reply);
 }
 
+void FileSink::discardPartial()
+{
+    if (m_output_file) {
+        m_output_file->close();
+        m_output_file.reset();
+    }
+    QFile::remove(partialFilename());
+    m_resumeValidator.clear();
+    m_resumeOffset = 0;
+    m_validatedBytes = 0;
+    m_segmented = false;
+    setPartialLocked(false);
+}
+
+void FileSink::setPartialLocked(bool locked)
+{
+    // keeps resource folder scans away from the partial file, like PSaveFile does for its temporary file
+#if defined(LAUNCHER_APPLICATION)
+    if (locked != m_partialLocked) {
+        if (auto app = APPLICATION_DYN) {
+            auto path = QFileInfo(m_filename).absoluteFilePath() + ".";
+            if (locked)
+                app->addQSavePath(path);
+            else
+                app->removeQSavePath(path);
+        }
+    }
+#endif
+    m_partialLocked = locked;
+}
+
 Task::State FileSink::initCache(QNetworkRequest&)
 {
     return Task::State::Running;
@@ -139,6 +345,21 @@ Task::State FileSink::finalizeCache(QNetworkReply&)
     return Task::State::Succeeded;
 }
 
+#if defined(LAUNCHER_APPLICATION)
+auto FileSink::contentStoreValidator() const -> ChecksumValidator*
+{
+    if (!m_useContentStore)
+        return nullptr;
+    // only files whose hash is known in advance can be looked up
+    for (auto& validator : validators) {
+        auto checksum = dynamic_cast<ChecksumValidator*>(validator.get());
+        if (checksum && !checksum->expected().isEmpty() && ContentStore::supports(checksum->algorithm()))
+            return checksum;
+    }
+    return nullptr;
+}
+#endif
+
 bool FileSink::hasLocalData()
 {
     QFileInfo info(m_filename);
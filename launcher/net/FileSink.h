@@ -35,30 +35,60 @@
 
 #pragma once
 
-#include "PSaveFile.h"
+#include <QFile>
+
 #include "Sink.h"
 
 namespace Net {
+/**
+ * Writes the download to a partial file next to the target, and moves it in place once complete.
+ * When an attempt fails after the server named the version it was sending (strong ETag or Last-Modified), the partial file is
+ * kept and the next attempt of the same request only asks for the rest of it.
+ */
 class FileSink : public Sink {
    public:
     FileSink(QString filename) : m_filename(filename) {};
-    virtual ~FileSink() = default;
+    virtual ~FileSink();
 
    public:
     auto init(QNetworkRequest& request) -> Task::State override;
     auto write(QByteArray& data) -> Task::State override;
     auto abort() -> Task::State override;
     auto finalize(QNetworkReply& reply) -> Task::State override;
+    auto headersReceived(QNetworkReply& reply) -> Task::State override;
+    auto beginSegments(qint64 size) -> bool override;
+    auto writeAt(qint64 offset, QByteArray& data) -> Task::State override;
 
     auto hasLocalData() -> bool override;
 
+    // reuse and share the file through the content store, when its expected hash is known
+    void setUseContentStore(bool use) { m_useContentStore = use; }
+
    protected:
     virtual auto initCache(QNetworkRequest&) -> Task::State;
     virtual auto finalizeCache(QNetworkReply& reply) -> Task::State;
 
+   private:
+#if defined(LAUNCHER_APPLICATION)
+    class ChecksumValidator* contentStoreValidator() const;
+#endif
+    QString partialFilename() const { return m_filename + ".part"; }
+    bool resumePartial(QNetworkRequest& request, qint64 size);
+    void discardPartial();
+    bool validateSegmented(QNetworkReply& reply);
+    void setPartialLocked(bool locked);
+
    protected:
     QString m_filename;
     bool m_wroteAnyData = false;
-    std::unique_ptr<PSaveFile> m_output_file;
+    bool m_useContentStore = false;
+    std::unique_ptr<QFile> m_output_file;
+
+   private:
+    QByteArray m_resumeValidator;  // what If-Range is sent with when resuming
+    qint64 m_resumeOffset = 0;     // where the current attempt asked the server to start
+    qint64 m_validatedBytes = 0;   // how much of the partial file the validators have seen
+    bool m_partialLocked = false;
+    bool m_segmented = false;  // written out of order, so the validators only see the data at the end
 };
 }  // namespace Net
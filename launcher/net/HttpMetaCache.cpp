@@ -39,13 +39,302 @@
 
 #include <QCryptographicHash>
 #include <QDateTime>
+#include <QDirIterator>
 #include <QFile>
 #include <QFileInfo>
+#include <QSet>
+#include <QtConcurrent>
+#include <QtEndian>
+
+#include <algorithm>
+#include <cstring>
+#include <string_view>
 
 #include <QDebug>
 
 #include "net/Logging.h"
 
+namespace {
+
+/* Binary index layout (all integers are little-endian):
+ *   header:  "PMCI" magic, quint32 version, quint64 record count
+ *   offsets: one quint64 absolute file offset per record, ordered by record key
+ *   records: see writeRecord()
+ *
+ * The journal starts with the "PMCJ" magic and a quint32 version, followed by operations of the form
+ *   quint8 op, quint32 payload size, payload (a record for updates, a length-prefixed key for removals)
+ */
+constexpr char s_index_magic[4] = { 'P', 'M', 'C', 'I' };
+constexpr quint32 s_index_version = 3;
+constexpr qint64 s_index_header_size = 16;
+
+constexpr char s_journal_magic[4] = { 'P', 'M', 'C', 'J' };
+constexpr quint32 s_journal_version = 2;
+constexpr qint64 s_journal_header_size = 8;
+
+// the journal is folded into the index once it grows past this size
+constexpr qint64 s_compaction_threshold = 256 * 1024;
+
+enum JournalOp : quint8 { UpdateOp = 1, RemoveOp = 2 };
+
+struct EntryRecord {
+    QByteArray key;
+    QByteArray md5sum;
+    QByteArray etag;
+    QByteArray remote_changed_timestamp;
+    qint64 local_changed_timestamp = 0;
+    qint64 local_size = -1;
+    qint64 current_age = 0;
+    qint64 max_age = 0;
+    bool eternal = false;
+    bool removed = false;
+};
+
+// keys sort by base first, then by path, as neither of them can contain a NUL character
+QByteArray entryKey(const QString& base, const QString& resource_path)
+{
+    return base.toUtf8() + '\0' + resource_path.toUtf8();
+}
+
+std::string_view view(const QByteArray& bytes)
+{
+    return { bytes.constData(), static_cast<size_t>(bytes.size()) };
+}
+
+QByteArray toByteArray(std::string_view bytes)
+{
+    return QByteArray(bytes.data(), static_cast<qsizetype>(bytes.size()));
+}
+
+template <typename T>
+void writeInt(QByteArray& out, T value)
+{
+    char buffer[sizeof(T)];
+    qToLittleEndian<T>(value, buffer);
+    out.append(buffer, sizeof(T));
+}
+
+void writeBytes(QByteArray& out, const QByteArray& bytes)
+{
+    writeInt<quint32>(out, static_cast<quint32>(bytes.size()));
+    out.append(bytes);
+}
+
+void writeRecord(QByteArray& out, const EntryRecord& record)
+{
+    writeBytes(out, record.key);
+    writeBytes(out, record.md5sum);
+    writeBytes(out, record.etag);
+    writeBytes(out, record.remote_changed_timestamp);
+    writeInt<qint64>(out, record.local_changed_timestamp);
+    writeInt<qint64>(out, record.local_size);
+    writeInt<qint64>(out, record.current_age);
+    writeInt<qint64>(out, record.max_age);
+    writeInt<quint8>(out, record.eternal ? 1 : 0);
+}
+
+QByteArray recordPayload(const EntryRecord& record)
+{
+    QByteArray out;
+    writeRecord(out, record);
+    return out;
+}
+
+QByteArray keyPayload(const QByteArray& key)
+{
+    QByteArray out;
+    writeBytes(out, key);
+    return out;
+}
+
+// bounds-checked reader for the structures written above
+class ByteReader {
+   public:
+    ByteReader() = default;
+    ByteReader(const char* data, qint64 size) : m_pos(data), m_end(data + size) {}
+
+    template <typename T>
+    bool readInt(T& value)
+    {
+        if (m_end - m_pos < static_cast<qint64>(sizeof(T)))
+            return false;
+        value = qFromLittleEndian<T>(m_pos);
+        m_pos += sizeof(T);
+        return true;
+    }
+
+    bool readBytes(std::string_view& bytes)
+    {
+        quint32 size;
+        if (!readInt(size) || m_end - m_pos < static_cast<qint64>(size))
+            return false;
+        bytes = { m_pos, size };
+        m_pos += size;
+        return true;
+    }
+
+    const char* position() const { return m_pos; }
+
+   private:
+    const char* m_pos = nullptr;
+    const char* m_end = nullptr;
+};
+
+bool readRecord(ByteReader& reader, EntryRecord& record)
+{
+    std::string_view key, md5sum, etag, remote_changed_timestamp;
+    quint8 flags;
+    if (!reader.readBytes(key) || !reader.readBytes(md5sum) || !reader.readBytes(etag) || !reader.readBytes(remote_changed_timestamp) ||
+        !reader.readInt(record.local_changed_timestamp) || !reader.readInt(record.local_size) || !reader.readInt(record.current_age) || !reader.readInt(record.max_age) ||
+        !reader.readInt(flags))
+        return false;
+
+    record.key = toByteArray(key);
+    record.md5sum = toByteArray(md5sum);
+    record.etag = toByteArray(etag);
+    record.remote_changed_timestamp = toByteArray(remote_changed_timestamp);
+    record.eternal = flags & 1;
+    return true;
+}
+
+// reads only the key of a record, leaving the reader past its end
+bool skipRecord(ByteReader& reader, std::string_view& key)
+{
+    std::string_view unused;
+    qint64 unused_int;
+    quint8 flags;
+    return reader.readBytes(key) && reader.readBytes(unused) && reader.readBytes(unused) && reader.readBytes(unused) &&
+           reader.readInt(unused_int) && reader.readInt(unused_int) && reader.readInt(unused_int) && reader.readInt(unused_int) &&
+           reader.readInt(flags);
+}
+
+EntryRecord makeRecord(QByteArray key, MetaEntry& entry)
+{
+    EntryRecord record;
+    record.key = std::move(key);
+    record.md5sum = entry.getMD5Sum().toUtf8();
+    record.etag = entry.getETag().toUtf8();
+    record.remote_changed_timestamp = entry.getRemoteChangedTimestamp().toUtf8();
+    record.local_changed_timestamp = entry.getLocalChangedTimestamp();
+    record.local_size = entry.getLocalSize();
+    record.eternal = entry.isEternal();
+    record.current_age = entry.getCurrentAge();
+    record.max_age = entry.getMaximumAge();
+    return record;
+}
+
+void applyRecord(MetaEntry& entry, const EntryRecord& record)
+{
+    entry.setMD5Sum(QString::fromUtf8(record.md5sum));
+    entry.setETag(QString::fromUtf8(record.etag));
+    entry.setRemoteChangedTimestamp(QString::fromUtf8(record.remote_changed_timestamp));
+    entry.setLocalChangedTimestamp(record.local_changed_timestamp);
+    entry.setLocalSize(record.local_size);
+    entry.makeEternal(record.eternal);
+    if (!record.eternal) {
+        entry.setCurrentAge(record.current_age);
+        entry.setMaximumAge(record.max_age);
+    }
+    // presumed innocent until closer examination
+    entry.setStale(false);
+}
+
+// a read-only view over a mapped index. the header is validated before one is handed out.
+struct IndexView {
+    const char* data = nullptr;
+    qint64 size = 0;
+    quint64 count = 0;
+
+    bool recordAt(quint64 i, ByteReader& reader) const
+    {
+        if (i >= count)
+            return false;
+        const auto offset = qFromLittleEndian<quint64>(data + s_index_header_size + i * sizeof(quint64));
+        if (offset >= static_cast<quint64>(size))
+            return false;
+        reader = ByteReader(data + offset, size - static_cast<qint64>(offset));
+        return true;
+    }
+};
+
+// merges the records of the current index with the ones that shadow it, and writes the result to path
+bool writeIndex(IndexView index, QList<EntryRecord> overlay, const QSet<QByteArray>& bases, const QString& path)
+{
+    std::sort(overlay.begin(), overlay.end(), [](const EntryRecord& a, const EntryRecord& b) { return view(a.key) < view(b.key); });
+
+    // entries of bases that are no longer registered are dropped, like the JSON index used to do
+    auto isKnown = [&bases](std::string_view key) {
+        auto separator = key.find('\0');
+        return separator != std::string_view::npos && bases.contains(QByteArray::fromRawData(key.data(), separator));
+    };
+
+    quint64 next_old = 0;
+    std::string_view old_key;
+    const char* old_begin = nullptr;
+    const char* old_end = nullptr;
+    auto advanceOld = [&]() {
+        while (next_old < index.count) {
+            ByteReader reader;
+            if (index.recordAt(next_old++, reader)) {
+                old_begin = reader.position();
+                if (skipRecord(reader, old_key)) {
+                    old_end = reader.position();
+                    return true;
+                }
+            }
+            qCWarning(taskHttpMetaCacheLogC) << "Skipping corrupted record in cache index";
+        }
+        return false;
+    };
+
+    QByteArray body;
+    QList<quint64> offsets;
+    offsets.reserve(index.count + overlay.size());
+
+    bool has_old = advanceOld();
+    qsizetype next_new = 0;
+    while (has_old || next_new < overlay.size()) {
+        int cmp = !has_old ? 1 : next_new >= overlay.size() ? -1 : old_key.compare(view(overlay[next_new].key));
+        if (cmp < 0) {
+            if (isKnown(old_key)) {
+                offsets.append(body.size());
+                body.append(old_begin, old_end - old_begin);
+            }
+            has_old = advanceOld();
+            continue;
+        }
+
+        const auto& record = overlay[next_new++];
+        if (cmp == 0)
+            has_old = advanceOld();
+        if (!record.removed && isKnown(view(record.key))) {
+            offsets.append(body.size());
+            writeRecord(body, record);
+        }
+    }
+
+    QByteArray file;
+    file.reserve(s_index_header_size + offsets.size() * sizeof(quint64) + body.size());
+    file.append(s_index_magic, sizeof(s_index_magic));
+    writeInt<quint32>(file, s_index_version);
+    writeInt<quint64>(file, offsets.size());
+    const quint64 body_offset = s_index_header_size + offsets.size() * sizeof(quint64);
+    for (auto offset : offsets)
+        writeInt<quint64>(file, body_offset + offset);
+    file.append(body);
+
+    try {
+        FS::write(path, file);
+    } catch (const Exception& e) {
+        qCWarning(taskHttpMetaCacheLogC) << "Error writing cache index:" << e.what();
+        return false;
+    }
+    qCDebug(taskHttpMetaCacheLogC) << "Wrote cache index with" << offsets.size() << "entries";
+    return true;
+}
+
+}  // namespace
+
 auto MetaEntry::getFullPath() -> QString
 {
     // FIXME: make local?
@@ -58,12 +347,16 @@ HttpMetaCache::HttpMetaCache(QString path) : QObject(), m_index_file(path)
     saveBatchingTimer.setTimerType(Qt::VeryCoarseTimer);
 
     connect(&saveBatchingTimer, &QTimer::timeout, this, &HttpMetaCache::SaveNow);
+    connect(&m_compaction_watcher, &QFutureWatcher<bool>::finished, this, &HttpMetaCache::compactionFinished);
 }
 
 HttpMetaCache::~HttpMetaCache()
 {
     saveBatchingTimer.stop();
-    SaveNow();
+    waitForCompaction();
+    if (m_journal.isOpen())
+        m_journal.flush();
+    unmapIndex();
 }
 
 auto HttpMetaCache::getEntry(QString base, QString resource_path) -> MetaEntryPtr
@@ -75,11 +368,17 @@ auto HttpMetaCache::getEntry(QString base, QString resource_path) -> MetaEntryPt
     }
 
     EntryMap& map = m_entries[base];
-    if (map.entry_list.contains(resource_path)) {
-        return map.entry_list[resource_path];
+    auto it = map.entry_list.constFind(resource_path);
+    if (it != map.entry_list.cend()) {
+        // entries removed during this session are kept as null, so they don't get looked up again
+        return it.value();
     }
 
-    return {};
+    auto entry = lookupIndex(base, resource_path);
+    if (entry) {
+        map.entry_list.insert(resource_path, entry);
+    }
+    return entry;
 }
 
 auto HttpMetaCache::resolveEntry(QString base, QString resource_path, QString expected_etag) -> MetaEntryPtr
@@ -91,48 +390,168 @@ auto HttpMetaCache::resolveEntry(QString base, QString resource_path, QString ex
         return staleEntry(base, resource_path);
     }
 
-    auto& selected_base = m_entries[base];
-    QString real_path = FS::PathCombine(selected_base.base_path, resource_path);
-    QFileInfo finfo(real_path);
+    if (!expected_etag.isEmpty() && expected_etag != entry->m_etag) {
+        // if the etag doesn't match expected, we disown the entry
+        dropEntry(base, resource_path);
+        return staleEntry(base, resource_path);
+    }
+
+    FileCheck check;
+    check.resource_path = resource_path;
+    check.known_last_changed = entry->m_local_changed_timestamp;
+    check.known_size = entry->m_local_size;
+    check.real_path = FS::PathCombine(m_entries[base].base_path, resource_path);
+    checkFile(check, QFileInfo(check.real_path));
+    return applyFileCheck(base, entry, check);
+}
 
+void HttpMetaCache::resolveEntries(QString base,
+                                   QStringList resource_paths,
+                                   QObject* context,
+                                   std::function<void(QList<MetaEntryPtr>)> done)
+{
+    const auto base_path = getBasePath(base);
+    QList<MetaEntryPtr> entries;
+    entries.reserve(resource_paths.size());
+    QList<DirectoryBatch> batches;
+    QHash<QString, qsizetype> batch_index;
+
+    for (auto& resource_path : resource_paths) {
+        resource_path = FS::RemoveInvalidPathChars(resource_path);
+        auto entry = getEntry(base, resource_path);
+        entries.append(entry);
+        if (!entry)
+            continue;
+
+        FileCheck check;
+        check.resource_path = resource_path;
+        check.real_path = FS::PathCombine(base_path, resource_path);
+        check.known_last_changed = entry->m_local_changed_timestamp;
+        check.known_size = entry->m_local_size;
+
+        auto directory = QFileInfo(check.real_path).path();
+        auto it = batch_index.constFind(directory);
+        if (it == batch_index.cend()) {
+            it = batch_index.insert(directory, batches.size());
+            batches.append({ directory, {} });
+        }
+        batches[it.value()].checks.append(check);
+    }
+
+    // the entries are only touched on this thread, once all the files are checked
+    auto watcher = new QFutureWatcher<DirectoryBatch>(this);
+    connect(watcher, &QFutureWatcher<DirectoryBatch>::finished, watcher, &QObject::deleteLater);
+    connect(watcher, &QFutureWatcher<DirectoryBatch>::finished, context,
+            [this, watcher, base, resource_paths, entries, done = std::move(done)] {
+                done(applyFileChecks(base, resource_paths, entries, watcher->future().results()));
+            });
+
+    // every directory is listed once, instead of looking up each of its files separately
+    watcher->setFuture(QtConcurrent::mapped(batches, [](DirectoryBatch batch) {
+        QHash<QString, QFileInfo> listing;
+        QDirIterator it(batch.path, QDir::Files | QDir::Hidden | QDir::System);
+        while (it.hasNext()) {
+            it.next();
+            listing.insert(it.fileName(), it.fileInfo());
+        }
+        for (auto& check : batch.checks) {
+            auto info = listing.constFind(QFileInfo(check.real_path).fileName());
+            // names may differ in case on case-insensitive file systems, so ask the file system directly
+            checkFile(check, info != listing.cend() ? info.value() : QFileInfo(check.real_path));
+        }
+        return batch;
+    }));
+}
+
+auto HttpMetaCache::applyFileChecks(const QString& base,
+                                    const QStringList& resource_paths,
+                                    const QList<MetaEntryPtr>& entries,
+                                    const QList<DirectoryBatch>& batches) -> QList<MetaEntryPtr>
+{
+    QHash<QString, const FileCheck*> checks;
+    for (const auto& batch : std::as_const(batches)) {
+        for (const auto& check : batch.checks)
+            checks.insert(check.resource_path, &check);
+    }
+
+    QList<MetaEntryPtr> result;
+    result.reserve(resource_paths.size());
+    for (qsizetype i = 0; i < resource_paths.size(); i++) {
+        const auto& resource_path = resource_paths[i];
+        auto check = checks.value(resource_path);
+        // a download may have stored a new entry while the files were checked, which the check says nothing about
+        auto current = getEntry(base, resource_path);
+        if (current != entries[i]) {
+            result.append(current && !current->isStale() ? current : staleEntry(base, resource_path));
+            continue;
+        }
+        if (!entries[i] || !check) {
+            result.append(staleEntry(base, resource_path));
+            continue;
+        }
+        result.append(applyFileCheck(base, entries[i], *check));
+    }
+    return result;
+}
+
+void HttpMetaCache::checkFile(FileCheck& check, const QFileInfo& info)
+{
     // is the file really there? if not -> stale
-    if (!finfo.isFile() || !finfo.isReadable()) {
-        // if the file doesn't exist, we disown the entry
-        selected_base.entry_list.remove(resource_path);
-        return staleEntry(base, resource_path);
+    if (!info.isFile() || !info.isReadable())
+        return;
+
+    check.present = true;
+    check.last_changed = info.lastModified().toUTC().toMSecsSinceEpoch();
+    check.size = info.size();
+    check.changed = check.last_changed != check.known_last_changed || (check.known_size >= 0 && check.size != check.known_size);
+    if (!check.changed)
+        return;
+
+    // if the file changed, check md5sum
+    QFile input(info.filePath());
+    if (!input.open(QIODevice::ReadOnly)) {
+        check.open_failed = true;
+        return;
     }
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    hash.addData(&input);
+    check.md5sum = QString::fromLatin1(hash.result().toHex());
+}
 
-    if (!expected_etag.isEmpty() && expected_etag != entry->m_etag) {
-        // if the etag doesn't match expected, we disown the entry
-        selected_base.entry_list.remove(resource_path);
+auto HttpMetaCache::applyFileCheck(const QString& base, MetaEntryPtr entry, const FileCheck& check) -> MetaEntryPtr
+{
+    const auto& resource_path = check.resource_path;
+
+    if (!check.present) {
+        // if the file doesn't exist, we disown the entry
+        dropEntry(base, resource_path);
         return staleEntry(base, resource_path);
     }
 
-    // if the file changed, check md5sum
-    qint64 file_last_changed = finfo.lastModified().toUTC().toMSecsSinceEpoch();
-    if (file_last_changed != entry->m_local_changed_timestamp) {
-        QFile input(real_path);
-        if (!input.open(QIODevice::ReadOnly)) {
-            qWarning() << "Failed to open file '" << input.fileName() << "' for reading!";
+    if (check.changed) {
+        if (check.open_failed) {
+            qWarning() << "Failed to open file '" << check.real_path << "' for reading!";
             return staleEntry(base, resource_path);
         }
-        QString md5sum = QCryptographicHash::hash(input.readAll(), QCryptographicHash::Md5).toHex().constData();
-        if (entry->m_md5sum != md5sum) {
-            selected_base.entry_list.remove(resource_path);
+        if (entry->m_md5sum != check.md5sum) {
+            dropEntry(base, resource_path);
             return staleEntry(base, resource_path);
         }
+    }
 
-        // md5sums matched... keep entry and save the new state to file
-        entry->m_local_changed_timestamp = file_last_changed;
-        SaveEventually();
+    if (check.changed || entry->m_local_size < 0) {
+        // md5sums matched (or we just learned the size)... keep entry and save the new state to file
+        entry->m_local_changed_timestamp = check.last_changed;
+        entry->m_local_size = check.size;
+        appendToJournal(UpdateOp, recordPayload(makeRecord(entryKey(base, resource_path), *entry)));
     }
 
     // Get rid of old entries, to prevent cache problems
     auto current_time = QDateTime::currentSecsSinceEpoch();
-    if (entry->isExpired(current_time - (file_last_changed / 1000))) {
+    if (entry->isExpired(current_time - (check.last_changed / 1000))) {
         qCWarning(taskNetLogC) << "[HttpMetaCache]"
                                << "Removing cache entry because of old age!";
-        selected_base.entry_list.remove(resource_path);
+        dropEntry(base, resource_path);
         return staleEntry(base, resource_path);
     }
 
@@ -154,7 +573,7 @@ auto HttpMetaCache::updateEntry(MetaEntryPtr stale_entry) -> bool
     }
 
     m_entries[stale_entry->m_baseId].entry_list[stale_entry->m_relativePath] = stale_entry;
-    SaveEventually();
+    appendToJournal(UpdateOp, recordPayload(makeRecord(entryKey(stale_entry->m_baseId, stale_entry->m_relativePath), *stale_entry)));
 
     return true;
 }
@@ -165,7 +584,13 @@ auto HttpMetaCache::evictEntry(MetaEntryPtr entry) -> bool
         return false;
 
     entry->m_stale = true;
-    SaveEventually();
+    if (m_entries.contains(entry->m_baseId)) {
+        // keep the evicted entry around, so the index doesn't resurrect it
+        auto& slot = m_entries[entry->m_baseId].entry_list[entry->m_relativePath];
+        if (slot != entry)
+            slot = nullptr;
+    }
+    appendToJournal(RemoveOp, keyPayload(entryKey(entry->m_baseId, entry->m_relativePath)));
     return true;
 }
 
@@ -173,17 +598,23 @@ auto HttpMetaCache::evictEntry(MetaEntryPtr entry) -> bool
 auto HttpMetaCache::evictAll() -> bool
 {
     bool ret = true;
+    // everything is going away, so there is no point in keeping the index around
+    unmapIndex();
     for (QString& base : m_entries.keys()) {
         EntryMap& map = m_entries[base];
         qCDebug(taskHttpMetaCacheLogC) << "Evicting base" << base;
         for (MetaEntryPtr entry : map.entry_list) {
-            if (!evictEntry(entry))
-                qCWarning(taskHttpMetaCacheLogC) << "Unexpected missing cache entry" << entry->m_basePath;
+            if (entry)
+                entry->m_stale = true;
         }
         map.entry_list.clear();
         // AND all return codes together so the result is true iff all runs of deletePath() are true
         ret &= FS::deletePath(map.base_path);
     }
+    if (!m_index_file.isNull()) {
+        QFile::remove(indexPath());
+        openJournal(0);
+    }
     return ret;
 }
 
@@ -198,6 +629,12 @@ auto HttpMetaCache::staleEntry(QString base, QString resource_path) -> MetaEntry
     return MetaEntryPtr(foo);
 }
 
+void HttpMetaCache::dropEntry(const QString& base, const QString& resource_path)
+{
+    m_entries[base].entry_list[resource_path] = nullptr;
+    appendToJournal(RemoveOp, keyPayload(entryKey(base, resource_path)));
+}
+
 void HttpMetaCache::addBase(QString base, QString base_root)
 {
     // TODO: report error
@@ -219,14 +656,93 @@ auto HttpMetaCache::getBasePath(QString base) -> QString
     return {};
 }
 
-void HttpMetaCache::Load()
+auto HttpMetaCache::lookupIndex(const QString& base, const QString& resource_path) -> MetaEntryPtr
 {
-    if (m_index_file.isNull())
-        return;
+    if (!m_index_data)
+        return {};
+
+    const IndexView index{ reinterpret_cast<const char*>(m_index_data), m_index_size, m_index_count };
+    const auto key = entryKey(base, resource_path);
+
+    quint64 low = 0;
+    quint64 high = index.count;
+    while (low < high) {
+        const auto mid = low + (high - low) / 2;
+        ByteReader reader;
+        std::string_view record_key;
+        if (!index.recordAt(mid, reader) || !reader.readBytes(record_key)) {
+            qCWarning(taskHttpMetaCacheLogC) << "Corrupted record in cache index" << indexPath();
+            return {};
+        }
+
+        const auto cmp = record_key.compare(view(key));
+        if (cmp < 0) {
+            low = mid + 1;
+        } else if (cmp > 0) {
+            high = mid;
+        } else {
+            EntryRecord record;
+            if (!index.recordAt(mid, reader) || !readRecord(reader, record)) {
+                qCWarning(taskHttpMetaCacheLogC) << "Corrupted record in cache index" << indexPath();
+                return {};
+            }
+            auto entry = staleEntry(base, resource_path);
+            applyRecord(*entry, record);
+            return entry;
+        }
+    }
+    return {};
+}
+
+bool HttpMetaCache::mapIndex()
+{
+    m_index.setFileName(indexPath());
+    if (!m_index.open(QIODevice::ReadOnly))
+        return false;
+
+    const auto size = m_index.size();
+    auto data = size >= s_index_header_size ? m_index.map(0, size) : nullptr;
+    if (!data) {
+        m_index.close();
+        return false;
+    }
 
+    ByteReader header(reinterpret_cast<const char*>(data) + sizeof(s_index_magic), s_index_header_size - sizeof(s_index_magic));
+    quint32 version;
+    quint64 count;
+    if (std::memcmp(data, s_index_magic, sizeof(s_index_magic)) != 0 || !header.readInt(version) || version != s_index_version ||
+        !header.readInt(count) || count > static_cast<quint64>(size - s_index_header_size) / sizeof(quint64)) {
+        qCWarning(taskHttpMetaCacheLogC) << "Ignoring invalid cache index" << indexPath();
+        m_index.unmap(data);
+        m_index.close();
+        return false;
+    }
+
+    m_index_data = data;
+    m_index_size = size;
+    m_index_count = count;
+    return true;
+}
+
+void HttpMetaCache::unmapIndex()
+{
+    // the compaction reads from the mapped index
+    waitForCompaction();
+
+    if (m_index_data) {
+        m_index.unmap(m_index_data);
+        m_index_data = nullptr;
+        m_index_size = 0;
+        m_index_count = 0;
+    }
+    m_index.close();
+}
+
+bool HttpMetaCache::loadLegacyIndex()
+{
     QFile index(m_index_file);
     if (!index.open(QIODevice::ReadOnly))
-        return;
+        return false;
 
     QJsonParseError parseError;
     QJsonDocument json = QJsonDocument::fromJson(index.readAll(), &parseError);
@@ -236,13 +752,13 @@ void HttpMetaCache::Load()
         qCritical() << QString("Failed to parse HttpMetaCache file: %1 at offset %2")
                            .arg(parseError.errorString(), QString::number(parseError.offset))
                            .toUtf8();
-        return;
+        return false;
     }
 
     // Make sure the root is an object.
     if (!json.isObject()) {
         qCritical() << "HttpMetaCache root should be an object.";
-        return;
+        return false;
     }
 
     auto root = json.object();
@@ -250,7 +766,9 @@ void HttpMetaCache::Load()
     // check file version first
     auto version_val = root["version"].toString();
     if (version_val != "1")
-        return;
+        return false;
+
+    qCDebug(taskHttpMetaCacheLogC) << "Migrating JSON metacache" << m_index_file;
 
     // read the entry array
     auto array = root["entries"].toArray();
@@ -279,7 +797,126 @@ void HttpMetaCache::Load()
         // presumed innocent until closer examination
         foo->m_stale = false;
 
-        entrymap.entry_list[foo->m_relativePath] = MetaEntryPtr(foo);
+        // anything in the journal is newer than the legacy index
+        if (!entrymap.entry_list.contains(foo->m_relativePath))
+            entrymap.entry_list[foo->m_relativePath] = MetaEntryPtr(foo);
+        else
+            delete foo;
+    }
+    return true;
+}
+
+auto HttpMetaCache::replayJournal() -> qint64
+{
+    QFile journal(journalPath());
+    if (!journal.open(QIODevice::ReadOnly))
+        return 0;
+
+    const auto data = journal.readAll();
+    ByteReader header(data.constData() + sizeof(s_journal_magic), data.size() - static_cast<qint64>(sizeof(s_journal_magic)));
+    quint32 version;
+    if (data.size() < s_journal_header_size || std::memcmp(data.constData(), s_journal_magic, sizeof(s_journal_magic)) != 0 ||
+        !header.readInt(version) || version != s_journal_version) {
+        if (!data.isEmpty())
+            qCWarning(taskHttpMetaCacheLogC) << "Ignoring invalid cache journal" << journalPath();
+        return 0;
+    }
+
+    ByteReader reader(data.constData() + s_journal_header_size, data.size() - s_journal_header_size);
+    qint64 valid_size = s_journal_header_size;
+    int replayed = 0;
+
+    quint8 op;
+    std::string_view payload;
+    while (reader.readInt(op) && reader.readBytes(payload)) {
+        ByteReader payload_reader(payload.data(), static_cast<qint64>(payload.size()));
+        EntryRecord record;
+        if (op == UpdateOp) {
+            if (!readRecord(payload_reader, record))
+                break;
+        } else if (op == RemoveOp) {
+            std::string_view key;
+            if (!payload_reader.readBytes(key))
+                break;
+            record.key = toByteArray(key);
+            record.removed = true;
+        } else {
+            break;
+        }
+        valid_size = reader.position() - data.constData();
+
+        auto separator = record.key.indexOf('\0');
+        if (separator < 0)
+            continue;
+        auto base = QString::fromUtf8(record.key.left(separator));
+        auto resource_path = QString::fromUtf8(record.key.mid(separator + 1));
+        if (!m_entries.contains(base))
+            continue;
+
+        if (record.removed) {
+            m_entries[base].entry_list[resource_path] = nullptr;
+        } else {
+            auto entry = staleEntry(base, resource_path);
+            applyRecord(*entry, record);
+            m_entries[base].entry_list[resource_path] = entry;
+        }
+        replayed++;
+    }
+
+    if (valid_size != data.size())
+        qCWarning(taskHttpMetaCacheLogC) << "Discarding truncated tail of cache journal" << journalPath();
+    qCDebug(taskHttpMetaCacheLogC) << "Replayed" << replayed << "cache journal operations";
+    return valid_size;
+}
+
+void HttpMetaCache::openJournal(qint64 valid_size)
+{
+    if (m_journal.isOpen())
+        m_journal.close();
+
+    m_journal.setFileName(journalPath());
+    if (!m_journal.open(QIODevice::ReadWrite)) {
+        qCWarning(taskHttpMetaCacheLogC) << "Failed to open cache journal" << journalPath() << m_journal.errorString();
+        return;
+    }
+
+    if (valid_size < s_journal_header_size) {
+        m_journal.resize(0);
+        m_journal.seek(0);
+        QByteArray header(s_journal_magic, sizeof(s_journal_magic));
+        writeInt<quint32>(header, s_journal_version);
+        m_journal.write(header);
+    } else if (m_journal.size() != valid_size) {
+        m_journal.resize(valid_size);
+    }
+    m_journal.seek(m_journal.size());
+}
+
+void HttpMetaCache::appendToJournal(quint8 op, const QByteArray& payload)
+{
+    if (!m_journal.isOpen())
+        return;
+
+    QByteArray operation;
+    writeInt<quint8>(operation, op);
+    writeBytes(operation, payload);
+    m_journal.write(operation);
+    SaveEventually();
+}
+
+void HttpMetaCache::Load()
+{
+    if (m_index_file.isNull())
+        return;
+
+    const bool has_index = mapIndex();
+    openJournal(replayJournal());
+
+    if (!has_index && loadLegacyIndex()) {
+        // write the migrated entries out right away, so the JSON file is only ever parsed once
+        compact(false);
+        if (m_index_data)
+            QFile::remove(m_index_file);
     }
 }
 
@@ -292,44 +929,93 @@ void HttpMetaCache::SaveEventually()
 
 void HttpMetaCache::SaveNow()
 {
-    if (m_index_file.isNull())
+    if (m_index_file.isNull() || !m_journal.isOpen())
         return;
 
-    qCDebug(taskHttpMetaCacheLogC) << "Saving metacache with" << m_entries.size() << "entries";
-
-    QJsonObject toplevel;
-    Json::writeString(toplevel, "version", "1");
+    m_journal.flush();
+    if (m_journal.size() >= s_compaction_threshold) {
+        qCDebug(taskHttpMetaCacheLogC) << "Compacting metacache journal of" << m_journal.size() << "bytes";
+        compact(true);
+    }
+}
 
-    QJsonArray entriesArr;
-    for (auto group : m_entries) {
-        for (auto entry : group.entry_list) {
-            // do not save stale entries. they are dead.
-            if (entry->m_stale) {
-                continue;
-            }
+void HttpMetaCache::compact(bool background)
+{
+    if (m_index_file.isNull() || m_compaction_pending)
+        return;
 
-            QJsonObject entryObj;
-            Json::writeString(entryObj, "base", entry->m_baseId);
-            Json::writeString(entryObj, "path", entry->m_relativePath);
-            Json::writeString(entryObj, "md5sum", entry->m_md5sum);
-            Json::writeString(entryObj, "etag", entry->m_etag);
-            entryObj.insert("last_changed_timestamp", QJsonValue(double(entry->m_local_changed_timestamp)));
-            if (!entry->m_remote_changed_timestamp.isEmpty())
-                entryObj.insert("remote_changed_timestamp", QJsonValue(entry->m_remote_changed_timestamp));
-            if (entry->isEternal()) {
-                entryObj.insert("eternal", true);
+    // take a snapshot of everything that shadows the index. stale entries are dead, and don't get saved.
+    QList<EntryRecord> overlay;
+    QSet<QByteArray> bases;
+    for (auto base = m_entries.cbegin(); base != m_entries.cend(); ++base) {
+        bases.insert(base.key().toUtf8());
+        for (auto it = base->entry_list.cbegin(); it != base->entry_list.cend(); ++it) {
+            auto key = entryKey(base.key(), it.key());
+            if (!it.value() || it.value()->isStale()) {
+                EntryRecord record;
+                record.key = key;
+                record.removed = true;
+                overlay.append(record);
             } else {
-                entryObj.insert("current_age", QJsonValue(double(entry->m_current_age)));
-                entryObj.insert("max_age", QJsonValue(double(entry->m_max_age)));
+                overlay.append(makeRecord(key, *it.value()));
             }
-            entriesArr.append(entryObj);
         }
     }
-    toplevel.insert("entries", entriesArr);
 
-    try {
-        Json::write(toplevel, m_index_file);
-    } catch (const Exception& e) {
-        qCWarning(taskHttpMetaCacheLogC) << "Error writing cache:" << e.what();
+    // everything journaled up to here will be part of the new index
+    m_journal.flush();
+    m_compaction_journal_offset = m_journal.size();
+    m_compaction_pending = true;
+
+    const IndexView index{ reinterpret_cast<const char*>(m_index_data), m_index_size, m_index_count };
+    const auto path = indexPath() + ".new";
+    m_compaction_future = QtConcurrent::run(
+        [index, overlay = std::move(overlay), bases = std::move(bases), path]() mutable { return writeIndex(index, std::move(overlay), bases, path); });
+    m_compaction_watcher.setFuture(m_compaction_future);
+
+    if (!background)
+        waitForCompaction();
+}
+
+void HttpMetaCache::waitForCompaction()
+{
+    if (!m_compaction_pending)
+        return;
+    m_compaction_future.waitForFinished();
+    compactionFinished();
+}
+
+void HttpMetaCache::compactionFinished()
+{
+    // may have been handled already by waitForCompaction()
+    if (!m_compaction_pending)
+        return;
+    m_compaction_pending = false;
+
+    const auto new_index = indexPath() + ".new";
+    if (!m_compaction_future.result()) {
+        QFile::remove(new_index);
+        return;
+    }
+
+    // the old index can't be replaced while it is still mapped on all platforms
+    unmapIndex();
+    const bool replaced = FS::move(new_index, indexPath());
+    mapIndex();
+    if (!replaced) {
+        qCWarning(taskHttpMetaCacheLogC) << "Failed to replace cache index" << indexPath();
+        QFile::remove(new_index);
+        return;
+    }
+
+    // only keep the part of the journal that was written after the snapshot
+    QByteArray tail;
+    if (m_journal.isOpen()) {
+        m_journal.flush();
+        m_journal.seek(m_compaction_journal_offset);
+        tail = m_journal.readAll();
     }
+    openJournal(0);
+    if (m_journal.isOpen() && !tail.isEmpty())
+        m_journal.write(tail);
 }
@@ -35,9 +35,14 @@
 
 #pragma once
 
+#include <QFile>
+#include <QFileInfo>
+#include <QFuture>
+#include <QFutureWatcher>
 #include <QMap>
 #include <QString>
 #include <QTimer>
+#include <functional>
 #include <memory>
 
 class HttpMetaCache;
@@ -56,8 +61,13 @@ class MetaEntry {
 
     auto getRemoteChangedTimestamp() -> QString { return m_remote_changed_timestamp; }
     void setRemoteChangedTimestamp(QString remote_changed_timestamp) { m_remote_changed_timestamp = remote_changed_timestamp; }
+    auto getLocalChangedTimestamp() -> qint64 { return m_local_changed_timestamp; }
     void setLocalChangedTimestamp(qint64 timestamp) { m_local_changed_timestamp = timestamp; }
 
+    /* Size of the file when the entry was last validated, or -1 if it is unknown. */
+    auto getLocalSize() -> qint64 { return m_local_size; }
+    void setLocalSize(qint64 size) { m_local_size = size; }
+
     auto getETag() -> QString { return m_etag; }
     void setETag(QString etag) { m_etag = etag; }
 
@@ -84,6 +94,7 @@ class MetaEntry {
     QString m_etag;
 
     qint64 m_local_changed_timestamp = 0;
+    qint64 m_local_size = -1;
     QString m_remote_changed_timestamp;  // QString for now, RFC 2822 encoded time
     qint64 m_current_age = 0;
     qint64 m_max_age = 0;
@@ -94,6 +105,14 @@ class MetaEntry {
 
 using MetaEntryPtr = std::shared_ptr<MetaEntry>;
 
+/**
+ * The cache index is stored in two files next to the path given to the constructor:
+ *  - `<path>.idx`: an immutable, sorted binary index that is memory-mapped and searched lazily.
+ *  - `<path>.journal`: an append-only log of every update and eviction since the index was written.
+ *
+ * Entries are only materialized when they are asked for. Once the journal grows past a threshold, it is
+ * folded into a new index on a worker thread. A version "1" JSON index found at `<path>` is migrated on load.
+ */
 class HttpMetaCache : public QObject {
     Q_OBJECT
    public:
@@ -108,6 +127,11 @@ class HttpMetaCache : public QObject {
     // get the entry from cache and verify that it isn't stale (within reason)
     auto resolveEntry(QString base, QString resource_path, QString expected_etag = QString()) -> MetaEntryPtr;
 
+    // resolve many entries of a base at once, checking their files on worker threads without blocking the caller.
+    // `done` gets the entries in the order of `resource_paths`, on the thread of `context`, which has to be the cache's.
+    // it isn't called if `context` is destroyed first. entries updated in the meantime are returned as they are.
+    void resolveEntries(QString base, QStringList resource_paths, QObject* context, std::function<void(QList<MetaEntryPtr>)> done);
+
     // add a previously resolved stale entry
     auto updateEntry(MetaEntryPtr stale_entry) -> bool;
 
@@ -124,18 +148,88 @@ class HttpMetaCache : public QObject {
     auto getBasePath(QString base) -> QString;
 
    public slots:
+    // flush the journal, and compact it into the index in the background if it got too big
     void SaveNow();
 
+   private slots:
+    void compactionFinished();
+
    private:
+    // what is known about an entry's file, gathered without touching the entry itself
+    struct FileCheck {
+        QString resource_path;
+        QString real_path;
+        qint64 known_last_changed = 0;
+        qint64 known_size = -1;
+
+        bool present = false;
+        bool changed = false;
+        bool open_failed = false;
+        qint64 last_changed = 0;
+        qint64 size = 0;
+        QString md5sum;
+    };
+
+    // the checks of the files in one directory
+    struct DirectoryBatch {
+        QString path;
+        QList<FileCheck> checks;
+    };
+
+    // fill in a check from the file's info. safe to call from any thread.
+    static void checkFile(FileCheck& check, const QFileInfo& info);
+
+    // act on the outcome of resolveEntries()' file checks
+    auto applyFileChecks(const QString& base,
+                         const QStringList& resource_paths,
+                         const QList<MetaEntryPtr>& entries,
+                         const QList<DirectoryBatch>& batches) -> QList<MetaEntryPtr>;
+
+    // act on the outcome of a file check, returning either the validated entry or a stale one
+    auto applyFileCheck(const QString& base, MetaEntryPtr entry, const FileCheck& check) -> MetaEntryPtr;
+
     // create a new stale entry, given the parameters
     auto staleEntry(QString base, QString resource_path) -> MetaEntryPtr;
 
+    // forget about an entry, both in memory and on disk
+    void dropEntry(const QString& base, const QString& resource_path);
+
+    // find an entry in the memory-mapped index
+    auto lookupIndex(const QString& base, const QString& resource_path) -> MetaEntryPtr;
+
+    auto indexPath() const -> QString { return m_index_file + ".idx"; }
+    auto journalPath() const -> QString { return m_index_file + ".journal"; }
+
+    bool mapIndex();
+    void unmapIndex();
+    bool loadLegacyIndex();
+    auto replayJournal() -> qint64;
+    void openJournal(qint64 valid_size);
+    void appendToJournal(quint8 op, const QByteArray& payload);
+
+    // write a new index with the current state, either synchronously or on a worker thread
+    void compact(bool background);
+    void waitForCompaction();
+
     struct EntryMap {
         QString base_path;
+        // entries that were touched in this session, shadowing the index. null entries have been removed.
         QMap<QString, MetaEntryPtr> entry_list;
     };
 
     QMap<QString, EntryMap> m_entries;
     QString m_index_file;
     QTimer saveBatchingTimer;
+
+    QFile m_index;
+    uchar* m_index_data = nullptr;
+    qint64 m_index_size = 0;
+    quint64 m_index_count = 0;
+
+    QFile m_journal;
+
+    QFuture<bool> m_compaction_future;
+    QFutureWatcher<bool> m_compaction_watcher;
+    qint64 m_compaction_journal_offset = 0;
+    bool m_compaction_pending = false;
 };
@@ -89,6 +89,7 @@ Task::State MetaCacheSink::finalizeCache(QNetworkReply& reply)
     }
 
     m_entry->setLocalChangedTimestamp(output_file_info.lastModified().toUTC().toMSecsSinceEpoch());
+    m_entry->setLocalSize(output_file_info.size());
 
     {  // Cache lifetime
         if (m_is_eternal) {
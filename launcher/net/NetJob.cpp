@@ -37,6 +37,8 @@
 
 #include "NetJob.h"
 #include <QNetworkReply>
+#include <limits>
+#include "net/Logging.h"
 #include "net/NetRequest.h"
 #include "tasks/ConcurrentTask.h"
 #if defined(LAUNCHER_APPLICATION)
@@ -64,6 +66,16 @@ auto NetJob::addNetAction(Net::NetRequest::Ptr action) -> bool
     return true;
 }
 
+void NetJob::executeTask()
+{
+    m_hosts.clear();
+    m_hostOrder.clear();
+    m_running.clear();
+    m_scheduled = 0;
+    m_timer.start();
+    ConcurrentTask::executeTask();
+}
+
 void NetJob::executeNextSubTask()
 {
     // We're finished, check for failures and retry if we can (up to 3 times)
@@ -75,7 +87,132 @@ void NetJob::executeNextSubTask()
             m_queue.enqueue(task);
         }
     }
-    ConcurrentTask::executeNextSubTask();
+    if (!isRunning() || m_queue.isEmpty()) {
+        ConcurrentTask::executeNextSubTask();
+        return;
+    }
+
+    scheduleQueued();
+    while (m_doing.count() < m_total_max_size) {
+        auto next = takeNextRequest();
+        if (!next)
+            break;
+        auto* request = static_cast<Net::NetRequest*>(next.get());
+        auto origin = originOf(request->url());
+        auto& host = m_hosts[origin];
+        host.running++;
+        if (host.firstStart < 0)
+            host.firstStart = m_timer.elapsed();
+        m_running.insert(next.get(), { origin, request->bytesReceived() });
+
+        // connected ahead of startSubTask(), whose handlers disconnect everything from the finished task
+        auto* task = next.get();
+        connect(task, &Task::succeeded, this, [this, task] { requestFinished(task); });
+        connect(task, &Task::failed, this, [this, task] { requestFinished(task); });
+        connect(task, &Task::aborted, this, [this, task] { requestFinished(task); });
+        startSubTask(next);
+    }
+}
+
+QString NetJob::originOf(const QUrl& url)
+{
+    return url.adjusted(QUrl::RemoveUserInfo | QUrl::RemovePath | QUrl::RemoveQuery | QUrl::RemoveFragment).toString();
+}
+
+void NetJob::scheduleQueued()
+{
+    // the queue only changes behind our back when requests are added or retried, so sorting it again is rare
+    if (m_scheduled == m_queue.size())
+        return;
+    for (auto& host : m_hosts)
+        host.queued.clear();
+    for (const auto& task : std::as_const(m_queue)) {
+        auto* request = static_cast<Net::NetRequest*>(task.get());
+        auto origin = originOf(request->url());
+        if (!m_hosts.contains(origin))
+            m_hostOrder.append(origin);
+        auto size = request->expectedSize();
+        m_hosts[origin].queued.emplace(size < 0 ? std::numeric_limits<qint64>::max() : size, task);
+    }
+    m_scheduled = m_queue.size();
+}
+
+Task::Ptr NetJob::takeNextRequest()
+{
+    // round robin over the origins below their limit
+    qsizetype waiting = 0;
+    qsizetype lastWaiting = -1;
+    for (qsizetype i = 0; i < m_hostOrder.size(); i++) {
+        const auto index = (m_nextHost + i) % m_hostOrder.size();
+        const auto& origin = m_hostOrder[index];
+        auto& host = m_hosts[origin];
+        if (host.queued.empty())
+            continue;
+        waiting++;
+        lastWaiting = index;
+        const int limit = m_hostLimits.value(origin, m_maxPerHost);
+        if (limit > 0 && host.running >= limit)
+            continue;
+        return takeFromHost(index);
+    }
+    // an origin may only go over its limit when nobody else is waiting for the slot
+    if (waiting == 1)
+        return takeFromHost(lastWaiting);
+    return nullptr;
+}
+
+Task::Ptr NetJob::takeFromHost(qsizetype index)
+{
+    auto& host = m_hosts[m_hostOrder[index]];
+    m_nextHost = index + 1;
+    auto task = host.queued.begin()->second;
+    host.queued.erase(host.queued.begin());
+    m_queue.removeOne(task);
+    m_scheduled--;
+    return task;
+}
+
+void NetJob::requestFinished(Task* task)
+{
+    auto it = m_running.find(task);
+    if (it == m_running.end())
+        return;
+    auto* request = static_cast<Net::NetRequest*>(task);
+    auto& host = m_hosts[it->origin];
+    host.running--;
+    host.stats.requests++;
+    if (request->usedHttp2())
+        host.stats.http2Requests++;
+    host.stats.bytes += request->bytesReceived() - it->bytesAtStart;
+    host.stats.elapsedMsecs = m_timer.elapsed() - host.firstStart;
+    m_running.erase(it);
+}
+
+auto NetJob::hostStats() const -> QList<HostStats>
+{
+    QList<HostStats> stats;
+    for (const auto& origin : m_hostOrder) {
+        auto hostStats = m_hosts[origin].stats;
+        hostStats.origin = origin;
+        stats.append(hostStats);
+    }
+    return stats;
+}
+
+void NetJob::logHostStats() const
+{
+    for (const auto& stats : hostStats()) {
+        qCDebug(taskNetLogC).nospace() << objectName() << ": " << stats.origin << " - " << stats.requests << " requests ("
+                                       << stats.http2Requests << " over HTTP/2), " << stats.bytes << " bytes in " << stats.elapsedMsecs
+                                       << " ms, " << stats.requestsPerSecond() << " requests/s, " << qint64(stats.bytesPerSecond())
+                                       << " bytes/s";
+    }
+}
+
+void NetJob::emitSucceeded()
+{
+    logHostStats();
+    ConcurrentTask::emitSucceeded();
 }
 
 auto NetJob::size() const -> int
@@ -106,6 +243,9 @@ auto NetJob::abort() -> bool
     for (auto task : m_queue)
         m_failed.insert(task.get(), task);
     m_queue.clear();
+    for (auto& host : m_hosts)
+        host.queued.clear();
+    m_scheduled = 0;
 
     // abort active downloads
     auto toKill = m_doing.values();
@@ -181,6 +321,7 @@ void NetJob::emitFailed(QString reason)
         }
     }
 #endif
+    logHostStats();
     ConcurrentTask::emitFailed(reason);
 }
 
@@ -38,7 +38,9 @@
 
 #include <QtNetwork>
 
+#include <QElapsedTimer>
 #include <QObject>
+#include <map>
 #include "net/NetRequest.h"
 #include "tasks/ConcurrentTask.h"
 
@@ -52,6 +54,18 @@ class NetJob : public ConcurrentTask {
    public:
     using Ptr = shared_qobject_ptr<NetJob>;
 
+    struct HostStats {
+        QString origin;
+        int requests = 0;
+        int http2Requests = 0;
+        qint64 bytes = 0;
+        // from the first of its requests starting to the last one finishing
+        qint64 elapsedMsecs = 0;
+
+        double requestsPerSecond() const { return elapsedMsecs > 0 ? requests * 1000.0 / elapsedMsecs : 0; }
+        double bytesPerSecond() const { return elapsedMsecs > 0 ? bytes * 1000.0 / elapsedMsecs : 0; }
+    };
+
     explicit NetJob(QString job_name, shared_qobject_ptr<QNetworkAccessManager> network, int max_concurrent = -1);
     ~NetJob() override = default;
 
@@ -64,21 +78,62 @@ class NetJob : public ConcurrentTask {
     auto getFailedFiles() -> QList<QString>;
     void setAskRetry(bool askRetry);
 
+    /**
+     * Limits how many requests run against the same origin.
+     * An origin only goes over its limit when no other origin has requests waiting, so that no slot of the job stays empty.
+     */
+    void setMaxConcurrentPerHost(int max) { m_maxPerHost = max; }
+    void setHostLimit(const QString& origin, int max) { m_hostLimits.insert(origin, max); }
+
+    QList<HostStats> hostStats() const;
+
    public slots:
     // Qt can't handle auto at the start for some reason?
     bool abort() override;
     void emitFailed(QString reason) override;
 
    protected slots:
+    void executeTask() override;
     void executeNextSubTask() override;
 
    protected:
+    void emitSucceeded() override;
     void updateState() override;
     bool isOnline();
 
    private:
+    struct Host {
+        // by expected size, so small files go first. unknown sizes go last, in the order they were added
+        std::multimap<qint64, Task::Ptr> queued;
+        int running = 0;
+        qint64 firstStart = -1;
+        HostStats stats;
+    };
+    struct Running {
+        QString origin;
+        qint64 bytesAtStart;
+    };
+
+    static QString originOf(const QUrl& url);
+    void scheduleQueued();
+    Task::Ptr takeNextRequest();
+    Task::Ptr takeFromHost(qsizetype index);
+    void requestFinished(Task* task);
+    void logHostStats() const;
+
     shared_qobject_ptr<QNetworkAccessManager> m_network;
 
+    // enough to hide the latency of one origin, without a single one taking all the slots while others wait
+    static constexpr int s_defaultMaxPerHost = 4;
+    int m_maxPerHost = s_defaultMaxPerHost;
+    QHash<QString, int> m_hostLimits;
+    QHash<QString, Host> m_hosts;
+    QStringList m_hostOrder;
+    qsizetype m_nextHost = 0;
+    qsizetype m_scheduled = 0;
+    QHash<Task*, Running> m_running;
+    QElapsedTimer m_timer;
+
     int m_try = 1;
     bool m_ask_retry = true;
     int m_manual_try = 0;
@@ -43,6 +43,7 @@
 #include <QFileInfo>
 #include <QNetworkReply>
 #include <QUrl>
+#include <algorithm>
 #include <memory>
 
 #if defined(LAUNCHER_APPLICATION)
@@ -55,6 +56,10 @@
 
 namespace Net {
 
+namespace {
+constexpr qint64 s_segmentCount = 4;
+}  // namespace
+
 void NetRequest::addValidator(Validator* v)
 {
     m_sink->addValidator(v);
@@ -71,6 +76,8 @@ void NetRequest::executeTask()
         return;
     }
 
+    cancelSegments();
+
     QNetworkRequest request(m_url);
     m_state = m_sink->init(request);
     switch (m_state) {
@@ -94,26 +101,30 @@ void NetRequest::executeTask()
             return;
     }
 
-#if defined(LAUNCHER_APPLICATION)
-    auto user_agent = APPLICATION->getUserAgent();
-#else
     auto user_agent = BuildConfig.USER_AGENT;
+#if defined(LAUNCHER_APPLICATION)
+    if (APPLICATION_DYN)
+        user_agent = APPLICATION->getUserAgent();
 #endif
 
     request.setHeader(QNetworkRequest::UserAgentHeader, user_agent.toUtf8());
+    // lets many small requests to the same host share one connection
+    request.setAttribute(QNetworkRequest::Http2AllowedAttribute, true);
     for (auto& header_proxy : m_headerProxies) {
         header_proxy->writeHeaders(request);
     }
 
 #if defined(LAUNCHER_APPLICATION)
-    request.setTransferTimeout(APPLICATION->settings()->get("RequestTimeout").toInt() * 1000);
-#else
-    request.setTransferTimeout();
+    if (APPLICATION_DYN)
+        request.setTransferTimeout(APPLICATION->settings()->get("RequestTimeout").toInt() * 1000);
+    else
 #endif
+        request.setTransferTimeout();
 
     m_last_progress_time = m_clock.now();
     m_last_progress_bytes = 0;
 
+    m_headersHandled = false;
     auto rep = getReply(request);
     if (rep == nullptr)  // it failed
         return;
@@ -245,6 +256,11 @@ auto NetRequest::handleRedirect() -> bool
 
 void NetRequest::downloadFinished()
 {
+    if (!m_segments.empty()) {
+        segmentFinished(0);
+        return;
+    }
+
     // handle HTTP redirection first
     if (handleRedirect()) {
         qCDebug(logCat) << getUid().toString() << "Request redirected:" << m_url.toString();
@@ -261,6 +277,11 @@ void NetRequest::downloadFinished()
         return;
     } else if (m_state == State::Failed) {
         qCDebug(logCat) << getUid().toString() << "Request failed in previous step:" << m_url.toString();
+        // an error without a body never got to the sink, which may need the status to decide what to keep (e.g. 416)
+        if (!m_headersHandled && replyStatusCode() > 0) {
+            m_headersHandled = true;
+            m_sink->headersReceived(*m_reply);
+        }
         m_sink->abort();
         m_failReason = m_reply->errorString();
         emit failed(m_reply->errorString());
@@ -274,8 +295,18 @@ void NetRequest::downloadFinished()
         return;
     }
 
+    if (!handleHeaders()) {
+        qCDebug(logCat) << getUid().toString() << "Request failed to handle the response:" << m_url.toString();
+        m_sink->abort();
+        m_failReason = m_sink->failReason();
+        emit failed(m_sink->failReason());
+        emit finished();
+        return;
+    }
+
     // make sure we got all the remaining data, if any
     auto data = m_reply->readAll();
+    m_bytesReceived += data.size();
     if (data.size()) {
         qCDebug(logCat) << getUid().toString() << "Writing extra" << data.size() << "bytes";
         m_state = m_sink->write(data);
@@ -305,10 +336,195 @@ void NetRequest::downloadFinished()
     emit finished();
 }
 
+bool NetRequest::handleHeaders()
+{
+    if (m_headersHandled)
+        return m_state != State::Failed;
+    m_headersHandled = true;
+    if (m_sink->headersReceived(*m_reply) == State::Failed) {
+        m_state = State::Failed;
+        return false;
+    }
+    if (m_options & Option::Segmented)
+        startSegments();
+    return m_state != State::Failed;
+}
+
+bool NetRequest::startSegments()
+{
+    if (!m_reply->isRunning() || replyStatusCode() != 200)
+        return false;
+    const auto size = m_reply->header(QNetworkRequest::ContentLengthHeader).toLongLong();
+    if (size < m_segmentThreshold || m_reply->rawHeader("Accept-Ranges").trimmed().toLower() != "bytes" ||
+        m_reply->hasRawHeader("Content-Encoding"))
+        return false;
+    // without a strong validator the ranges could come from different versions of the file
+    auto validator = m_reply->rawHeader("ETag");
+    if (validator.isEmpty() || validator.startsWith("W/"))
+        validator = m_reply->rawHeader("Last-Modified");
+    if (validator.isEmpty() || !m_sink->beginSegments(size))
+        return false;
+
+    m_segmentedSize = size;
+    m_segments.resize(s_segmentCount);
+    const auto segmentSize = (size + s_segmentCount - 1) / s_segmentCount;
+    for (size_t i = 0; i < m_segments.size(); i++) {
+        m_segments[i].start = static_cast<qint64>(i) * segmentSize;
+        m_segments[i].end = std::min(size, m_segments[i].start + segmentSize);
+    }
+    // the main reply carries on as the first segment, progress is counted over all of them
+    disconnect(m_reply.get(), &QNetworkReply::downloadProgress, this, &NetRequest::onProgress);
+    qCDebug(logCat) << getUid().toString() << "Downloading" << size << "bytes in" << m_segments.size() << "segments:" << m_url.toString();
+
+    auto request = m_reply->request();
+    request.setUrl(m_reply->url());
+    request.setRawHeader("If-None-Match", {});
+    request.setRawHeader("If-Modified-Since", {});
+    request.setRawHeader("If-Range", validator);
+    // HTTP/2 would put all of the ranges on the same connection
+    request.setAttribute(QNetworkRequest::Http2AllowedAttribute, false);
+    for (size_t i = 1; i < m_segments.size(); i++) {
+        auto& segment = m_segments[i];
+        request.setRawHeader("Range", "bytes=" + QByteArray::number(segment.start) + "-" + QByteArray::number(segment.end - 1));
+        auto rep = getReply(request);
+        if (rep == nullptr) {
+            failSegments(tr("Failed to request a segment"));
+            return false;
+        }
+        segment.reply.reset(rep);
+        connect(rep, &QNetworkReply::readyRead, this, [this, i] { segmentReadyRead(i); });
+        connect(rep, &QNetworkReply::finished, this, [this, i] { segmentFinished(i); });
+        connect(rep, &QNetworkReply::sslErrors, this, &NetRequest::sslErrors);
+    }
+    return true;
+}
+
+bool NetRequest::writeSegment(size_t index, QNetworkReply* reply)
+{
+    auto& segment = m_segments[index];
+    if (index > 0 && segment.written == 0) {
+        // anything but the exact range asked for means the file changed, or the server doesn't really do ranges
+        const auto range = "bytes " + QByteArray::number(segment.start) + "-" + QByteArray::number(segment.end - 1) + "/";
+        if (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() != 206 ||
+            !reply->rawHeader("Content-Range").startsWith(range)) {
+            failSegments(tr("Server did not send the requested range"));
+            return false;
+        }
+    }
+
+    auto data = reply->read(segment.end - segment.start - segment.written);
+    if (data.isEmpty())
+        return true;
+    m_bytesReceived += data.size();
+    if (m_sink->writeAt(segment.start + segment.written, data) != State::Running) {
+        failSegments(m_sink->failReason());
+        return false;
+    }
+    segment.written += data.size();
+
+    qint64 written = 0;
+    for (auto& other : m_segments)
+        written += other.written;
+    onProgress(written, m_segmentedSize);
+    return true;
+}
+
+void NetRequest::segmentReadyRead(size_t index)
+{
+    auto reply = index == 0 ? m_reply.get() : m_segments[index].reply.get();
+    if (!writeSegment(index, reply))
+        return;
+    auto& segment = m_segments[index];
+    if (index == 0 && segment.written == segment.end - segment.start) {
+        // the rest of the main response is covered by the other segments
+        disconnect(m_reply.get(), nullptr, this, nullptr);
+        m_reply->abort();
+        finishSegments();
+    }
+}
+
+void NetRequest::segmentFinished(size_t index)
+{
+    auto reply = index == 0 ? m_reply.get() : m_segments[index].reply.get();
+    if (reply->error() != QNetworkReply::NoError) {
+        failSegments(reply->errorString());
+        return;
+    }
+    if (!writeSegment(index, reply))
+        return;
+    auto& segment = m_segments[index];
+    if (segment.written != segment.end - segment.start) {
+        failSegments(tr("Segment ended after %1 of %2 bytes").arg(segment.written).arg(segment.end - segment.start));
+        return;
+    }
+    finishSegments();
+}
+
+void NetRequest::finishSegments()
+{
+    for (auto& segment : m_segments) {
+        if (segment.written != segment.end - segment.start)
+            return;
+    }
+    cancelSegments();
+
+    m_state = m_sink->finalize(*m_reply.get());
+    if (m_state != State::Succeeded) {
+        qCDebug(logCat) << getUid().toString() << "Request failed to finalize:" << m_url.toString();
+        m_sink->abort();
+        m_failReason = m_sink->failReason();
+        emit failed(m_sink->failReason());
+        emit finished();
+        return;
+    }
+
+    qCDebug(logCat) << getUid().toString() << "Request succeeded:" << m_url.toString();
+    emit succeeded();
+    emit finished();
+}
+
+void NetRequest::failSegments(const QString& reason)
+{
+    qCCritical(logCat) << getUid().toString() << "Segmented request failed:" << m_url.toString() << reason;
+    cancelSegments();
+    m_sink->abort();
+    m_state = State::Failed;
+    m_failReason = reason;
+    emit failed(reason);
+    emit finished();
+}
+
+void NetRequest::cancelSegments()
+{
+    if (m_segments.empty())
+        return;
+    for (auto& segment : m_segments) {
+        if (segment.reply) {
+            disconnect(segment.reply.get(), nullptr, this, nullptr);
+            segment.reply->abort();
+        }
+    }
+    if (m_reply) {
+        disconnect(m_reply.get(), nullptr, this, nullptr);
+        m_reply->abort();
+    }
+    m_segments.clear();
+    m_segmentedSize = 0;
+}
+
 void NetRequest::downloadReadyRead()
 {
     if (m_state == State::Running) {
+        if (!handleHeaders()) {
+            qCCritical(logCat) << getUid().toString() << "Failed to handle the response:" << m_sink->failReason();
+            return;
+        }
+        if (!m_segments.empty()) {
+            segmentReadyRead(0);
+            return;
+        }
         auto data = m_reply->readAll();
+        m_bytesReceived += data.size();
         m_state = m_sink->write(data);
         if (replyStatusCode() >= 400) {
             m_errorResponse.append(data);
@@ -325,6 +541,13 @@ void NetRequest::downloadReadyRead()
 auto NetRequest::abort() -> bool
 {
     m_state = State::AbortedByUser;
+    if (!m_segments.empty()) {
+        cancelSegments();
+        m_sink->abort();
+        emit aborted();
+        emit finished();
+        return true;
+    }
     if (m_reply) {
         disconnect(m_reply.get(), &QNetworkReply::errorOccurred, nullptr, nullptr);
         m_reply->abort();
@@ -342,6 +565,11 @@ QNetworkReply::NetworkError NetRequest::error() const
     return m_reply ? m_reply->error() : QNetworkReply::NoError;
 }
 
+bool NetRequest::usedHttp2() const
+{
+    return m_reply && m_reply->attribute(QNetworkRequest::Http2WasUsedAttribute).toBool();
+}
+
 QUrl NetRequest::url() const
 {
     return m_url;
@@ -54,12 +54,16 @@
 namespace Net {
 class NetRequest : public Task {
     Q_OBJECT
+    // read by TaskTrace
+    Q_PROPERTY(QUrl url READ url)
+    Q_PROPERTY(qint64 bytesReceived READ bytesReceived)
    protected:
     explicit NetRequest() : Task() {}
 
    public:
     using Ptr = shared_qobject_ptr<class NetRequest>;
-    enum class Option { NoOptions = 0, AcceptLocalFiles = 1, MakeEternal = 2 };
+    /** Segmented: large responses from servers that accept ranges are fetched over several connections at once. */
+    enum class Option { NoOptions = 0, AcceptLocalFiles = 1, MakeEternal = 2, UseContentStore = 4, Segmented = 8 };
     Q_DECLARE_FLAGS(Options, Option)
 
    public:
@@ -77,8 +81,25 @@ class NetRequest : public Task {
     QNetworkReply::NetworkError error() const;
     QString errorString() const;
 
+    /** Size of the response when it is known up front, so that small files can be scheduled first. -1 if unknown. */
+    void setExpectedSize(qint64 size) { m_expectedSize = size; }
+    qint64 expectedSize() const { return m_expectedSize; }
+    /** Bytes received over the network so far, over all attempts. */
+    qint64 bytesReceived() const { return m_bytesReceived; }
+    bool usedHttp2() const;
+    /** Smallest response that is split into segments, when the Segmented option is set. */
+    void setSegmentThreshold(qint64 size) { m_segmentThreshold = size; }
+
    private:
     auto handleRedirect() -> bool;
+    bool handleHeaders();
+    bool startSegments();
+    bool writeSegment(size_t index, QNetworkReply* reply);
+    void segmentReadyRead(size_t index);
+    void segmentFinished(size_t index);
+    void finishSegments();
+    void failSegments(const QString& reason);
+    void cancelSegments();
     virtual QNetworkReply* getReply(QNetworkRequest&) = 0;
 
    protected slots:
@@ -108,6 +129,22 @@ class NetRequest : public Task {
 
     /// source URL
     QUrl m_url;
+    qint64 m_expectedSize = -1;
+    qint64 m_bytesReceived = 0;
+    bool m_headersHandled = false;
+
+    /// byte ranges of a segmented download. the first one is carried by m_reply
+    struct Segment {
+        qint64 start = 0;
+        qint64 end = 0;  // exclusive
+        qint64 written = 0;
+        shared_qobject_ptr<QNetworkReply> reply;
+    };
+    std::vector<Segment> m_segments;
+    qint64 m_segmentedSize = 0;
+    // below this, a single connection is as fast as several once the handshakes are counted in
+    qint64 m_segmentThreshold = 32 * 1024 * 1024;
+
     std::vector<std::shared_ptr<Net::HeaderProxy>> m_headerProxies;
 };
 }  // namespace Net
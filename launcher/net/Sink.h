@@ -49,6 +49,11 @@ class Sink {
     virtual auto write(QByteArray& data) -> Task::State = 0;
     virtual auto abort() -> Task::State = 0;
     virtual auto finalize(QNetworkReply& reply) -> Task::State = 0;
+    // called once per reply, before its first data is written
+    virtual auto headersReceived(QNetworkReply&) -> Task::State { return Task::State::Running; }
+    // switches to writing a response of the given size in ranges, in any order. false if the sink can't do that
+    virtual auto beginSegments(qint64) -> bool { return false; }
+    virtual auto writeAt(qint64, QByteArray&) -> Task::State { return Task::State::Failed; }
 
     virtual auto hasLocalData() -> bool = 0;
 
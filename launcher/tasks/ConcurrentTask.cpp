@@ -37,6 +37,7 @@
 
 #include <QDebug>
 #include "tasks/Task.h"
+#include "tasks/TaskTrace.h"
 
 ConcurrentTask::ConcurrentTask(QString task_name, int max_concurrent) : Task(), m_total_max_size(max_concurrent)
 {
@@ -58,6 +59,7 @@ auto ConcurrentTask::getStepProgress() const -> TaskStepProgressList
 
 void ConcurrentTask::addTask(Task::Ptr task)
 {
+    TaskTrace::subTaskQueued(this, task.get());
     m_queue.append(task);
 }
 
@@ -168,6 +170,7 @@ void ConcurrentTask::startSubTask(Task::Ptr next)
 
     updateState();
 
+    TaskTrace::subTaskQueued(this, next.get());
     QMetaObject::invokeMethod(next.get(), &Task::start, Qt::QueuedConnection);
 }
 
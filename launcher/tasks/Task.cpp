@@ -35,6 +35,7 @@
  */
 
 #include "Task.h"
+#include "TaskTrace.h"
 
 #include <QDebug>
 
@@ -44,6 +45,12 @@ Task::Task(bool show_debug) : m_show_debug(show_debug)
 {
     m_uid = QUuid::createUuid();
     setAutoDelete(false);
+    TaskTrace::taskCreated(this);
+}
+
+Task::~Task()
+{
+    TaskTrace::taskDestroyed(this);
 }
 
 void Task::setStatus(const QString& new_status)
@@ -103,6 +110,7 @@ void Task::start()
     }
     // NOTE: only fall through to here in end states
     m_state = State::Running;
+    auto trace = TaskTrace::taskStarted(this);
     emit started();
     executeTask();
 }
@@ -116,6 +124,7 @@ void Task::emitFailed(QString reason)
     }
     m_state = State::Failed;
     m_failReason = reason;
+    auto trace = TaskTrace::taskFinished(this);
     qCCritical(taskLogC) << "Task" << describe() << "failed: " << reason;
     emit failed(reason);
     emit finished();
@@ -130,6 +139,7 @@ void Task::emitAborted()
     }
     m_state = State::AbortedByUser;
     m_failReason = "Aborted.";
+    auto trace = TaskTrace::taskFinished(this);
     if (m_show_debug)
         qCDebug(taskLogC) << "Task" << describe() << "aborted.";
     emit aborted();
@@ -144,6 +154,7 @@ void Task::emitSucceeded()
         return;
     }
     m_state = State::Succeeded;
+    auto trace = TaskTrace::taskFinished(this);
     if (m_show_debug)
         qCDebug(taskLogC) << "Task" << describe() << "succeeded";
     emit succeeded();
@@ -0,0 +1,424 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  Prism Launcher - Minecraft Launcher
+ *  Copyright (c) 2026 Prism Launcher Contributors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "TaskTrace.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMap>
+#include <QMutexLocker>
+#include <QSet>
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+
+#include "StringUtils.h"
+
+namespace {
+std::atomic<int> s_traceCount = 0;
+QMutex s_tracesLock;
+QList<TaskTrace*> s_traces;
+// the task starting or finishing on this thread
+thread_local QUuid s_currentTask;
+
+QString stateName(Task::State state)
+{
+    switch (state) {
+        case Task::State::Inactive:
+            return QStringLiteral("inactive");
+        case Task::State::Running:
+            return QStringLiteral("running");
+        case Task::State::Succeeded:
+            return QStringLiteral("succeeded");
+        case Task::State::Failed:
+            return QStringLiteral("failed");
+        case Task::State::AbortedByUser:
+            return QStringLiteral("aborted");
+    }
+    return {};
+}
+
+QString taskName(Task* task)
+{
+    if (auto name = task->objectName(); !name.isEmpty())
+        return name;
+    if (auto url = task->property("url"); url.isValid())
+        return url.toUrl().toDisplayString();
+    return task->metaObject()->className();
+}
+
+QString formatDuration(qint64 usecs)
+{
+    if (usecs < 1000 * 1000)
+        return QStringLiteral("%1 ms").arg(usecs / 1000);
+    return QStringLiteral("%1 s").arg(usecs / (1000.0 * 1000.0), 0, 'f', 2);
+}
+}  // namespace
+
+qint64 TaskTrace::Span::queueWait() const
+{
+    const auto since = queued >= 0 ? queued : created;
+    return since >= 0 && start >= 0 ? start - since : -1;
+}
+
+TaskTrace::Scope::Scope(QUuid current) : m_previous(std::exchange(s_currentTask, current)), m_active(true) {}
+
+TaskTrace::Scope::~Scope()
+{
+    if (m_active)
+        s_currentTask = m_previous;
+}
+
+TaskTrace::TaskTrace()
+{
+    m_timer.start();
+    QMutexLocker locker(&s_tracesLock);
+    s_traces.append(this);
+    s_traceCount++;
+}
+
+TaskTrace::~TaskTrace()
+{
+    stop();
+}
+
+void TaskTrace::stop()
+{
+    {
+        QMutexLocker locker(&s_tracesLock);
+        if (s_traces.removeOne(this))
+            s_traceCount--;
+    }
+    QMutexLocker locker(&m_lock);
+    m_recording = false;
+}
+
+bool TaskTrace::isRecording() const
+{
+    QMutexLocker locker(&m_lock);
+    return m_recording;
+}
+
+qint64 TaskTrace::elapsed() const
+{
+    return m_timer.nsecsElapsed() / 1000;
+}
+
+void TaskTrace::mark(const QString& name)
+{
+    QMutexLocker locker(&m_lock);
+    if (m_recording)
+        m_marks.append({ name, elapsed() });
+}
+
+QList<TaskTrace::Span> TaskTrace::spans() const
+{
+    QMutexLocker locker(&m_lock);
+    return m_spans;
+}
+
+QList<TaskTrace::Mark> TaskTrace::marks() const
+{
+    QMutexLocker locker(&m_lock);
+    return m_marks;
+}
+
+void TaskTrace::taskCreated(Task* task)
+{
+    if (s_traceCount.load(std::memory_order_relaxed) == 0)
+        return;
+    QMutexLocker locker(&s_tracesLock);
+    for (auto trace : s_traces) {
+        QMutexLocker traceLocker(&trace->m_lock);
+        trace->m_pending[task->getUid()].created = trace->elapsed();
+    }
+}
+
+void TaskTrace::taskDestroyed(Task* task)
+{
+    if (s_traceCount.load(std::memory_order_relaxed) == 0)
+        return;
+    QMutexLocker locker(&s_tracesLock);
+    for (auto trace : s_traces) {
+        QMutexLocker traceLocker(&trace->m_lock);
+        trace->m_pending.remove(task->getUid());
+    }
+}
+
+TaskTrace::Scope TaskTrace::taskStarted(Task* task)
+{
+    if (s_traceCount.load(std::memory_order_relaxed) == 0)
+        return {};
+    bool added = false;
+    {
+        QMutexLocker locker(&s_tracesLock);
+        for (auto trace : s_traces)
+            added |= trace->onStarted(task, s_currentTask);
+    }
+    if (added) {
+        // some tasks, like NetRequest, emit finished() themselves instead of going through emitSucceeded() and co.
+        QObject::connect(task, &Task::finished, task, [task] { TaskTrace::taskFinished(task); }, Qt::DirectConnection);
+    }
+    return Scope(task->getUid());
+}
+
+TaskTrace::Scope TaskTrace::taskFinished(Task* task)
+{
+    if (s_traceCount.load(std::memory_order_relaxed) == 0)
+        return {};
+    QUuid parent;
+    {
+        QMutexLocker locker(&s_tracesLock);
+        for (auto trace : s_traces) {
+            if (auto recorded = trace->onFinished(task); !recorded.isNull())
+                parent = recorded;
+        }
+    }
+    // whatever the parent starts next on its behalf is its child, not a sibling of this one
+    return Scope(parent);
+}
+
+void TaskTrace::subTaskQueued(Task* parent, Task* child)
+{
+    if (s_traceCount.load(std::memory_order_relaxed) == 0)
+        return;
+    QMutexLocker locker(&s_tracesLock);
+    for (auto trace : s_traces) {
+        QMutexLocker traceLocker(&trace->m_lock);
+        auto& pending = trace->m_pending[child->getUid()];
+        pending.parent = parent->getUid();
+        // queued once, started later; the first time is when it started waiting
+        if (pending.queued < 0)
+            pending.queued = trace->elapsed();
+    }
+}
+
+TaskTrace::Span& TaskTrace::spanFor(const QUuid& uid, bool* added)
+{
+    if (auto index = m_index.value(uid, -1); index >= 0)
+        return m_spans[index];
+    if (added)
+        *added = true;
+    m_index.insert(uid, m_spans.size());
+    auto& span = m_spans.emplace_back();
+    span.uid = uid;
+    return span;
+}
+
+bool TaskTrace::onStarted(Task* task, const QUuid& current)
+{
+    QMutexLocker locker(&m_lock);
+    const auto uid = task->getUid();
+    const auto pending = m_pending.take(uid);
+    bool added = false;
+    auto& span = spanFor(uid, &added);
+    span.type = task->metaObject()->className();
+    span.name = taskName(task);
+    if (added || !pending.parent.isNull())
+        span.parent = pending.parent.isNull() ? current : pending.parent;
+    if (pending.created >= 0)
+        span.created = pending.created;
+    span.queued = pending.queued;
+    span.start = elapsed();
+    span.end = -1;
+    span.state = Task::State::Running;
+    span.failReason.clear();
+    return added;
+}
+
+QUuid TaskTrace::onFinished(Task* task)
+{
+    QMutexLocker locker(&m_lock);
+    const auto index = m_index.value(task->getUid(), -1);
+    if (index < 0)
+        return {};
+    auto& span = m_spans[index];
+    // the task may report its end more than once, the first time counts
+    if (span.end < 0) {
+        span.end = elapsed();
+        span.state = task->getState();
+        span.failReason = task->failReason();
+        if (auto bytes = task->property("bytesReceived"); bytes.isValid())
+            span.bytes = bytes.toLongLong();
+    }
+    return span.parent;
+}
+
+QByteArray TaskTrace::toChromeTrace(const QString& title) const
+{
+    QMutexLocker locker(&m_lock);
+    const auto now = elapsed();
+    auto endOf = [now](const Span* span) { return span->end < 0 ? now : span->end; };
+
+    // parents before their children
+    QList<const Span*> order;
+    order.reserve(m_spans.size());
+    for (auto& span : m_spans) {
+        if (span.start >= 0)
+            order.append(&span);
+    }
+    std::sort(order.begin(), order.end(), [&endOf](const Span* a, const Span* b) {
+        return a->start != b->start ? a->start < b->start : endOf(a) > endOf(b);
+    });
+
+    QJsonArray events;
+    events.append(QJsonObject{ { "name", "process_name" }, { "ph", "M" }, { "pid", 1 }, { "args", QJsonObject{ { "name", title } } } });
+
+    // spans on the same row have to nest, so each row keeps the ends of the spans enclosing the next one
+    QList<QList<qint64>> rows;
+    for (auto span : order) {
+        const auto end = endOf(span);
+        qsizetype row = 0;
+        for (; row < rows.size(); row++) {
+            auto& enclosing = rows[row];
+            while (!enclosing.isEmpty() && enclosing.last() <= span->start)
+                enclosing.removeLast();
+            if (enclosing.isEmpty() || enclosing.last() >= end)
+                break;
+        }
+        if (row == rows.size())
+            rows.append({});
+        rows[row].append(end);
+
+        QJsonObject args{ { "uid", span->uid.toString(QUuid::WithoutBraces) }, { "state", stateName(span->state) } };
+        if (!span->failReason.isEmpty())
+            args.insert("reason", span->failReason);
+        if (auto wait = span->queueWait(); wait >= 0)
+            args.insert("queueWait", wait);
+        if (span->bytes >= 0)
+            args.insert("bytes", span->bytes);
+        events.append(QJsonObject{ { "name", span->name },
+                                   { "cat", span->type },
+                                   { "ph", "X" },
+                                   { "pid", 1 },
+                                   { "tid", static_cast<int>(row + 1) },
+                                   { "ts", span->start },
+                                   { "dur", end - span->start },
+                                   { "args", args } });
+    }
+    for (auto& mark : m_marks)
+        events.append(QJsonObject{ { "name", mark.name }, { "ph", "i" }, { "s", "g" }, { "pid", 1 }, { "tid", 1 }, { "ts", mark.time } });
+
+    return QJsonDocument(QJsonObject{ { "traceEvents", events }, { "displayTimeUnit", "ms" } }).toJson(QJsonDocument::Compact);
+}
+
+QStringList TaskTrace::summary() const
+{
+    QMutexLocker locker(&m_lock);
+    const auto now = elapsed();
+    auto duration = [now](const Span& span) { return (span.end < 0 ? now : span.end) - span.start; };
+
+    QHash<QUuid, QList<qsizetype>> children;
+    QList<qsizetype> roots;
+    for (qsizetype i = 0; i < m_spans.size(); i++) {
+        if (m_index.contains(m_spans[i].parent))
+            children[m_spans[i].parent].append(i);
+        else
+            roots.append(i);
+    }
+
+    QStringList lines;
+    for (auto root : roots) {
+        const auto& span = m_spans[root];
+        qsizetype descendants = 0;
+        const Span* slowest = nullptr;
+        QSet<QUuid> seen{ span.uid };
+        QList<QUuid> pending{ span.uid };
+        while (!pending.isEmpty()) {
+            for (auto index : children.value(pending.takeLast())) {
+                const auto& child = m_spans[index];
+                if (seen.contains(child.uid))
+                    continue;
+                seen.insert(child.uid);
+                pending.append(child.uid);
+                descendants++;
+                if (!slowest || duration(child) > duration(*slowest))
+                    slowest = &child;
+            }
+        }
+
+        auto line = QStringLiteral("%1: %2").arg(span.name, formatDuration(duration(span)));
+        if (span.state != Task::State::Succeeded)
+            line += QStringLiteral(" (%1)").arg(stateName(span.state));
+        if (slowest)
+            line += QStringLiteral(", %1 nested task(s), slowest: %2 (%3)")
+                        .arg(descendants)
+                        .arg(slowest->name, formatDuration(duration(*slowest)));
+        lines.append(line);
+    }
+    for (auto& mark : m_marks)
+        lines.append(QStringLiteral("%1 after %2").arg(mark.name, formatDuration(mark.time)));
+    return lines;
+}
+
+QStringList TaskTrace::metrics() const
+{
+    struct Totals {
+        qsizetype count = 0;
+        qsizetype failed = 0;
+        qsizetype aborted = 0;
+        qsizetype running = 0;
+        qint64 busy = 0;
+        qsizetype waited = 0;
+        qint64 wait = 0;
+        qint64 maxWait = 0;
+        qint64 bytes = -1;
+    };
+
+    QMutexLocker locker(&m_lock);
+    const auto now = elapsed();
+    QMap<QString, Totals> byType;
+    for (auto& span : m_spans) {
+        auto& totals = byType[span.type];
+        totals.count++;
+        if (span.end < 0)
+            totals.running++;
+        else if (span.state == Task::State::Failed)
+            totals.failed++;
+        else if (span.state == Task::State::AbortedByUser)
+            totals.aborted++;
+        totals.busy += (span.end < 0 ? now : span.end) - span.start;
+        if (auto wait = span.queueWait(); wait >= 0) {
+            totals.waited++;
+            totals.wait += wait;
+            totals.maxWait = std::max(totals.maxWait, wait);
+        }
+        if (span.bytes >= 0)
+            totals.bytes = std::max<qint64>(totals.bytes, 0) + span.bytes;
+    }
+
+    QStringList lines;
+    for (auto it = byType.cbegin(); it != byType.cend(); it++) {
+        const auto& totals = it.value();
+        auto line = QStringLiteral("%1: %2 task(s), %3 failed, %4 aborted, %5 running; ran %6 in total, %7 on average")
+                        .arg(it.key())
+                        .arg(totals.count)
+                        .arg(totals.failed)
+                        .arg(totals.aborted)
+                        .arg(totals.running)
+                        .arg(formatDuration(totals.busy), formatDuration(totals.busy / totals.count));
+        if (totals.waited > 0)
+            line += QStringLiteral("; waited %1 on average, %2 at most")
+                        .arg(formatDuration(totals.wait / totals.waited), formatDuration(totals.maxWait));
+        if (totals.bytes >= 0)
+            line += QStringLiteral("; received %1").arg(StringUtils::humanReadableFileSize(totals.bytes));
+        lines.append(line);
+    }
+    return lines;
+}
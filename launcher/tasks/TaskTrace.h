@@ -0,0 +1,132 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  Prism Launcher - Minecraft Launcher
+ *  Copyright (c) 2026 Prism Launcher Contributors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include <QUuid>
+
+#include "tasks/Task.h"
+
+/**
+ * Records when tasks are created, queued, start and end while it exists, to find out where the time of a longer operation goes.
+ *
+ * Recording is opt-in: tasks only report to traces that exist, and cost an atomic load when there are none.
+ * Tasks queued by a ConcurrentTask are its children; other tasks are children of the task that was starting or finishing
+ * when they were started, which covers steps that start their tasks directly.
+ * Tasks with a `bytesReceived` property, like network requests, also get the amount of data they transferred recorded.
+ */
+class TaskTrace {
+   public:
+    struct Span {
+        QUuid uid;
+        QUuid parent;  // null for tasks that didn't start under another recorded task
+        QString name;
+        QString type;
+        qint64 created = -1;  // microseconds since the trace started, -1 if that was before
+        qint64 queued = -1;   // when it was added to its parent's queue
+        qint64 start = -1;
+        qint64 end = -1;  // -1 while the task is running
+        Task::State state = Task::State::Running;
+        QString failReason;
+        qint64 bytes = -1;  // -1 for tasks that don't transfer anything
+
+        /** Time between being queued, or created if it wasn't, and starting. -1 if neither was recorded. */
+        qint64 queueWait() const;
+    };
+    struct Mark {
+        QString name;
+        qint64 time;
+    };
+
+    /** Keeps the thread's current task while a task starts or finishes, so tasks started meanwhile know their parent */
+    class Scope {
+       public:
+        Scope() = default;
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+       private:
+        friend class TaskTrace;
+        explicit Scope(QUuid current);
+
+        QUuid m_previous;
+        bool m_active = false;
+    };
+
+    TaskTrace();
+    ~TaskTrace();
+    TaskTrace(const TaskTrace&) = delete;
+    TaskTrace& operator=(const TaskTrace&) = delete;
+
+    /** Stops recording. Tasks still running keep an open span. */
+    void stop();
+    bool isRecording() const;
+
+    /** Records a point in time that isn't a task, like a process starting */
+    void mark(const QString& name);
+
+    QList<Span> spans() const;
+    QList<Mark> marks() const;
+    qint64 elapsed() const;
+
+    /**
+     * The spans in the Chrome trace event format, as read by chrome://tracing, Perfetto and speedscope.
+     * Running spans end at the time of the call, and overlapping siblings are put on separate rows.
+     */
+    QByteArray toChromeTrace(const QString& title) const;
+
+    /** One line per task that started on its own, with its slowest descendant */
+    QStringList summary() const;
+
+    /** One line per task type: how many there were, how they ended, how long they ran and waited, and what they transferred */
+    QStringList metrics() const;
+
+    // reported by Task and ConcurrentTask
+    static void taskCreated(Task* task);
+    static void taskDestroyed(Task* task);
+    static Scope taskStarted(Task* task);
+    static Scope taskFinished(Task* task);
+    static void subTaskQueued(Task* parent, Task* child);
+
+   private:
+    // what is known about a task before it starts, until it starts or is destroyed without ever starting
+    struct Pending {
+        qint64 created = -1;
+        qint64 queued = -1;
+        QUuid parent;
+    };
+
+    bool onStarted(Task* task, const QUuid& current);
+    QUuid onFinished(Task* task);
+    Span& spanFor(const QUuid& uid, bool* added = nullptr);
+
+    mutable QMutex m_lock;
+    QElapsedTimer m_timer;
+    bool m_recording = true;
+    QList<Span> m_spans;
+    QHash<QUuid, qsizetype> m_index;
+    QHash<QUuid, Pending> m_pending;
+    QList<Mark> m_marks;
+};
@@ -45,6 +45,7 @@
 #include <QHeaderView>
 #include <QKeyEvent>
 #include <QMenu>
+#include <QScrollBar>
 #include <algorithm>
 
 ExternalResourcesPage::ExternalResourcesPage(BaseInstance* instance, std::shared_ptr<ResourceFolderModel> model, QWidget* parent)
@@ -105,6 +106,12 @@ ExternalResourcesPage::ExternalResourcesPage(BaseInstance* instance, std::shared
     connect(m_model.get(), &ResourceFolderModel::rowsInserted, this, [this] { updateActions(); });
     connect(m_model.get(), &ResourceFolderModel::rowsRemoved, this, [this] { updateActions(); });
 
+    // the rows on screen get parsed first
+    connect(ui->treeView->verticalScrollBar(), &QScrollBar::valueChanged, this, &ExternalResourcesPage::prioritizeVisibleRows);
+    connect(m_filterModel, &QSortFilterProxyModel::rowsInserted, this, &ExternalResourcesPage::prioritizeVisibleRows);
+    connect(m_filterModel, &QSortFilterProxyModel::layoutChanged, this, &ExternalResourcesPage::prioritizeVisibleRows);
+    connect(m_filterModel, &QSortFilterProxyModel::modelReset, this, &ExternalResourcesPage::prioritizeVisibleRows);
+
     auto viewHeader = ui->treeView->header();
     viewHeader->setContextMenuPolicy(Qt::CustomContextMenu);
 
@@ -152,6 +159,19 @@ void ExternalResourcesPage::openedImpl()
     ui->actionsToolbar->setVisibilityState(QByteArray::fromBase64(m_wide_bar_setting->get().toString().toUtf8()));
 }
 
+void ExternalResourcesPage::prioritizeVisibleRows()
+{
+    auto first = ui->treeView->indexAt(QPoint(0, 0));
+    if (!first.isValid())
+        return;
+    auto last = ui->treeView->indexAt(QPoint(0, ui->treeView->viewport()->height() - 1));
+    const int lastRow = last.isValid() ? last.row() : m_filterModel->rowCount() - 1;
+
+    // bottom up, so the top row is parsed first
+    for (int row = lastRow; row >= first.row(); --row)
+        m_model->prioritize(m_filterModel->mapToSource(m_filterModel->index(row, 0)).row());
+}
+
 void ExternalResourcesPage::closedImpl()
 {
     m_model->stopWatching();
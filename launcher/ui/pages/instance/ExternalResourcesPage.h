@@ -39,6 +39,7 @@ class ExternalResourcesPage : public QMainWindow, public BasePage {
    protected:
     bool eventFilter(QObject* obj, QEvent* ev) override;
     bool listFilter(QKeyEvent* ev);
+    void prioritizeVisibleRows();
     QMenu* createPopupMenu() override;
 
    public slots:
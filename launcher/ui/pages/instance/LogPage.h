@@ -53,10 +53,12 @@ class LogFormatProxyModel : public QIdentityProxyModel {
     QVariant data(const QModelIndex& index, int role) const override;
     QFont getFont() const { return m_font; }
     void setFont(QFont font) { m_font = font; }
+    void setColorLines(bool colorLines) { m_colorLines = colorLines; }
     QModelIndex find(const QModelIndex& start, const QString& value, bool reverse) const;
 
    private:
     QFont m_font;
+    bool m_colorLines = true;
 };
 
 class LogPage : public QWidget, public BasePage {
@@ -47,9 +47,17 @@
 #include <QDir>
 #include <QDirIterator>
 #include <QFileSystemWatcher>
+#include <QListView>
 #include <QShortcut>
 #include <QUrl>
 
+#include "logs/LogFileModel.h"
+
+namespace {
+// larger files are shown from the disk, and only their end is copied or uploaded
+constexpr qint64 s_maxTextSize = 1024ll * 1024ll * 12ll;
+}  // namespace
+
 OtherLogsPage::OtherLogsPage(QString id, QString displayName, QString helpPage, InstancePtr instance, QWidget* parent)
     : QWidget(parent)
     , m_id(id)
@@ -83,6 +91,46 @@ OtherLogsPage::OtherLogsPage(QString id, QString displayName, QString helpPage,
 
     ui->text->setModel(m_proxy);
 
+    m_fileModel = new LogFileModel(this);
+    if (!m_instance) {
+        m_fileModel->setLevelGuesser([](const QString& line, MessageLevel) {
+            QString lineTemp = line;
+            return MessageLevel::takeFromLauncherLine(lineTemp);
+        });
+    }
+    m_fileProxy = new LogFormatProxyModel(this);
+    m_fileProxy->setFont(m_proxy->getFont());
+    m_fileProxy->setSourceModel(m_fileModel);
+
+    // only asks for the rows that are on screen
+    m_largeView = new QListView(this);
+    m_largeView->setUniformItemSizes(true);
+    m_largeView->setSelectionMode(QAbstractItemView::ExtendedSelection);
+    m_largeView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_largeView->setModel(m_fileProxy);
+    m_largeView->hide();
+    ui->gridLayout_2->addWidget(m_largeView, 1, 0, 1, 5);
+
+    connect(m_fileModel, &LogFileModel::loaded, this, [this] {
+        m_largeView->scrollToBottom();
+        setControlsEnabled(true);
+    });
+    connect(m_fileModel, &LogFileModel::failed, this, [this](QString reason) {
+        setLargeFileMode(false);
+        ui->text->document()->setDefaultFont(m_proxy->getFont());
+        ui->text->setPlainText(reason);
+        setControlsEnabled(true);
+    });
+    connect(&m_findWatcher, &QFutureWatcher<int>::finished, this, [this] {
+        if (!m_largeFileMode || m_findWatcher.isCanceled())
+            return;
+        auto index = m_fileProxy->index(m_findWatcher.result(), 0);
+        if (index.isValid()) {
+            m_largeView->setCurrentIndex(index);
+            m_largeView->scrollTo(index, QAbstractItemView::PositionAtCenter);
+        }
+    });
+
     if (m_instance) {
         m_model->setMaxLines(getConsoleMaxLines(m_instance->settings()));
         m_model->setStopOnOverflow(shouldStopOnConsoleOverflow(m_instance->settings()));
@@ -215,6 +263,7 @@ void OtherLogsPage::on_selectLogBox_currentIndexChanged(const int index)
 
     if ((index != 0 || m_instance) && (file.isEmpty() || !QFile::exists(FS::PathCombine(m_basePath, file)))) {
         m_currentFile = QString();
+        setLargeFileMode(false);
         ui->text->clear();
         setControlsEnabled(false);
     } else {
@@ -240,6 +289,7 @@ void OtherLogsPage::on_btnReload_clicked()
 void OtherLogsPage::reload()
 {
     if (m_currentFile.isEmpty()) {
+        setLargeFileMode(false);
         if (m_instance) {
             setControlsEnabled(false);
         } else {
@@ -255,6 +305,7 @@ void OtherLogsPage::reload()
 
     QFile file(FS::PathCombine(m_basePath, m_currentFile));
     if (!file.open(QFile::ReadOnly)) {
+        setLargeFileMode(false);
         setControlsEnabled(false);
         ui->btnReload->setEnabled(true);  // allow reload
         m_currentFile = QString();
@@ -265,15 +316,11 @@ void OtherLogsPage::reload()
             doc->setDefaultFont(m_proxy->getFont());
             ui->text->setPlainText(text);
         };
-        auto showTooBig = [setPlainText, &file]() {
-            setPlainText(tr("The file (%1) is too big. You may want to open it in a viewer optimized "
-                            "for large files.")
-                             .arg(file.fileName()));
-        };
-        if (file.size() > (1024ll * 1024ll * 12ll)) {
-            showTooBig();
+        if (file.size() > s_maxTextSize) {
+            loadLargeFile(file.fileName());
             return;
         }
+        setLargeFileMode(false);
         MessageLevel last = MessageLevel::Unknown;
 
         auto handleLine = [this, &last](QString line) {
@@ -347,20 +394,62 @@ void OtherLogsPage::reload()
     }
 }
 
+void OtherLogsPage::loadLargeFile(const QString& path)
+{
+    setLargeFileMode(true);
+    setControlsEnabled(false);
+    m_fileProxy->setColorLines(ui->colorCheckbox->checkState() == Qt::Checked);
+    m_fileModel->load(path);
+}
+
+void OtherLogsPage::setLargeFileMode(bool enabled)
+{
+    if (!enabled) {
+        // let go of the mapping, so the file can be deleted
+        m_fileModel->clear();
+    }
+    m_largeFileMode = enabled;
+    ui->text->setVisible(!enabled);
+    m_largeView->setVisible(enabled);
+    // rows of the large file view are single lines
+    ui->wrapCheckbox->setEnabled(!enabled);
+}
+
+QString OtherLogsPage::currentText() const
+{
+    return m_largeFileMode ? m_fileModel->text(s_maxTextSize) : ui->text->toPlainText();
+}
+
+bool OtherLogsPage::confirmPartialText(const QString& question)
+{
+    if (!m_largeFileMode || m_fileModel->size() <= s_maxTextSize)
+        return true;
+    auto response = QMessageBox::question(this, tr("Large log file"), question.arg(s_maxTextSize / (1024 * 1024)),
+                                          QMessageBox::Yes | QMessageBox::No, QMessageBox::No);
+    return response == QMessageBox::Yes;
+}
+
 void OtherLogsPage::on_btnPaste_clicked()
 {
+    if (!confirmPartialText(tr("This log file is too large to upload in full. Do you want to upload its last %1 MB?")))
+        return;
     QString name = m_currentFile.isEmpty() ? displayName() : m_currentFile;
-    GuiUtil::uploadPaste(name, ui->text->toPlainText(), this);
+    GuiUtil::uploadPaste(name, currentText(), this);
 }
 
 void OtherLogsPage::on_btnCopy_clicked()
 {
-    GuiUtil::setClipboardText(ui->text->toPlainText());
+    if (!confirmPartialText(tr("This log file is too large to copy in full. Do you want to copy its last %1 MB?")))
+        return;
+    GuiUtil::setClipboardText(currentText());
 }
 
 void OtherLogsPage::on_btnBottom_clicked()
 {
-    ui->text->scrollToBottom();
+    if (m_largeFileMode)
+        m_largeView->scrollToBottom();
+    else
+        ui->text->scrollToBottom();
 }
 
 void OtherLogsPage::on_trackLogCheckbox_clicked(bool checked)
@@ -384,6 +473,7 @@ void OtherLogsPage::on_btnDelete_clicked()
                               QMessageBox::Yes, QMessageBox::No) == QMessageBox::No) {
         return;
     }
+    setLargeFileMode(false);
     QFile file(FS::PathCombine(m_basePath, m_currentFile));
 
     if (FS::trash(file.fileName())) {
@@ -418,6 +508,7 @@ void OtherLogsPage::on_btnClean_clicked()
     if (messageBox->exec() != QMessageBox::Ok) {
         return;
     }
+    setLargeFileMode(false);
     QStringList failed;
     for (auto item : toDelete) {
         QString absolutePath = FS::PathCombine(m_basePath, item);
@@ -460,6 +551,8 @@ void OtherLogsPage::on_wrapCheckbox_clicked(bool checked)
 void OtherLogsPage::on_colorCheckbox_clicked(bool checked)
 {
     ui->text->setColorLines(checked);
+    m_fileProxy->setColorLines(checked);
+    m_largeView->viewport()->update();
     if (!m_model)
         return;
     m_model->setColorLines(checked);
@@ -489,6 +582,7 @@ void OtherLogsPage::setControlsEnabled(const bool enabled)
     ui->btnCopy->setEnabled(enabled);
     ui->btnPaste->setEnabled(enabled);
     ui->text->setEnabled(enabled);
+    m_largeView->setEnabled(enabled);
 }
 
 QStringList OtherLogsPage::getPaths()
@@ -518,17 +612,28 @@ void OtherLogsPage::on_findButton_clicked()
 {
     auto modifiers = QApplication::keyboardModifiers();
     bool reverse = modifiers & Qt::ShiftModifier;
-    ui->text->findNext(ui->searchBar->text(), reverse);
+    find(reverse);
 }
 
 void OtherLogsPage::findNextActivated()
 {
-    ui->text->findNext(ui->searchBar->text(), false);
+    find(false);
 }
 
 void OtherLogsPage::findPreviousActivated()
 {
-    ui->text->findNext(ui->searchBar->text(), true);
+    find(true);
+}
+
+void OtherLogsPage::find(bool reverse)
+{
+    if (!m_largeFileMode) {
+        ui->text->findNext(ui->searchBar->text(), reverse);
+        return;
+    }
+    // searching hundreds of megabytes takes a moment, the result selects the line when it's there
+    auto current = m_largeView->currentIndex();
+    m_findWatcher.setFuture(m_fileModel->find(ui->searchBar->text(), current.isValid() ? current.row() : -1, reverse));
 }
 
 void OtherLogsPage::findActivated()
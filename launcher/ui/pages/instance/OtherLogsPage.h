@@ -39,6 +39,7 @@
 
 #include <Application.h>
 #include <QFileSystemWatcher>
+#include <QFutureWatcher>
 #include "LogPage.h"
 #include "ui/pages/BasePage.h"
 
@@ -47,6 +48,8 @@ class OtherLogsPage;
 }
 
 class RecursiveFileSystemWatcher;
+class LogFileModel;
+class QListView;
 
 class OtherLogsPage : public QWidget, public BasePage {
     Q_OBJECT
@@ -88,6 +91,11 @@ class OtherLogsPage : public QWidget, public BasePage {
     void modelStateToUI();
     void UIToModelState();
     void setControlsEnabled(bool enabled);
+    void loadLargeFile(const QString& path);
+    void setLargeFileMode(bool enabled);
+    void find(bool reverse);
+    QString currentText() const;
+    bool confirmPartialText(const QString& question);
 
     QStringList getPaths();
 
@@ -106,4 +114,11 @@ class OtherLogsPage : public QWidget, public BasePage {
 
     LogFormatProxyModel* m_proxy;
     shared_qobject_ptr<LogModel> m_model;
+
+    // files too big to go through the log model are shown straight from the disk
+    LogFileModel* m_fileModel;
+    LogFormatProxyModel* m_fileProxy;
+    QListView* m_largeView;
+    bool m_largeFileMode = false;
+    QFutureWatcher<int> m_findWatcher;
 };
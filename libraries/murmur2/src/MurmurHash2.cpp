@@ -8,6 +8,9 @@
 
 #include "MurmurHash2.h"
 
+#include <bit>
+#include <cstring>
+
 namespace Murmur2 {
 
 // 'm' and 'r' are mixing constants generated offline.
@@ -15,6 +18,51 @@ namespace Murmur2 {
 const uint32_t m = 0x5bd1e995;
 const int r = 24;
 
+namespace {
+
+constexpr uint64_t ones = 0x0101010101010101ULL;
+constexpr uint64_t lows = 0x7f7f7f7f7f7f7f7fULL;
+
+// Sets the high bit of every byte of x that is zero. Unlike the classic "haszero" trick this is exact, so the
+// result can be used for counting.
+inline uint64_t zeroBytes(uint64_t x)
+{
+    return ~(((x & lows) + lows) | x | lows);
+}
+
+// Sets the high bit of every byte of w that is one of the whitespace characters filtered out by CurseForge.
+inline uint64_t whitespaceBytes(uint64_t w)
+{
+    return zeroBytes(w ^ (ones * 9)) | zeroBytes(w ^ (ones * 10)) | zeroBytes(w ^ (ones * 13)) | zeroBytes(w ^ (ones * 32));
+}
+
+inline bool isWhitespace(unsigned char c)
+{
+    return c == 9 || c == 10 || c == 13 || c == 32;
+}
+
+inline uint64_t loadWord(const unsigned char* p)
+{
+    uint64_t w;
+    std::memcpy(&w, p, sizeof(w));
+    return w;
+}
+
+inline void mixBlock(uint32_t& h, const unsigned char* p)
+{
+    uint32_t k;
+    std::memcpy(&k, p, sizeof(k));
+
+    k *= m;
+    k ^= k >> r;
+    k *= m;
+
+    h *= m;
+    h ^= k;
+}
+
+}  // namespace
+
 uint32_t hash(Reader* file_stream, std::size_t buffer_size, std::function<bool(char)> filter_out)
 {
     auto* buffer = new char[buffer_size];
@@ -64,6 +112,71 @@ uint32_t hash(Reader* file_stream, std::size_t buffer_size, std::function<bool(c
     return info.h;
 }
 
+uint32_t hash(const char* data, std::size_t size, bool filter_whitespace)
+{
+    const auto* bytes = reinterpret_cast<const unsigned char*>(data);
+
+    // The seed depends on the filtered length, so count it first. This walks memory 8 bytes at a time and is
+    // much cheaper than the mixing pass, which is where the old implementation re-read the whole file.
+    uint32_t len = static_cast<uint32_t>(size);
+    if (filter_whitespace) {
+        len = 0;
+        std::size_t i = 0;
+        for (; i + 8 <= size; i += 8)
+            len += 8 - std::popcount(whitespaceBytes(loadWord(bytes + i)));
+        for (; i < size; i++)
+            len += !isWhitespace(bytes[i]);
+    }
+
+    // This forces a seed of 1.
+    uint32_t h = 1 ^ len;
+
+    unsigned char tail[4];
+    int pending = 0;
+    std::size_t i = 0;
+    while (i < size) {
+        // Fast path: whole words without whitespace are mixed straight from the source buffer. Compressed jar
+        // contents hit this for the vast majority of words.
+        if (pending == 0 && i + 8 <= size && (!filter_whitespace || whitespaceBytes(loadWord(bytes + i)) == 0)) {
+            mixBlock(h, bytes + i);
+            mixBlock(h, bytes + i + 4);
+            i += 8;
+            continue;
+        }
+
+        unsigned char c = bytes[i++];
+        if (filter_whitespace && isWhitespace(c))
+            continue;
+
+        tail[pending++] = c;
+        if (pending == 4) {
+            mixBlock(h, tail);
+            pending = 0;
+        }
+    }
+
+    // Handle the last few bytes of the input array
+    switch (pending) {
+        case 3:
+            h ^= tail[2] << 16;
+            /* fall through */
+        case 2:
+            h ^= tail[1] << 8;
+            /* fall through */
+        case 1:
+            h ^= tail[0];
+            h *= m;
+    };
+
+    // Do a few final mixes of the hash to ensure the last few
+    // bytes are well-incorporated.
+    h ^= h >> 13;
+    h *= m;
+    h ^= h >> 15;
+
+    return h;
+}
+
 void FourBytes_MurmurHash2(const unsigned char* data, IncrementalHashInfo& prev)
 {
     if (prev.len >= 4) {
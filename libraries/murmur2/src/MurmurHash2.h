@@ -26,6 +26,11 @@ class Reader {
 
 uint32_t hash(Reader* file_stream, std::size_t buffer_size = 4 * MiB, std::function<bool(char)> filter_out = [](char) { return false; });
 
+// Hashes an in-memory (or memory-mapped) buffer without going back to the underlying file.
+// When filter_whitespace is set, the bytes 9, 10, 13 and 32 are skipped, matching
+// the CurseForge fingerprint. The result is identical to the Reader based overload with the equivalent filter.
+uint32_t hash(const char* data, std::size_t size, bool filter_whitespace = false);
+
 struct IncrementalHashInfo {
     uint32_t h;
     uint32_t len;
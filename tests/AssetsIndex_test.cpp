@@ -0,0 +1,118 @@
+#include <QDir>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <filesystem>
+
+#include <FileSystem.h>
+#include <minecraft/AssetsUtils.h>
+
+class AssetsIndexTest : public QObject {
+    Q_OBJECT
+
+    static QByteArray sampleIndex()
+    {
+        return R"({
+            "virtual": true,
+            "objects": {
+                "icons/icon_16x16.png": { "hash": "bdf48ef6b5d0d23bbb02e17d04865216179f510a", "size": 3665 },
+                "minecraft/sounds/ambient/cave/cave1.ogg": { "hash": "5d8b7e0b1a8b8eb6ba39ed6cafd5b4a3ec4c5e3f", "size": 19428 },
+                "broken": { "hash": "nope", "size": 1 }
+            }
+        })";
+    }
+
+   private slots:
+    void test_parse()
+    {
+        auto index = AssetsUtils::parseAssetsIndex("legacy", sampleIndex());
+        QVERIFY(index);
+        QCOMPARE(index->id, QString("legacy"));
+        QVERIFY(index->isVirtual);
+        QVERIFY(!index->mapToResources);
+
+        // entries with an unusable hash are dropped
+        QCOMPARE(index->objects.size(), qsizetype(2));
+        QVERIFY(!index->find("broken"));
+
+        auto icon = index->find("icons/icon_16x16.png");
+        QVERIFY(icon);
+        QCOMPARE(icon->hash(), QString("bdf48ef6b5d0d23bbb02e17d04865216179f510a"));
+        QCOMPARE(icon->size, qint64(3665));
+        QCOMPARE(icon->getRelPath(), QString("bd/bdf48ef6b5d0d23bbb02e17d04865216179f510a"));
+        QCOMPARE(icon->getLocalPath(), QString("assets/objects/bd/bdf48ef6b5d0d23bbb02e17d04865216179f510a"));
+    }
+
+    void test_invalid()
+    {
+        QVERIFY(!AssetsUtils::parseAssetsIndex("bad", "{ not json"));
+        QVERIFY(!AssetsUtils::parseAssetsIndex("bad", "[]"));
+    }
+
+    void test_loadOnce()
+    {
+        QTemporaryDir tempDir;
+        const auto path = FS::PathCombine(tempDir.path(), "legacy.json");
+        FS::write(path, sampleIndex());
+
+        auto first = AssetsUtils::loadAssetsIndex("test_loadOnce", path);
+        QVERIFY(first);
+        QCOMPARE(AssetsUtils::loadAssetsIndex("test_loadOnce", path), first);
+
+        // a new download of the index replaces the cached copy
+        FS::write(path, R"({ "objects": {} })");
+        auto second = AssetsUtils::loadAssetsIndex("test_loadOnce", path);
+        QVERIFY(second);
+        QVERIFY(second != first);
+        QVERIFY(second->objects.isEmpty());
+    }
+
+    void test_reconstruct()
+    {
+        QTemporaryDir tempDir;
+        const auto previousDir = QDir::currentPath();
+        QDir::setCurrent(tempDir.path());
+
+        const QString iconHash = "bdf48ef6b5d0d23bbb02e17d04865216179f510a";
+        const QString caveHash = "5d8b7e0b1a8b8eb6ba39ed6cafd5b4a3ec4c5e3f";
+        FS::write("assets/indexes/legacy.json", sampleIndex());
+        FS::write("assets/objects/bd/" + iconHash, "icon");
+
+        QVERIFY(AssetsUtils::reconstructAssets("legacy", "resources"));
+        QCOMPARE(FS::read("assets/virtual/legacy/icons/icon_16x16.png"), QByteArray("icon"));
+        QVERIFY(!QFileInfo::exists("assets/virtual/legacy/minecraft/sounds/ambient/cave/cave1.ogg"));
+
+        // assets deleted from the folder are placed again, as well as the ones that were missing from the objects
+        QFile::remove("assets/virtual/legacy/icons/icon_16x16.png");
+        FS::write("assets/objects/5d/" + caveHash, "cave");
+
+        QVERIFY(AssetsUtils::reconstructAssets("legacy", "resources"));
+        QCOMPARE(FS::read("assets/virtual/legacy/minecraft/sounds/ambient/cave/cave1.ogg"), QByteArray("cave"));
+        QCOMPARE(FS::read("assets/virtual/legacy/icons/icon_16x16.png"), QByteArray("icon"));
+
+        // even when nothing was pending anymore
+        QFile::remove("assets/virtual/legacy/icons/icon_16x16.png");
+        QVERIFY(AssetsUtils::reconstructAssets("legacy", "resources"));
+        QCOMPARE(FS::read("assets/virtual/legacy/icons/icon_16x16.png"), QByteArray("icon"));
+
+        // assets that are in place are left alone
+        FS::write("assets/virtual/legacy/icons/icon_16x16.png", "edited");
+        QVERIFY(AssetsUtils::reconstructAssets("legacy", "resources"));
+        QCOMPARE(FS::read("assets/virtual/legacy/icons/icon_16x16.png"), QByteArray("edited"));
+
+        // a relaunch only compares the folders' times, the files themselves aren't looked at
+        const std::filesystem::path iconFolder("assets/virtual/legacy/icons");
+        const auto folderTime = std::filesystem::last_write_time(iconFolder);
+        QFile::remove("assets/virtual/legacy/icons/icon_16x16.png");
+        std::filesystem::last_write_time(iconFolder, folderTime);
+        QVERIFY(AssetsUtils::reconstructAssets("legacy", "resources"));
+        QVERIFY(!QFileInfo::exists("assets/virtual/legacy/icons/icon_16x16.png"));
+
+        QDir::setCurrent(previousDir);
+    }
+};
+
+QTEST_GUILESS_MAIN(AssetsIndexTest)
+
+#include "AssetsIndex_test.moc"
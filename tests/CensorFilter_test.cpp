@@ -0,0 +1,139 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  Prism Launcher - Minecraft Launcher
+ *  Copyright (c) 2026 Prism Launcher Contributors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <QTest>
+
+#include <logs/CensorFilter.h>
+
+class CensorFilterTest : public QObject {
+    Q_OBJECT
+
+    static QString accessToken()
+    {
+        QString token;
+        for (int i = 0; token.size() < 1200; i++)
+            token += QString::number(i * 7919, 36);
+        return token;
+    }
+
+    // roughly what a session hands to the launch task
+    static QMap<QString, QString> sessionFilter()
+    {
+        const auto token = accessToken();
+        return {
+            { "token:" + token.left(32) + ":" + token.right(32), "<SESSION ID>" },
+            { token, "<ACCESS TOKEN>" },
+            { "0123456789abcdef0123456789abcdef", "<PROFILE ID>" },
+            { "/home/someone/.local/share/PrismLauncher", "<LAUNCHER DIR>" },
+        };
+    }
+
+    static QStringList logLines()
+    {
+        QStringList lines;
+        for (int i = 0; i < 1000; i++)
+            lines << QString("[12:34:%1] [Render thread/INFO]: [net.minecraft.client.Minecraft/]: Loaded %2 entries from mod %3")
+                         .arg(i % 60)
+                         .arg(i * 13)
+                         .arg(i);
+        lines << "[12:34:56] [main/INFO]: Setting user: Someone, uuid 0123456789abcdef0123456789abcdef";
+        lines << "[12:34:56] [main/INFO]: Game directory: /home/someone/.local/share/PrismLauncher/instances/test/minecraft";
+        return lines;
+    }
+
+   private slots:
+    void test_replace_data()
+    {
+        QTest::addColumn<QString>("line");
+        QTest::addColumn<QString>("expected");
+
+        QTest::addRow("nothing") << "plain line" << "plain line";
+        QTest::addRow("empty") << "" << "";
+        QTest::addRow("whole") << "secret" << "<S>";
+        QTest::addRow("several") << "a secret and 1234 and secret" << "a <S> and <N> and <S>";
+        QTest::addRow("adjacent") << "secret1234secret" << "<S><N><S>";
+        QTest::addRow("partial") << "secre secre1 12345" << "secre secre1 <N>5";
+        QTest::addRow("restart") << "ssecret sesecret" << "s<S> se<S>";
+        QTest::addRow("inner") << "xuser/secret/x" << "xuser/<S>/x";
+        // the longest match wins when several end at the same place
+        QTest::addRow("suffix") << "my-1234" << "<MINE>";
+    }
+
+    void test_replace()
+    {
+        QFETCH(QString, line);
+        QFETCH(QString, expected);
+
+        CensorFilter filter({ { "secret", "<S>" }, { "1234", "<N>" }, { "user/secret/", "<PATH>" }, { "my-1234", "<MINE>" } });
+        QCOMPARE(filter.apply(line), expected);
+    }
+
+    void test_empty()
+    {
+        CensorFilter filter({ { "", "<NOTHING>" } });
+        QVERIFY(filter.isEmpty());
+        QCOMPARE(filter.apply("line"), QString("line"));
+    }
+
+    void test_matchesSequentialReplace()
+    {
+        const auto map = sessionFilter();
+        CensorFilter filter(map);
+        auto lines = logLines();
+        lines << "Java Arguments: --accessToken " + accessToken() + " --uuid 0123456789abcdef0123456789abcdef";
+        for (auto& line : lines) {
+            auto expected = line;
+            for (auto it = map.begin(); it != map.end(); ++it)
+                expected.replace(it.key(), it.value());
+            QCOMPARE(filter.apply(line), expected);
+        }
+    }
+
+    void bench_censor_data()
+    {
+        QTest::addColumn<bool>("automaton");
+        QTest::addRow("replace") << false;
+        QTest::addRow("automaton") << true;
+    }
+
+    void bench_censor()
+    {
+        QFETCH(bool, automaton);
+        const auto map = sessionFilter();
+        const CensorFilter filter(map);
+        const auto lines = logLines();
+
+        qsizetype total = 0;
+        QBENCHMARK
+        {
+            for (auto line : lines) {
+                if (automaton) {
+                    line = filter.apply(line);
+                } else {
+                    for (auto it = map.begin(); it != map.end(); ++it)
+                        line.replace(it.key(), it.value());
+                }
+                total += line.size();
+            }
+        }
+        QVERIFY(total > 0);
+    }
+};
+
+QTEST_GUILESS_MAIN(CensorFilterTest)
+
+#include "CensorFilter_test.moc"
@@ -0,0 +1,76 @@
+#include <QCryptographicHash>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <FileSystem.h>
+#include <net/ContentStore.h>
+
+class ContentStoreTest : public QObject {
+    Q_OBJECT
+   private slots:
+    void test_insertAndMaterialize()
+    {
+        QTemporaryDir tempDir;
+        Net::ContentStore store(FS::PathCombine(tempDir.path(), "store"));
+        const QByteArray contents = "some mod";
+        const auto hash = QCryptographicHash::hash(contents, QCryptographicHash::Sha1);
+
+        const auto source = FS::PathCombine(tempDir.path(), "download", "mod.jar");
+        FS::write(source, contents);
+        QVERIFY(store.insert(QCryptographicHash::Sha1, hash, source));
+        QVERIFY(store.contains(QCryptographicHash::Sha1, hash));
+        QCOMPARE(FS::read(store.blobPath(QCryptographicHash::Sha1, hash)), contents);
+
+        const auto first = FS::PathCombine(tempDir.path(), "a", "mods", "mod.jar");
+        const auto second = FS::PathCombine(tempDir.path(), "b", "mods", "mod.jar");
+        QVERIFY(store.materialize(QCryptographicHash::Sha1, hash, first));
+        QVERIFY(store.materialize(QCryptographicHash::Sha1, hash, second));
+        QCOMPARE(FS::read(first), contents);
+
+        // editing one instance's file must not change the blob, nor the other instance's file
+        {
+            QFile file(first);
+            QVERIFY(file.open(QIODevice::ReadWrite));
+            QVERIFY(file.write("edited") == 6);
+        }
+        QCOMPARE(FS::read(store.blobPath(QCryptographicHash::Sha1, hash)), contents);
+        QCOMPARE(FS::read(second), contents);
+    }
+
+    void test_corruptedBlob()
+    {
+        QTemporaryDir tempDir;
+        Net::ContentStore store(FS::PathCombine(tempDir.path(), "store"));
+        const QByteArray contents = "some mod";
+        const auto hash = QCryptographicHash::hash(contents, QCryptographicHash::Sha1);
+
+        const auto source = FS::PathCombine(tempDir.path(), "mod.jar");
+        FS::write(source, contents);
+        QVERIFY(store.insert(QCryptographicHash::Sha1, hash, source));
+
+        FS::write(store.blobPath(QCryptographicHash::Sha1, hash), "something else");
+        const auto destination = FS::PathCombine(tempDir.path(), "instance", "mod.jar");
+        QVERIFY(!store.materialize(QCryptographicHash::Sha1, hash, destination));
+        QVERIFY(!QFileInfo::exists(destination));
+        // so the next download can take its place
+        QVERIFY(!store.contains(QCryptographicHash::Sha1, hash));
+    }
+
+    void test_unsupported()
+    {
+        QTemporaryDir tempDir;
+        Net::ContentStore store(FS::PathCombine(tempDir.path(), "store"));
+        const QByteArray contents = "some mod";
+        const auto hash = QCryptographicHash::hash(contents, QCryptographicHash::Md5);
+
+        const auto source = FS::PathCombine(tempDir.path(), "mod.jar");
+        FS::write(source, contents);
+        QVERIFY(!Net::ContentStore::supports(QCryptographicHash::Md5));
+        QVERIFY(!store.insert(QCryptographicHash::Md5, hash, source));
+        QVERIFY(!store.materialize(QCryptographicHash::Md5, hash, FS::PathCombine(tempDir.path(), "copy.jar")));
+    }
+};
+
+QTEST_GUILESS_MAIN(ContentStoreTest)
+
+#include "ContentStore_test.moc"
@@ -0,0 +1,128 @@
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <FileSystem.h>
+#include <MMCZip.h>
+#include <archive/ExportToZipTask.h>
+#include <archive/ZipIndex.h>
+
+class ExportToZipTest : public QObject {
+    Q_OBJECT
+
+    // text that deflates about as well as configs and logs do
+    static QByteArray textData(qsizetype size, quint32 seed)
+    {
+        static const QList<QByteArray> words = { "minecraft", "block", "stone", "true", "false", "=",
+                                                 "\n",        "{",     "}",     "0.5",  "texture", " " };
+        QRandomGenerator random(seed);
+        QByteArray data;
+        data.reserve(size + 16);
+        while (data.size() < size)
+            data.append(words[random.bounded(words.size())]);
+        data.truncate(size);
+        return data;
+    }
+
+    static bool runTask(MMCZip::ExportToZipTask& task)
+    {
+        task.start();
+        return QTest::qWaitFor([&task]() { return task.isFinished(); }, 60000) && task.wasSuccessful();
+    }
+
+   private slots:
+    void test_export()
+    {
+        QTemporaryDir tempDir;
+        const auto root = FS::PathCombine(tempDir.path(), "instance");
+        const auto output = FS::PathCombine(tempDir.path(), "export.zip");
+
+        // bigger than a chunk, so it is compressed in pieces
+        const auto big = textData(9 * 1024 * 1024 + 123, 1);
+        const auto image = textData(1000, 2);
+        FS::write(FS::PathCombine(root, "options.txt"), "fov:0.5");
+        FS::write(FS::PathCombine(root, "saves", "world", "level.dat.txt"), big);
+        FS::write(FS::PathCombine(root, "icon.png"), image);
+        FS::write(FS::PathCombine(root, "empty.txt"), "");
+        FS::write(FS::PathCombine(root, "excluded.txt"), "secret");
+
+        QFileInfoList files;
+        QVERIFY(MMCZip::collectFileListRecursively(root, nullptr, &files, nullptr));
+
+        MMCZip::ExportToZipTask task(output, root, files, "overrides/");
+        task.setExcludeFiles({ "excluded.txt" });
+        task.addExtraFile("manifest.json", "{}");
+        task.setThreadCount(3);
+        QVERIFY(runTask(task));
+
+        MMCZip::ZipIndex index(output);
+        QVERIFY(index.open());
+        QCOMPARE(index.entries().size(), qsizetype(5));
+        QVERIFY(!index.contains("overrides/excluded.txt"));
+        QCOMPARE(index.read("manifest.json").value(), QByteArray("{}"));
+        QCOMPARE(index.read("overrides/options.txt").value(), QByteArray("fov:0.5"));
+        QCOMPARE(index.read("overrides/empty.txt").value(), QByteArray());
+        QCOMPARE(index.read("overrides/saves/world/level.dat.txt").value(), big);
+        QCOMPARE(index.find("overrides/saves/world/level.dat.txt")->method, quint16(MMCZip::ZipIndex::Deflated));
+        QVERIFY(index.find("overrides/saves/world/level.dat.txt")->compressedSize < quint64(big.size() / 2));
+        // already compressed formats are stored
+        QCOMPARE(index.find("overrides/icon.png")->method, quint16(MMCZip::ZipIndex::Stored));
+        QCOMPARE(index.read("overrides/icon.png").value(), image);
+    }
+
+    void test_storeEverything()
+    {
+        QTemporaryDir tempDir;
+        const auto root = FS::PathCombine(tempDir.path(), "instance");
+        const auto output = FS::PathCombine(tempDir.path(), "export.zip");
+        const auto data = textData(5 * 1024 * 1024, 3);
+        FS::write(FS::PathCombine(root, "log.txt"), data);
+
+        QFileInfoList files;
+        QVERIFY(MMCZip::collectFileListRecursively(root, nullptr, &files, nullptr));
+
+        MMCZip::ExportToZipTask task(output, root, files);
+        task.setCompressionLevel(0);
+        QVERIFY(runTask(task));
+
+        MMCZip::ZipIndex index(output);
+        QVERIFY(index.open());
+        QCOMPARE(index.find("log.txt")->method, quint16(MMCZip::ZipIndex::Stored));
+        QCOMPARE(index.read("log.txt").value(), data);
+    }
+
+    void bench_export_data()
+    {
+        QTest::addColumn<int>("threads");
+
+        for (int threads = 1; threads <= QThread::idealThreadCount(); threads *= 2)
+            QTest::addRow("%d threads", threads) << threads;
+    }
+
+    void bench_export()
+    {
+        QFETCH(int, threads);
+
+        QTemporaryDir tempDir;
+        const auto root = FS::PathCombine(tempDir.path(), "instance");
+        const auto output = FS::PathCombine(tempDir.path(), "export.zip");
+        // small enough to run with the other tests, with one file that is split over two chunks
+        for (int i = 0; i < 8; i++)
+            FS::write(FS::PathCombine(root, QString("file%1.txt").arg(i)), textData(256 * 1024, i));
+        FS::write(FS::PathCombine(root, "big.txt"), textData(6 * 1024 * 1024, 100));
+
+        QFileInfoList files;
+        QVERIFY(MMCZip::collectFileListRecursively(root, nullptr, &files, nullptr));
+
+        QBENCHMARK
+        {
+            MMCZip::ExportToZipTask task(output, root, files);
+            task.setThreadCount(threads);
+            QVERIFY(runTask(task));
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(ExportToZipTest)
+
+#include "ExportToZip_test.moc"
@@ -0,0 +1,451 @@
+#include <QCryptographicHash>
+#include <QFileInfo>
+#include <QNetworkAccessManager>
+#include <QNetworkProxy>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTemporaryDir>
+#include <QTest>
+#include <QTimer>
+
+#include <FileSystem.h>
+#include <net/ChecksumValidator.h>
+#include <net/Download.h>
+
+#include <functional>
+#include <utility>
+
+// Just enough HTTP/1.1 to serve downloads to QNetworkAccessManager, one request per connection
+class TestHttpServer : public QTcpServer {
+    Q_OBJECT
+   public:
+    struct Request {
+        QByteArray path;
+        QHash<QByteArray, QByteArray> headers;  // names in lower case
+    };
+    struct Response {
+        int status = 200;
+        QList<std::pair<QByteArray, QByteArray>> headers;
+        QByteArray body;
+        qint64 sendOnly = -1;  // drop the connection after this many bytes of the body
+    };
+    using Handler = std::function<Response(const Request&)>;
+
+    TestHttpServer()
+    {
+        connect(this, &QTcpServer::newConnection, this, [this] {
+            while (auto socket = nextPendingConnection())
+                serve(socket);
+        });
+    }
+
+    QUrl url(const QString& path) const { return QUrl(QString("http://127.0.0.1:%1%2").arg(serverPort()).arg(path)); }
+
+    Handler handler;
+    QList<Request> requests;
+
+    // a file that can be asked for in ranges, like any static file server would serve it
+    static Response serveRanges(const Request& request, const QByteArray& body, const QByteArray& etag)
+    {
+        Response response;
+        response.headers = { { "Accept-Ranges", "bytes" }, { "ETag", etag } };
+        const auto range = request.headers.value("range");
+        const auto ifRange = request.headers.value("if-range");
+        if (!range.startsWith("bytes=") || (!ifRange.isEmpty() && ifRange != etag)) {
+            response.body = body;
+            return response;
+        }
+
+        const auto bounds = range.mid(6).split('-');
+        const qint64 start = bounds.value(0).toLongLong();
+        const qint64 end = bounds.value(1).isEmpty() ? body.size() - 1 : qMin<qint64>(bounds.value(1).toLongLong(), body.size() - 1);
+        if (start >= body.size()) {
+            response.status = 416;
+            response.headers.append({ "Content-Range", "bytes */" + QByteArray::number(body.size()) });
+            return response;
+        }
+        response.status = 206;
+        const auto contentRange = QString("bytes %1-%2/%3").arg(start).arg(end).arg(body.size()).toLatin1();
+        response.headers.append({ "Content-Range", contentRange });
+        response.body = body.mid(start, end - start + 1);
+        return response;
+    }
+
+   private:
+    void serve(QTcpSocket* socket)
+    {
+        connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+        connect(socket, &QTcpSocket::readyRead, socket, [this, socket] {
+            auto buffer = socket->property("buffer").toByteArray() + socket->readAll();
+            socket->setProperty("buffer", buffer);
+            const auto headerEnd = buffer.indexOf("\r\n\r\n");
+            if (headerEnd < 0 || socket->property("answered").toBool())
+                return;
+            socket->setProperty("answered", true);
+
+            Request request;
+            const auto lines = buffer.left(headerEnd).split('\n');
+            request.path = lines.value(0).split(' ').value(1);
+            for (qsizetype i = 1; i < lines.size(); i++) {
+                const auto line = lines[i].trimmed();
+                const auto colon = line.indexOf(':');
+                if (colon > 0)
+                    request.headers.insert(line.left(colon).trimmed().toLower(), line.mid(colon + 1).trimmed());
+            }
+            requests.append(request);
+            respond(socket, handler(request));
+        });
+    }
+
+    static void respond(QTcpSocket* socket, const Response& response)
+    {
+        QByteArray data = "HTTP/1.1 " + QByteArray::number(response.status) + " Test\r\n";
+        for (const auto& [name, value] : response.headers)
+            data += name + ": " + value + "\r\n";
+        data += "Content-Length: " + QByteArray::number(response.body.size()) + "\r\n";
+        data += "Connection: close\r\n\r\n";
+        if (response.sendOnly < 0) {
+            socket->write(data + response.body);
+            socket->disconnectFromHost();
+            return;
+        }
+        socket->write(data + response.body.left(response.sendOnly));
+        socket->flush();
+        // give the client a moment to read what it got before the connection breaks
+        QTimer::singleShot(100, socket, [socket] { socket->abort(); });
+    }
+};
+
+class FileSinkTest : public QObject {
+    Q_OBJECT
+
+    static QByteArray fileData(qsizetype size, int seed)
+    {
+        QByteArray data;
+        data.reserve(size);
+        for (qsizetype i = 0; i < size; i++)
+            data.append(static_cast<char>((i * 31 + seed) % 251));
+        return data;
+    }
+
+    static Net::ChecksumValidator* sha1Validator(const QByteArray& data)
+    {
+        return new Net::ChecksumValidator(QCryptographicHash::Sha1, QCryptographicHash::hash(data, QCryptographicHash::Sha1));
+    }
+
+    static bool run(const Net::Download::Ptr& download)
+    {
+        download->start();
+        return QTest::qWaitFor([&download] { return download->isFinished(); }, 10000) && download->wasSuccessful();
+    }
+
+    static shared_qobject_ptr<QNetworkAccessManager> makeNetwork()
+    {
+        auto network = makeShared<QNetworkAccessManager>();
+        network->setProxy(QNetworkProxy::NoProxy);
+        return network;
+    }
+
+   private slots:
+    void test_resume()
+    {
+        QTemporaryDir tempDir;
+        TestHttpServer server;
+        QVERIFY(server.listen(QHostAddress::LocalHost));
+
+        const auto body = fileData(256 * 1024, 1);
+        bool breakOff = true;
+        server.handler = [&](const TestHttpServer::Request& request) {
+            auto response = TestHttpServer::serveRanges(request, body, "\"v1\"");
+            if (std::exchange(breakOff, false))
+                response.sendOnly = 100 * 1024;
+            return response;
+        };
+
+        const auto path = FS::PathCombine(tempDir.path(), "file.jar");
+        auto download = Net::Download::makeFile(server.url("/file.jar"), path);
+        download->addValidator(sha1Validator(body));
+        download->setNetwork(makeNetwork());
+
+        QVERIFY(!run(download));
+        const auto partialSize = QFileInfo(path + ".part").size();
+        QVERIFY(partialSize > 0);
+        QVERIFY(partialSize <= 100 * 1024);
+
+        // the next attempt only asks for the rest, and only if the file is still the same
+        QVERIFY(run(download));
+        QCOMPARE(server.requests.size(), qsizetype(2));
+        QVERIFY(!server.requests.first().headers.contains("range"));
+        QCOMPARE(server.requests.last().headers.value("range"), "bytes=" + QByteArray::number(partialSize) + "-");
+        QCOMPARE(server.requests.last().headers.value("if-range"), QByteArray("\"v1\""));
+        QCOMPARE(FS::read(path), body);
+        QVERIFY(!QFileInfo::exists(path + ".part"));
+    }
+
+    void test_rangeIgnored()
+    {
+        QTemporaryDir tempDir;
+        TestHttpServer server;
+        QVERIFY(server.listen(QHostAddress::LocalHost));
+
+        const auto body = fileData(256 * 1024, 2);
+        bool breakOff = true;
+        server.handler = [&](const TestHttpServer::Request&) {
+            TestHttpServer::Response response;
+            response.headers = { { "ETag", "\"v1\"" } };
+            response.body = body;
+            if (std::exchange(breakOff, false))
+                response.sendOnly = 100 * 1024;
+            return response;
+        };
+
+        const auto path = FS::PathCombine(tempDir.path(), "file.jar");
+        auto download = Net::Download::makeFile(server.url("/file.jar"), path);
+        download->addValidator(sha1Validator(body));
+        download->setNetwork(makeNetwork());
+
+        QVERIFY(!run(download));
+        QVERIFY(QFileInfo(path + ".part").size() > 0);
+
+        // asked for the rest, got all of it: it starts over instead of appending
+        QVERIFY(run(download));
+        QVERIFY(server.requests.last().headers.contains("range"));
+        QCOMPARE(FS::read(path), body);
+    }
+
+    void test_changedETag()
+    {
+        QTemporaryDir tempDir;
+        TestHttpServer server;
+        QVERIFY(server.listen(QHostAddress::LocalHost));
+
+        const auto oldBody = fileData(256 * 1024, 3);
+        const auto newBody = fileData(200 * 1024, 4);
+        server.handler = [&](const TestHttpServer::Request& request) {
+            auto response = TestHttpServer::serveRanges(request, oldBody, "\"v1\"");
+            response.sendOnly = 100 * 1024;
+            return response;
+        };
+
+        const auto path = FS::PathCombine(tempDir.path(), "file.jar");
+        auto download = Net::Download::makeFile(server.url("/file.jar"), path);
+        download->setNetwork(makeNetwork());
+        QVERIFY(!run(download));
+        QVERIFY(QFileInfo(path + ".part").size() > 0);
+
+        // the file was replaced in the meantime, so the If-Range doesn't match and the whole new file comes back
+        server.handler = [&](const TestHttpServer::Request& request) { return TestHttpServer::serveRanges(request, newBody, "\"v2\""); };
+        QVERIFY(run(download));
+        QCOMPARE(server.requests.last().headers.value("if-range"), QByteArray("\"v1\""));
+        QCOMPARE(FS::read(path), newBody);
+    }
+
+    void test_wrongOffset()
+    {
+        QTemporaryDir tempDir;
+        TestHttpServer server;
+        QVERIFY(server.listen(QHostAddress::LocalHost));
+
+        const auto body = fileData(256 * 1024, 5);
+        server.handler = [&](const TestHttpServer::Request& request) {
+            auto response = TestHttpServer::serveRanges(request, body, "\"v1\"");
+            response.sendOnly = 100 * 1024;
+            return response;
+        };
+
+        const auto path = FS::PathCombine(tempDir.path(), "file.jar");
+        auto download = Net::Download::makeFile(server.url("/file.jar"), path);
+        download->setNetwork(makeNetwork());
+        QVERIFY(!run(download));
+        QVERIFY(QFileInfo::exists(path + ".part"));
+
+        // a range, but not the one asked for
+        server.handler = [&](const TestHttpServer::Request&) {
+            TestHttpServer::Response response;
+            response.status = 206;
+            response.headers = { { "ETag", "\"v1\"" }, { "Content-Range", "bytes 0-99/" + QByteArray::number(body.size()) } };
+            response.body = body.left(100);
+            return response;
+        };
+        QVERIFY(!run(download));
+        QVERIFY(!QFileInfo::exists(path + ".part"));
+        QVERIFY(!QFileInfo::exists(path));
+
+        // with the partial file gone, the next attempt starts from scratch
+        server.handler = [&](const TestHttpServer::Request& request) { return TestHttpServer::serveRanges(request, body, "\"v1\""); };
+        QVERIFY(run(download));
+        QVERIFY(!server.requests.last().headers.contains("range"));
+        QCOMPARE(FS::read(path), body);
+    }
+
+    void test_rangeNotSatisfiable()
+    {
+        QTemporaryDir tempDir;
+        TestHttpServer server;
+        QVERIFY(server.listen(QHostAddress::LocalHost));
+
+        const auto body = fileData(256 * 1024, 6);
+        server.handler = [&](const TestHttpServer::Request& request) {
+            auto response = TestHttpServer::serveRanges(request, body, "\"v1\"");
+            response.sendOnly = 100 * 1024;
+            return response;
+        };
+
+        const auto path = FS::PathCombine(tempDir.path(), "file.jar");
+        auto download = Net::Download::makeFile(server.url("/file.jar"), path);
+        download->setNetwork(makeNetwork());
+        QVERIFY(!run(download));
+        QVERIFY(QFileInfo::exists(path + ".part"));
+
+        // the file shrank below what was downloaded already, but kept its ETag
+        const auto shorter = body.left(10);
+        server.handler = [&](const TestHttpServer::Request& request) { return TestHttpServer::serveRanges(request, shorter, "\"v1\""); };
+        QVERIFY(!run(download));
+        QCOMPARE(server.requests.last().headers.value("if-range"), QByteArray("\"v1\""));
+        QVERIFY(!QFileInfo::exists(path + ".part"));
+
+        QVERIFY(run(download));
+        QVERIFY(!server.requests.last().headers.contains("range"));
+        QCOMPARE(FS::read(path), shorter);
+    }
+
+    void test_segmented()
+    {
+        QTemporaryDir tempDir;
+        TestHttpServer server;
+        QVERIFY(server.listen(QHostAddress::LocalHost));
+
+        const auto body = fileData(4 * 1024 * 1024, 7);
+        server.handler = [&](const TestHttpServer::Request& request) {
+            auto response = TestHttpServer::serveRanges(request, body, "\"v1\"");
+            // keep the main response going until the first segment is in, like a large file still being sent
+            if (!request.headers.contains("range"))
+                response.sendOnly = body.size() / 4;
+            return response;
+        };
+
+        const auto path = FS::PathCombine(tempDir.path(), "file.zip");
+        auto download = Net::Download::makeFile(server.url("/file.zip"), path, Net::Download::Option::Segmented);
+        download->addValidator(sha1Validator(body));
+        download->setNetwork(makeNetwork());
+        download->setSegmentThreshold(1024 * 1024);
+
+        QVERIFY(run(download));
+        QCOMPARE(FS::read(path), body);
+        QVERIFY(!QFileInfo::exists(path + ".part"));
+
+        QCOMPARE(server.requests.size(), qsizetype(4));
+        QVERIFY(!server.requests.first().headers.contains("range"));
+        QStringList ranges;
+        for (qsizetype i = 1; i < server.requests.size(); i++) {
+            QCOMPARE(server.requests[i].headers.value("if-range"), QByteArray("\"v1\""));
+            ranges.append(server.requests[i].headers.value("range"));
+        }
+        ranges.sort();
+        QCOMPARE(ranges, QStringList({ "bytes=1048576-2097151", "bytes=2097152-3145727", "bytes=3145728-4194303" }));
+    }
+
+    void test_segmentFailed()
+    {
+        QTemporaryDir tempDir;
+        TestHttpServer server;
+        QVERIFY(server.listen(QHostAddress::LocalHost));
+
+        const auto body = fileData(4 * 1024 * 1024, 8);
+        server.handler = [&](const TestHttpServer::Request& request) {
+            if (request.headers.value("range").startsWith("bytes=2097152-")) {
+                TestHttpServer::Response response;
+                response.status = 500;
+                return response;
+            }
+            auto response = TestHttpServer::serveRanges(request, body, "\"v1\"");
+            if (!request.headers.contains("range"))
+                response.sendOnly = body.size() / 4;
+            return response;
+        };
+
+        const auto path = FS::PathCombine(tempDir.path(), "file.zip");
+        auto download = Net::Download::makeFile(server.url("/file.zip"), path, Net::Download::Option::Segmented);
+        download->addValidator(sha1Validator(body));
+        download->setNetwork(makeNetwork());
+        download->setSegmentThreshold(1024 * 1024);
+
+        // the partial file has holes in it, so there is nothing to resume
+        QVERIFY(!run(download));
+        QVERIFY(!QFileInfo::exists(path + ".part"));
+        QVERIFY(!QFileInfo::exists(path));
+
+        server.handler = [&](const TestHttpServer::Request& request) {
+            auto response = TestHttpServer::serveRanges(request, body, "\"v1\"");
+            if (!request.headers.contains("range"))
+                response.sendOnly = body.size() / 4;
+            return response;
+        };
+        const auto failedRequests = server.requests.size();
+        QVERIFY(run(download));
+        QVERIFY(!server.requests[failedRequests].headers.contains("range"));
+        QCOMPARE(FS::read(path), body);
+    }
+
+    void test_segmentedWithoutRanges()
+    {
+        QTemporaryDir tempDir;
+        TestHttpServer server;
+        QVERIFY(server.listen(QHostAddress::LocalHost));
+
+        const auto body = fileData(4 * 1024 * 1024, 9);
+        server.handler = [&](const TestHttpServer::Request&) {
+            TestHttpServer::Response response;
+            response.headers = { { "ETag", "\"v1\"" } };
+            response.body = body;
+            return response;
+        };
+
+        const auto path = FS::PathCombine(tempDir.path(), "file.zip");
+        auto download = Net::Download::makeFile(server.url("/file.zip"), path, Net::Download::Option::Segmented);
+        download->addValidator(sha1Validator(body));
+        download->setNetwork(makeNetwork());
+        download->setSegmentThreshold(1024 * 1024);
+
+        // no Accept-Ranges, so it all comes over the one connection
+        QVERIFY(run(download));
+        QCOMPARE(server.requests.size(), qsizetype(1));
+        QCOMPARE(FS::read(path), body);
+    }
+
+    void test_replaceExisting()
+    {
+        QTemporaryDir tempDir;
+        TestHttpServer server;
+        QVERIFY(server.listen(QHostAddress::LocalHost));
+
+        const auto body = fileData(64 * 1024, 10);
+        server.handler = [&](const TestHttpServer::Request&) {
+            TestHttpServer::Response response;
+            response.body = body;
+            return response;
+        };
+
+        const auto path = FS::PathCombine(tempDir.path(), "file.jar");
+        const auto oldBody = fileData(1024, 11);
+        FS::write(path, oldBody);
+
+        // a download that doesn't validate leaves the old file alone
+        auto broken = Net::Download::makeFile(server.url("/file.jar"), path);
+        broken->addValidator(sha1Validator(oldBody));
+        broken->setNetwork(makeNetwork());
+        QVERIFY(!run(broken));
+        QCOMPARE(FS::read(path), oldBody);
+
+        auto download = Net::Download::makeFile(server.url("/file.jar"), path);
+        download->addValidator(sha1Validator(body));
+        download->setNetwork(makeNetwork());
+        QVERIFY(run(download));
+        QCOMPARE(FS::read(path), body);
+        QVERIFY(!QFileInfo::exists(path + ".part"));
+    }
+};
+
+QTEST_GUILESS_MAIN(FileSinkTest)
+
+#include "FileSink_test.moc"
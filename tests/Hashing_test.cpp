@@ -0,0 +1,146 @@
+#include <QDataStream>
+#include <QDateTime>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <FileSystem.h>
+#include <modplatform/helpers/HashCache.h>
+#include <modplatform/helpers/HashUtils.h>
+
+class HashingTest : public QObject {
+    Q_OBJECT
+   private slots:
+    void test_hashAllMatchesSingleHashes()
+    {
+        QTemporaryDir tempDir;
+        const auto path = FS::PathCombine(tempDir.path(), "file.jar");
+        QByteArray data;
+        for (int i = 0; i < 3 * 1024 * 1024; i++)
+            data.append(static_cast<char>((i * 31) % 251));
+        FS::write(path, data);
+
+        const QList<Hashing::Algorithm> types{ Hashing::Algorithm::Md5, Hashing::Algorithm::Sha1, Hashing::Algorithm::Sha256,
+                                               Hashing::Algorithm::Sha512, Hashing::Algorithm::Murmur2 };
+        auto digests = Hashing::hashAll(path, types);
+        QVERIFY(digests.ok());
+        QCOMPARE(digests.size, data.size());
+        for (auto type : types)
+            QCOMPARE(digests.get(type), Hashing::hash(data, type));
+    }
+
+    void test_hashAllMissingFile()
+    {
+        auto digests = Hashing::hashAll("/this/file/does/not/exist", { Hashing::Algorithm::Sha1 });
+        QVERIFY(!digests.ok());
+        QVERIFY(digests.hashes.isEmpty());
+    }
+
+    void test_hashCache()
+    {
+        QTemporaryDir tempDir;
+        const auto cachePath = FS::PathCombine(tempDir.path(), "hashes.dat");
+        const auto path = FS::PathCombine(tempDir.path(), "mod.jar");
+        FS::write(path, "first");
+
+        auto identity = Hashing::FileIdentity::of(path);
+        QVERIFY(identity.isValid());
+        QCOMPARE(identity.size, qint64(5));
+        {
+            Hashing::HashCache cache(cachePath);
+            QVERIFY(cache.lookup(identity, Hashing::Algorithm::Sha1).isEmpty());
+            cache.insert(identity, Hashing::Algorithm::Sha1, "abc");
+            cache.insert(identity, Hashing::Algorithm::Murmur2, "123");
+        }
+        {
+            Hashing::HashCache cache(cachePath);
+            QCOMPARE(cache.lookup(identity, Hashing::Algorithm::Sha1), QString("abc"));
+            QCOMPARE(cache.lookup(identity, Hashing::Algorithm::Murmur2), QString("123"));
+            QVERIFY(cache.lookup(identity, Hashing::Algorithm::Sha512).isEmpty());
+
+            // a rewritten file is a different file, even at the same path
+            FS::write(path, "second!");
+            auto changed = Hashing::FileIdentity::of(path);
+            QVERIFY(changed != identity);
+            QVERIFY(cache.lookup(changed, Hashing::Algorithm::Sha1).isEmpty());
+
+            cache.insert(changed, Hashing::Algorithm::Sha512, "def");
+            QVERIFY(cache.lookup(identity, Hashing::Algorithm::Sha1).isEmpty());
+            QCOMPARE(cache.lookup(changed, Hashing::Algorithm::Sha512), QString("def"));
+        }
+    }
+
+    void test_hashCacheKeepsUsedEntries()
+    {
+        QTemporaryDir tempDir;
+        const auto cachePath = FS::PathCombine(tempDir.path(), "hashes.dat");
+        const auto path = FS::PathCombine(tempDir.path(), "mod.jar");
+        FS::write(path, "first");
+        auto identity = Hashing::FileIdentity::of(path);
+
+        auto writeCache = [&](qint64 lastUsed) {
+            QByteArray data;
+            QDataStream out(&data, QIODevice::WriteOnly);
+            out << quint32(0x50484348) << quint32(1) << quint32(1);
+            out << identity.path << identity.size << identity.mtime << identity.inode << lastUsed << quint8(1);
+            out << quint8(Hashing::Algorithm::Sha1) << QString("abc");
+            FS::write(cachePath, data);
+        };
+        auto readLastUsed = [&] {
+            QDataStream in(FS::read(cachePath));
+            quint32 magic, version, count;
+            QString entryPath;
+            qint64 size, mtime, lastUsed;
+            quint64 inode;
+            in >> magic >> version >> count >> entryPath >> size >> mtime >> inode >> lastUsed;
+            return lastUsed;
+        };
+
+        // last used 80 days ago, it'd be dropped in 10 days unless looking it up now counts
+        const auto old = QDateTime::currentSecsSinceEpoch() - 80 * 24 * 60 * 60;
+        writeCache(old);
+        {
+            Hashing::HashCache cache(cachePath);
+            QCOMPARE(cache.lookup(identity, Hashing::Algorithm::Sha1), QString("abc"));
+        }
+        QVERIFY(readLastUsed() > old);
+
+        // long gone, dropped on the next save
+        writeCache(QDateTime::currentSecsSinceEpoch() - 100 * 24 * 60 * 60);
+        {
+            Hashing::HashCache cache(cachePath);
+            const auto other = FS::PathCombine(tempDir.path(), "other.jar");
+            FS::write(other, "other");
+            cache.insert(Hashing::FileIdentity::of(other), Hashing::Algorithm::Sha1, "def");
+        }
+        {
+            Hashing::HashCache cache(cachePath);
+            QVERIFY(cache.lookup(identity, Hashing::Algorithm::Sha1).isEmpty());
+        }
+    }
+
+    void test_folderHasher()
+    {
+        QTemporaryDir tempDir;
+        FS::write(FS::PathCombine(tempDir.path(), "a.txt"), "a");
+        FS::write(FS::PathCombine(tempDir.path(), "sub", "b.txt"), "b");
+
+        auto task = Hashing::createFolderHasher(tempDir.path(), { Hashing::Algorithm::Sha1, Hashing::Algorithm::Murmur2 });
+
+        task->start();
+        QVERIFY2(QTest::qWaitFor([&task]() { return task->isFinished(); }, 5000), "Hashing didn't finish in time.");
+
+        QVERIFY(task->wasSuccessful());
+        auto results = task->results();
+        QCOMPARE(results.size(), 2);
+        for (const auto& digests : results) {
+            QVERIFY(digests.ok());
+            auto content = digests.path.endsWith("a.txt") ? QByteArray("a") : QByteArray("b");
+            QCOMPARE(digests.get(Hashing::Algorithm::Sha1), Hashing::hash(content, Hashing::Algorithm::Sha1));
+            QCOMPARE(digests.get(Hashing::Algorithm::Murmur2), Hashing::hash(content, Hashing::Algorithm::Murmur2));
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(HashingTest)
+
+#include "Hashing_test.moc"
@@ -0,0 +1,169 @@
+#include <QCryptographicHash>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <FileSystem.h>
+#include <net/HttpMetaCache.h>
+
+class HttpMetaCacheTest : public QObject {
+    Q_OBJECT
+   private slots:
+    void test_migrateLegacyIndex()
+    {
+        QTemporaryDir tempDir;
+        const auto index = FS::PathCombine(tempDir.path(), "metacache");
+        FS::write(index, R"({ "version": "1", "entries": [
+            { "base": "general", "path": "a.json", "md5sum": "abc", "etag": "\"e\"", "last_changed_timestamp": 5, "eternal": true },
+            { "base": "unknown", "path": "b.json", "md5sum": "def", "etag": "", "last_changed_timestamp": 5, "eternal": true }
+        ] })");
+
+        {
+            HttpMetaCache cache(index);
+            cache.addBase("general", tempDir.path());
+            cache.Load();
+        }
+        QVERIFY(!QFileInfo::exists(index));
+        QVERIFY(QFileInfo::exists(index + ".idx"));
+
+        HttpMetaCache cache(index);
+        cache.addBase("general", tempDir.path());
+        cache.addBase("unknown", tempDir.path());
+        cache.Load();
+
+        auto entry = cache.getEntry("general", "a.json");
+        QVERIFY(entry != nullptr);
+        QCOMPARE(entry->getMD5Sum(), QString("abc"));
+        QCOMPARE(entry->getETag(), QString("\"e\""));
+        QVERIFY(entry->isEternal());
+        QVERIFY(!entry->isStale());
+
+        QVERIFY(cache.getEntry("unknown", "b.json") == nullptr);
+        QVERIFY(cache.getEntry("general", "c.json") == nullptr);
+    }
+
+    void test_journalReplay()
+    {
+        QTemporaryDir tempDir;
+        const auto index = FS::PathCombine(tempDir.path(), "metacache");
+
+        {
+            HttpMetaCache cache(index);
+            cache.addBase("general", tempDir.path());
+            cache.Load();
+
+            auto entry = cache.resolveEntry("general", "a.json");
+            QVERIFY(entry->isStale());
+            entry->setMD5Sum("abc");
+            entry->setMaximumAge(60);
+            entry->setStale(false);
+            QVERIFY(cache.updateEntry(entry));
+        }
+
+        {
+            HttpMetaCache cache(index);
+            cache.addBase("general", tempDir.path());
+            cache.Load();
+
+            auto entry = cache.getEntry("general", "a.json");
+            QVERIFY(entry != nullptr);
+            QCOMPARE(entry->getMD5Sum(), QString("abc"));
+            QCOMPARE(entry->getMaximumAge(), qint64(60));
+            QVERIFY(cache.evictEntry(entry));
+        }
+
+        HttpMetaCache cache(index);
+        cache.addBase("general", tempDir.path());
+        cache.Load();
+        QVERIFY(cache.getEntry("general", "a.json") == nullptr);
+    }
+
+    void test_resolveEntries()
+    {
+        QTemporaryDir tempDir;
+        HttpMetaCache cache;
+        cache.addBase("general", tempDir.path());
+
+        const auto file = FS::PathCombine(tempDir.path(), "dir", "a.txt");
+        QVERIFY(FS::ensureFilePathExists(file));
+        FS::write(file, "hello");
+        QFileInfo info(file);
+
+        auto entry = cache.resolveEntry("general", "dir/a.txt");
+        entry->setMD5Sum(QCryptographicHash::hash("hello", QCryptographicHash::Md5).toHex());
+        entry->setLocalChangedTimestamp(info.lastModified().toUTC().toMSecsSinceEpoch());
+        entry->setLocalSize(info.size());
+        entry->makeEternal(true);
+        entry->setStale(false);
+        QVERIFY(cache.updateEntry(entry));
+
+        auto entries = resolveEntries(cache, { "dir/a.txt", "dir/missing.txt" });
+        QCOMPARE(entries.size(), 2);
+        QVERIFY(!entries[0]->isStale());
+        QVERIFY(entries[1]->isStale());
+
+        // same contents with a new timestamp are fine
+        {
+            QFile touched(file);
+            QVERIFY(touched.open(QIODevice::ReadWrite));
+            QVERIFY(touched.setFileTime(info.lastModified().addSecs(-10), QFileDevice::FileModificationTime));
+        }
+        entries = resolveEntries(cache, { "dir/a.txt" });
+        QCOMPARE(entries.size(), 1);
+        QVERIFY(!entries[0]->isStale());
+
+        // ...but changed contents are not
+        FS::write(file, "hello world");
+        entries = resolveEntries(cache, { "dir/a.txt" });
+        QCOMPARE(entries.size(), 1);
+        QVERIFY(entries[0]->isStale());
+    }
+
+    void test_resolveEntriesRace()
+    {
+        QTemporaryDir tempDir;
+        HttpMetaCache cache;
+        cache.addBase("general", tempDir.path());
+
+        auto entry = cache.resolveEntry("general", "a.txt");
+        entry->makeEternal(true);
+        entry->setStale(false);
+        QVERIFY(cache.updateEntry(entry));
+
+        // the file is missing when it is checked, but a download stores a new entry before the result is applied
+        QList<MetaEntryPtr> out;
+        bool done = false;
+        cache.resolveEntries("general", { "a.txt" }, &cache, [&out, &done](QList<MetaEntryPtr> entries) {
+            out = entries;
+            done = true;
+        });
+        FS::write(FS::PathCombine(tempDir.path(), "a.txt"), "hello");
+        auto fresh = cache.resolveEntry("general", "a.txt");
+        fresh->makeEternal(true);
+        fresh->setStale(false);
+        QVERIFY(cache.updateEntry(fresh));
+
+        QVERIFY(QTest::qWaitFor([&done] { return done; }, 5000));
+        QCOMPARE(out.size(), 1);
+        QVERIFY(out[0] == fresh);
+        QVERIFY(cache.getEntry("general", "a.txt") == fresh);
+    }
+
+   private:
+    static QList<MetaEntryPtr> resolveEntries(HttpMetaCache& cache, const QStringList& paths)
+    {
+        QList<MetaEntryPtr> out;
+        bool done = false;
+        cache.resolveEntries("general", paths, &cache, [&out, &done](QList<MetaEntryPtr> entries) {
+            out = entries;
+            done = true;
+        });
+        // the files are checked in the background
+        if (!QTest::qWaitFor([&done] { return done; }, 5000))
+            qWarning() << "resolveEntries() didn't finish";
+        return out;
+    }
+};
+
+QTEST_GUILESS_MAIN(HttpMetaCacheTest)
+
+#include "HttpMetaCache_test.moc"
@@ -0,0 +1,154 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  Prism Launcher - Minecraft Launcher
+ *  Copyright (c) 2026 Prism Launcher Contributors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <FileSystem.h>
+#include <GZip.h>
+#include <launch/LogModel.h>
+#include <logs/LogFileModel.h>
+
+class LogFileModelTest : public QObject {
+    Q_OBJECT
+
+    static QByteArray logData()
+    {
+        return "[12:00:00] [main/INFO]: Starting\n"
+               "[12:00:01] [main/WARN]: Something odd\n"
+               "[12:00:02] [main/ERROR]: Crashed\n"
+               "java.lang.RuntimeException: boom\r\n"
+               "\tat net.minecraft.Main.main(Main.java:1)\n"
+               "\n"
+               "[12:00:03] [main/INFO]: Stopping";
+    }
+
+    static bool load(LogFileModel& model, const QString& path)
+    {
+        QSignalSpy loaded(&model, &LogFileModel::loaded);
+        model.load(path);
+        return loaded.wait(5000);
+    }
+
+   private slots:
+    void test_lines_data()
+    {
+        QTest::addColumn<bool>("gzip");
+        QTest::addRow("plain") << false;
+        QTest::addRow("gzip") << true;
+    }
+
+    void test_lines()
+    {
+        QFETCH(bool, gzip);
+
+        QTemporaryDir tempDir;
+        auto path = FS::PathCombine(tempDir.path(), "latest.log");
+        auto data = logData();
+        if (gzip) {
+            path += ".gz";
+            QByteArray compressed;
+            QVERIFY(GZip::zip(data, compressed));
+            data = compressed;
+        }
+        FS::write(path, data);
+
+        LogFileModel model;
+        QVERIFY(load(model, path));
+        QCOMPARE(model.rowCount(), 7);
+        QCOMPARE(model.line(0), QString("[12:00:00] [main/INFO]: Starting"));
+        QCOMPARE(model.line(3), QString("java.lang.RuntimeException: boom"));
+        QCOMPARE(model.line(5), QString());
+        QCOMPARE(model.line(6), QString("[12:00:03] [main/INFO]: Stopping"));
+        QCOMPARE(model.text().toUtf8(), logData());
+    }
+
+    void test_partialText()
+    {
+        QTemporaryDir tempDir;
+        const auto path = FS::PathCombine(tempDir.path(), "latest.log");
+        FS::write(path, logData());
+
+        LogFileModel model;
+        QVERIFY(load(model, path));
+        QCOMPARE(model.size(), qint64(logData().size()));
+        QCOMPARE(model.text(logData().size()).toUtf8(), logData());
+        // whole lines only, even if less than the limit fits
+        QCOMPARE(model.text(40), QString("\n[12:00:03] [main/INFO]: Stopping"));
+        QCOMPARE(model.text(10), QString());
+    }
+
+    void test_levels()
+    {
+        QTemporaryDir tempDir;
+        const auto path = FS::PathCombine(tempDir.path(), "latest.log");
+        FS::write(path, logData());
+
+        LogFileModel model;
+        QVERIFY(load(model, path));
+        // the stack trace line is guessed from the ones before it, even though those weren't displayed yet
+        QVERIFY(model.level(4) == MessageLevel::Error);
+        QVERIFY(model.level(1) == MessageLevel::Warning);
+        QCOMPARE(model.data(model.index(0), LogModel::LevelRole).toInt(), static_cast<int>(MessageLevel(MessageLevel::Info)));
+    }
+
+    void test_find()
+    {
+        QTemporaryDir tempDir;
+        const auto path = FS::PathCombine(tempDir.path(), "latest.log");
+        FS::write(path, logData());
+
+        LogFileModel model;
+        QVERIFY(load(model, path));
+        auto find = [&model](const QString& what, int from, bool reverse) { return model.find(what, from, reverse).result(); };
+        QCOMPARE(find("main/info", -1, false), 0);
+        QCOMPARE(find("main/info", 0, false), 6);
+        QCOMPARE(find("main/info", 6, false), 0);
+        QCOMPARE(find("MAIN/INFO", -1, true), 6);
+        QCOMPARE(find("main/info", 6, true), 0);
+        QCOMPARE(find("main/info", 0, true), 6);
+        QCOMPARE(find("Main.java", 0, false), 4);
+        QCOMPARE(find("nothing like this", 0, false), -1);
+    }
+
+    void test_empty()
+    {
+        QTemporaryDir tempDir;
+        const auto path = FS::PathCombine(tempDir.path(), "empty.log");
+        FS::write(path, {});
+
+        LogFileModel model;
+        QVERIFY(load(model, path));
+        QCOMPARE(model.rowCount(), 0);
+        QCOMPARE(model.find("anything", -1, false).result(), -1);
+    }
+
+    void test_missing()
+    {
+        QTemporaryDir tempDir;
+        LogFileModel model;
+        QSignalSpy failed(&model, &LogFileModel::failed);
+        model.load(FS::PathCombine(tempDir.path(), "missing.log"));
+        QVERIFY(failed.wait(5000));
+        QCOMPARE(model.rowCount(), 0);
+    }
+};
+
+QTEST_GUILESS_MAIN(LogFileModelTest)
+
+#include "LogFileModel_test.moc"
@@ -0,0 +1,108 @@
+// SPDX-License-Identifier: GPL-3.0-only
+/*
+ *  Prism Launcher - Minecraft Launcher
+ *  Copyright (c) 2026 Prism Launcher Contributors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, version 3.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <QSignalSpy>
+#include <QTest>
+
+#include <launch/LogModel.h>
+
+class LogModelTest : public QObject {
+    Q_OBJECT
+
+    static QList<LogModel::entry> makeLines(int first, int count)
+    {
+        QList<LogModel::entry> lines;
+        for (int i = first; i < first + count; i++)
+            lines.append({ MessageLevel::Info, QString::number(i) });
+        return lines;
+    }
+
+    static QString lineAt(const LogModel& model, int row) { return model.data(model.index(row), Qt::DisplayRole).toString(); }
+
+   private slots:
+    void test_batchIsOneInsertion()
+    {
+        LogModel model;
+        model.setMaxLines(10);
+        QSignalSpy inserted(&model, &QAbstractItemModel::rowsInserted);
+        QSignalSpy removed(&model, &QAbstractItemModel::rowsRemoved);
+
+        model.appendBatch(makeLines(0, 6));
+        QCOMPARE(inserted.count(), 1);
+        QCOMPARE(removed.count(), 0);
+        QCOMPARE(model.rowCount(), 6);
+
+        // wraps around the ring buffer, dropping the four oldest lines at once
+        model.appendBatch(makeLines(6, 8));
+        QCOMPARE(inserted.count(), 2);
+        QCOMPARE(removed.count(), 1);
+        QCOMPARE(removed.last().at(1).toInt(), 0);
+        QCOMPARE(removed.last().at(2).toInt(), 3);
+        QCOMPARE(model.rowCount(), 10);
+        for (int row = 0; row < 10; row++)
+            QCOMPARE(lineAt(model, row), QString::number(row + 4));
+        QVERIFY(model.previousLevel() == MessageLevel::Info);
+    }
+
+    void test_batchLargerThanBuffer()
+    {
+        LogModel model;
+        model.setMaxLines(10);
+        model.appendBatch(makeLines(0, 3));
+        model.appendBatch(makeLines(3, 25));
+        QCOMPARE(model.rowCount(), 10);
+        QCOMPARE(lineAt(model, 0), QString("18"));
+        QCOMPARE(lineAt(model, 9), QString("27"));
+    }
+
+    void test_batchStopsOnOverflow()
+    {
+        LogModel model;
+        model.setMaxLines(10);
+        model.setStopOnOverflow(true);
+        model.setOverflowMessage("full");
+        QSignalSpy removed(&model, &QAbstractItemModel::rowsRemoved);
+
+        model.appendBatch(makeLines(0, 8));
+        model.appendBatch(makeLines(8, 5));
+        QCOMPARE(removed.count(), 0);
+        QCOMPARE(model.rowCount(), 10);
+        QCOMPARE(lineAt(model, 8), QString("8"));
+        QCOMPARE(lineAt(model, 9), QString("full"));
+        QVERIFY(model.isOverFlow());
+
+        model.append(MessageLevel::Info, "ignored");
+        QCOMPARE(model.rowCount(), 10);
+    }
+
+    void test_appendMatchesBatch()
+    {
+        LogModel single;
+        LogModel batched;
+        single.setMaxLines(7);
+        batched.setMaxLines(7);
+        for (auto& line : makeLines(0, 20))
+            single.append(line.level, line.line);
+        batched.appendBatch(makeLines(0, 20));
+        QCOMPARE(single.toPlainText(), batched.toPlainText());
+    }
+};
+
+QTEST_GUILESS_MAIN(LogModelTest)
+
+#include "LogModel_test.moc"
@@ -0,0 +1,77 @@
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <FileSystem.h>
+#include <minecraft/mod/ModDetailsIndex.h>
+
+class ModDetailsIndexTest : public QObject {
+    Q_OBJECT
+   private slots:
+    void test_roundTrip()
+    {
+        QTemporaryDir tempDir;
+        const auto indexPath = FS::PathCombine(tempDir.path(), "index.dat");
+        const auto modPath = FS::PathCombine(tempDir.path(), "mods", "some_mod.jar");
+        FS::write(modPath, "not really a jar");
+
+        ModDetails details;
+        details.mod_id = "some_mod";
+        details.name = "Some Mod";
+        details.version = "1.2.3";
+        details.authors = { "someone", "someone else" };
+        details.licenses = { ModLicense("MIT") };
+        details.icon_file = "assets/some_mod/icon.png";
+
+        QImage icon(16, 16, QImage::Format_ARGB32);
+        icon.fill(Qt::red);
+
+        {
+            ModDetailsIndex index(indexPath);
+            QVERIFY(!index.lookup(modPath).has_value());
+            index.insert(Hashing::FileIdentity::of(modPath), details, icon);
+        }
+
+        ModDetailsIndex index(indexPath);
+        auto entry = index.lookup(modPath);
+        QVERIFY(entry.has_value());
+        QCOMPARE(entry->details.mod_id, details.mod_id);
+        QCOMPARE(entry->details.name, details.name);
+        QCOMPARE(entry->details.version, details.version);
+        QCOMPARE(entry->details.authors, details.authors);
+        QCOMPARE(entry->details.licenses.size(), qsizetype(1));
+        QCOMPARE(entry->details.licenses.first().id, QString("MIT"));
+        QCOMPARE(entry->details.icon_file, details.icon_file);
+        QCOMPARE(entry->icon.size(), icon.size());
+        QCOMPARE(entry->icon.pixelColor(0, 0), QColor(Qt::red));
+
+        // a changed jar has to be parsed again
+        FS::write(modPath, "a different jar");
+        QVERIFY(!index.lookup(modPath).has_value());
+    }
+
+    void test_removedFilesAreDropped()
+    {
+        QTemporaryDir tempDir;
+        const auto indexPath = FS::PathCombine(tempDir.path(), "index.dat");
+        const auto modPath = FS::PathCombine(tempDir.path(), "gone.jar");
+        FS::write(modPath, "jar");
+
+        ModDetails details;
+        details.mod_id = "gone";
+        {
+            ModDetailsIndex index(indexPath);
+            index.insert(Hashing::FileIdentity::of(modPath), details, {});
+            QVERIFY(index.lookup(modPath).has_value());
+            QVERIFY(QFile::remove(modPath));
+        }
+
+        // put a file back at the same path, the old entry must not have survived the save
+        FS::write(modPath, "jar");
+        ModDetailsIndex index(indexPath);
+        QVERIFY(!index.lookup(modPath).has_value());
+    }
+};
+
+QTEST_GUILESS_MAIN(ModDetailsIndexTest)
+
+#include "ModDetailsIndex_test.moc"
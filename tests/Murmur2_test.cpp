@@ -0,0 +1,107 @@
+#include <QTest>
+
+#include <MurmurHash2.h>
+#include <random>
+
+class ByteArrayReader : public Murmur2::Reader {
+   public:
+    ByteArrayReader(const QByteArray& data) : m_data(data) {}
+    int read(char* s, int n) override
+    {
+        int count = qMin<qsizetype>(n, m_data.size() - m_pos);
+        memcpy(s, m_data.constData() + m_pos, count);
+        m_pos += count;
+        return count;
+    }
+    bool eof() override { return m_pos >= m_data.size(); }
+    void goToBeginning() override { m_pos = 0; }
+
+   private:
+    const QByteArray& m_data;
+    qsizetype m_pos = 0;
+};
+
+static bool isCurseForgeWhitespace(char c)
+{
+    return c == 9 || c == 10 || c == 13 || c == 32;
+}
+
+// Random bytes with whitespace sprinkled in, so both the word and byte paths get exercised.
+static QByteArray randomData(qsizetype size, unsigned seed)
+{
+    std::mt19937 eng(seed);
+    QByteArray data(size, Qt::Uninitialized);
+    for (auto& c : data) {
+        auto v = eng();
+        c = (v % 16 == 0) ? "\t\n\r "[(v >> 8) % 4] : static_cast<char>(v >> 16);
+    }
+    return data;
+}
+
+class Murmur2Test : public QObject {
+    Q_OBJECT
+   private slots:
+    void test_knownValues_data()
+    {
+        QTest::addColumn<QByteArray>("data");
+        QTest::addColumn<bool>("filter");
+        QTest::addColumn<uint>("expected");
+
+        QTest::newRow("empty") << QByteArray() << true << 1540447798u;
+        QTest::newRow("single byte") << QByteArray("a") << true << 626045324u;
+        QTest::newRow("unfiltered") << QByteArray("Hello, World!") << false << 613646864u;
+        QTest::newRow("filtered") << QByteArray("Hello, World!") << true << 1961219979u;
+        QTest::newRow("filtered whitespace") << QByteArray("Hello,\tWorld!\r\n") << true << 1961219979u;
+    }
+
+    void test_knownValues()
+    {
+        QFETCH(QByteArray, data);
+        QFETCH(bool, filter);
+        QFETCH(uint, expected);
+
+        QCOMPARE(Murmur2::hash(data.constData(), data.size(), filter), expected);
+    }
+
+    void test_matchesReader()
+    {
+        for (qsizetype size = 0; size < 300; size++) {
+            auto data = randomData(size, size);
+            for (bool filter : { false, true }) {
+                ByteArrayReader reader(data);
+                auto expected = filter ? Murmur2::hash(&reader, 7, isCurseForgeWhitespace) : Murmur2::hash(&reader, 7);
+                QCOMPARE(Murmur2::hash(data.constData(), data.size(), filter), expected);
+            }
+        }
+    }
+
+    void bench_fingerprint_data()
+    {
+        QTest::addColumn<bool>("reader");
+
+        QTest::newRow("reader") << true;
+        QTest::newRow("buffer") << false;
+    }
+
+    void bench_fingerprint()
+    {
+        QFETCH(bool, reader);
+
+        auto data = randomData(32 * 1024 * 1024, 42);
+        uint32_t result = 0;
+        QBENCHMARK
+        {
+            if (reader) {
+                ByteArrayReader stream(data);
+                result = Murmur2::hash(&stream, 4 * MiB, isCurseForgeWhitespace);
+            } else {
+                result = Murmur2::hash(data.constData(), data.size(), true);
+            }
+        }
+        QVERIFY(result != 0);
+    }
+};
+
+QTEST_GUILESS_MAIN(Murmur2Test)
+
+#include "Murmur2_test.moc"
@@ -0,0 +1,163 @@
+#include <QMutex>
+#include <QSemaphore>
+#include <QTest>
+
+#include <minecraft/mod/ResourceParseScheduler.h>
+
+// Records when it starts, then holds its worker until the gate opens.
+class GatedTask : public Task {
+    Q_OBJECT
+   public:
+    GatedTask(QString name, QSemaphore& gate, QStringList& started, QMutex& mutex)
+        : m_name(std::move(name)), m_gate(gate), m_started(started), m_mutex(mutex)
+    {}
+
+   protected:
+    void executeTask() override
+    {
+        {
+            QMutexLocker lock(&m_mutex);
+            m_started.append(m_name);
+        }
+        m_gate.acquire();
+        emitSucceeded();
+    }
+
+   private:
+    QString m_name;
+    QSemaphore& m_gate;
+    QStringList& m_started;
+    QMutex& m_mutex;
+};
+
+class ResourceParseSchedulerTest : public QObject {
+    Q_OBJECT
+
+    QSemaphore m_gate;
+    QStringList m_started;
+    QMutex m_mutex;
+
+    Task::Ptr makeTask(const QString& name) { return Task::Ptr(new GatedTask(name, m_gate, m_started, m_mutex)); }
+
+    qsizetype startedCount()
+    {
+        QMutexLocker lock(&m_mutex);
+        return m_started.size();
+    }
+
+   private slots:
+    void init()
+    {
+        m_started.clear();
+        m_gate.acquire(m_gate.available());
+    }
+
+    void test_coalesce()
+    {
+        auto& scheduler = ResourceParseScheduler::instance();
+        QObject owner;
+
+        auto first = makeTask("first");
+        auto second = makeTask("second");
+        QVERIFY(!scheduler.schedule(&owner, "/mods/a.jar", first));
+        QCOMPARE(scheduler.schedule(&owner, "/mods/a.jar", second), first);
+
+        m_gate.release();
+        QTRY_COMPARE(startedCount(), qsizetype(1));
+        QTRY_VERIFY(second->wasSuccessful());
+        QCOMPARE(m_started, QStringList{ "second" });
+        QVERIFY(!first->isRunning() && !first->wasSuccessful());
+
+        scheduler.cancelAll(&owner);
+    }
+
+    void test_visibleFirst()
+    {
+        auto& scheduler = ResourceParseScheduler::instance();
+        QObject owner;
+
+        const int slots = scheduler.maxConcurrent();
+        QList<Task::Ptr> tasks;
+        for (int i = 0; i <= slots; i++) {
+            tasks.append(makeTask(QString::number(i)));
+            QVERIFY(!scheduler.schedule(&owner, QString("/mods/%1.jar").arg(i), tasks.last()));
+        }
+        // the last one would only get a slot once another finished
+        scheduler.prioritize(&owner, QString("/mods/%1.jar").arg(slots));
+
+        QTRY_COMPARE(startedCount(), qsizetype(slots));
+        {
+            QMutexLocker lock(&m_mutex);
+            QVERIFY(m_started.contains(QString::number(slots)));
+            QVERIFY(!m_started.contains(QString::number(slots - 1)));
+        }
+
+        m_gate.release(slots + 1);
+        QTRY_COMPARE(scheduler.throughput(&owner).parsed, slots + 1);
+
+        scheduler.cancelAll(&owner);
+    }
+
+    void test_lastPrioritizedFirst()
+    {
+        auto& scheduler = ResourceParseScheduler::instance();
+        QObject owner;
+
+        const int slots = scheduler.maxConcurrent();
+        QList<Task::Ptr> tasks;
+        for (int i = 0; i < slots; i++) {
+            tasks.append(makeTask(QString::number(i)));
+            QVERIFY(!scheduler.schedule(&owner, QString("/mods/%1.jar").arg(i), tasks.last()));
+        }
+        QTRY_COMPARE(startedCount(), qsizetype(slots));
+
+        for (auto name : { "a", "b", "c" }) {
+            tasks.append(makeTask(name));
+            QVERIFY(!scheduler.schedule(&owner, QString("/mods/%1.jar").arg(name), tasks.last()));
+        }
+        // scrolling back up to a row that was prioritized before puts it in front again
+        scheduler.prioritize(&owner, "/mods/a.jar");
+        scheduler.prioritize(&owner, "/mods/b.jar");
+        scheduler.prioritize(&owner, "/mods/a.jar");
+
+        m_gate.release();
+        QTRY_COMPARE(startedCount(), qsizetype(slots + 1));
+        m_gate.release();
+        QTRY_COMPARE(startedCount(), qsizetype(slots + 2));
+        {
+            QMutexLocker lock(&m_mutex);
+            QCOMPARE(m_started.mid(slots), QStringList({ "a", "b" }));
+        }
+
+        m_gate.release(slots + 1);
+        QTRY_COMPARE(scheduler.throughput(&owner).parsed, slots + 3);
+        scheduler.cancelAll(&owner);
+    }
+
+    void test_cancel()
+    {
+        auto& scheduler = ResourceParseScheduler::instance();
+        QObject owner;
+
+        const int slots = scheduler.maxConcurrent();
+        QList<Task::Ptr> tasks;
+        for (int i = 0; i <= slots; i++) {
+            tasks.append(makeTask(QString::number(i)));
+            QVERIFY(!scheduler.schedule(&owner, QString("/mods/%1.jar").arg(i), tasks.last()));
+        }
+        QTRY_COMPARE(startedCount(), qsizetype(slots));
+
+        // queued tasks can be taken back, running ones can't
+        QVERIFY(scheduler.cancel(tasks.last().get()));
+        QVERIFY(!scheduler.cancel(tasks.first().get()));
+
+        m_gate.release(slots);
+        scheduler.cancelAll(&owner);
+        QCOMPARE(startedCount(), qsizetype(slots));
+        QCOMPARE(scheduler.throughput(&owner).parsed, 0);
+    }
+};
+
+QTEST_GUILESS_MAIN(ResourceParseSchedulerTest)
+
+#include "ResourceParseScheduler_test.moc"
@@ -1,3 +1,6 @@
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QTest>
 #include <QThread>
 #include <QTimer>
@@ -6,6 +9,7 @@
 #include <tasks/MultipleOptionsTask.h>
 #include <tasks/SequentialTask.h>
 #include <tasks/Task.h>
+#include <tasks/TaskTrace.h>
 
 #include <array>
 
@@ -245,6 +249,50 @@ class TaskTest : public QObject {
         QVERIFY2(QTest::qWaitFor([&t]() { return t.isFinished(); }, 1000), "Task didn't finish as it should.");
     }
 
+    void test_trace()
+    {
+        TaskTrace trace;
+
+        auto t1 = makeShared<BasicTask>();
+        auto t2 = makeShared<BasicTask>();
+
+        ConcurrentTask t;
+        t.addTask(t1);
+        t.addTask(t2);
+
+        t.start();
+        QVERIFY2(QTest::qWaitFor([&t]() { return t.isFinished(); }, 1000), "Task didn't finish as it should.");
+        trace.stop();
+
+        // not recorded anymore
+        BasicTask after;
+        after.start();
+
+        auto spans = trace.spans();
+        QCOMPARE(spans.size(), 3);
+        for (auto& span : spans) {
+            QVERIFY(span.end >= span.start);
+            QVERIFY(span.state == Task::State::Succeeded);
+            QVERIFY(span.created >= 0);
+            QVERIFY(span.queueWait() >= 0);
+            QCOMPARE(span.bytes, -1);
+            if (span.uid == t.getUid()) {
+                QVERIFY(span.parent.isNull());
+            } else {
+                QCOMPARE(span.parent, t.getUid());
+                QVERIFY(span.queued >= span.created);
+            }
+        }
+        QCOMPARE(trace.summary().size(), 1);
+        // BasicTask and ConcurrentTask
+        QCOMPARE(trace.metrics().size(), 2);
+
+        auto events = QJsonDocument::fromJson(trace.toChromeTrace("test")).object().value("traceEvents").toArray();
+        QCOMPARE(events.size(), 4);
+        QCOMPARE(events[1].toObject().value("ph").toString(), "X");
+        QCOMPARE(events[1].toObject().value("args").toObject().value("uid").toString(), t.getUid().toString(QUuid::WithoutBraces));
+    }
+
     void test_stackOverflowInConcurrentTask()
     {
         QEventLoop loop;
@@ -21,6 +21,7 @@
 
 #include <QTest>
 
+#include <QDateTime>
 #include <QList>
 #include <QObject>
 #include <QRegularExpression>
@@ -31,6 +32,7 @@
 
 #include <FileSystem.h>
 #include <MessageLevel.h>
+#include <logs/Log4jTokenizer.h>
 #include <logs/LogParser.h>
 
 class XmlLogParseTest : public QObject {
@@ -101,6 +103,72 @@ class XmlLogParseTest : public QObject {
         QCOMPARE(levels, entry_levels);
     }
 
+    void parseXmlTokenizer_data() { parseXml_data(); }
+
+    void parseXmlTokenizer()
+    {
+        QFETCH(QString, log);
+        QFETCH(int, num_entries);
+        QFETCH(QList<MessageLevel>, entry_levels);
+
+        // the process hands over whatever it has, so lines and events end up split between chunks
+        auto data = log.toUtf8();
+        if (!data.endsWith('\n'))
+            data.append('\n');
+
+        QList<std::pair<MessageLevel, QString>> entries = {};
+
+        QBENCHMARK
+        {
+            entries = tokenize(data, 4096);
+        }
+
+        QCOMPARE(entries.length(), num_entries);
+
+        QList<MessageLevel> levels = {};
+
+        std::transform(entries.cbegin(), entries.cend(), std::back_inserter(levels),
+                       [](std::pair<MessageLevel, QString> entry) { return entry.first; });
+
+        QCOMPARE(levels, entry_levels);
+    }
+
+    void tokenizerFormat()
+    {
+        LogParser::LogEntry entry{
+            "net.minecraft.client.Minecraft", MessageLevel::Info, "INFO", QDateTime(QDate(2025, 4, 18), QTime(9, 5, 3)), "Render thread",
+            "Setting user: Player",
+        };
+        QCOMPARE(Log4jTokenizer::format(entry), "[09:05:03] [Render thread/INFO] [net.minecraft.client.Minecraft]: Setting user: Player");
+    }
+
+    void tokenizerSplitEvent()
+    {
+        QByteArray event =
+            "before\n<log4j:Event logger=\"a.b\" timestamp=\"1745005150596\" level=\"WARN\" thread=\"main\">\n"
+            "<log4j:Message><![CDATA[one </log4j:Event> two]]></log4j:Message>\n</log4j:Event>\nafter\r\n";
+
+        // every possible split point, byte by byte
+        for (qsizetype split = 0; split <= event.size(); split++) {
+            Log4jTokenizer tokenizer;
+            auto items = tokenizer.feed(QByteArrayView(event).first(split));
+            items.append(tokenizer.feed(QByteArrayView(event).sliced(split)));
+
+            QCOMPARE(items.size(), 3);
+            QVERIFY(std::holds_alternative<LogParser::PlainText>(items[0]));
+            QCOMPARE(std::get<LogParser::PlainText>(items[0]).message, "before");
+            QVERIFY(std::holds_alternative<LogParser::LogEntry>(items[1]));
+            auto entry = std::get<LogParser::LogEntry>(items[1]);
+            QCOMPARE(entry.logger, "a.b");
+            QVERIFY(entry.level == MessageLevel::Warning);
+            QCOMPARE(entry.thread, "main");
+            QCOMPARE(entry.message, "one </log4j:Event> two");
+            QCOMPARE(entry.timestamp.toMSecsSinceEpoch(), 1745005150596);
+            QVERIFY(std::holds_alternative<LogParser::PlainText>(items[2]));
+            QCOMPARE(std::get<LogParser::PlainText>(items[2]).message, "after");
+        }
+    }
+
    private:
     LogParser m_parser;
 
@@ -135,6 +203,28 @@ class XmlLogParseTest : public QObject {
         }
         return out;
     }
+
+    static QList<std::pair<MessageLevel, QString>> tokenize(const QByteArray& data, qsizetype chunkSize)
+    {
+        QList<std::pair<MessageLevel, QString>> out;
+        MessageLevel last = MessageLevel::Unknown;
+        Log4jTokenizer tokenizer;
+
+        for (qsizetype pos = 0; pos < data.size(); pos += chunkSize) {
+            for (auto& item : tokenizer.feed(QByteArrayView(data).sliced(pos, std::min(chunkSize, data.size() - pos)))) {
+                if (auto entry = std::get_if<LogParser::LogEntry>(&item)) {
+                    out.append(std::make_pair(entry->level, Log4jTokenizer::format(*entry)));
+                    last = entry->level;
+                } else if (auto text = std::get_if<LogParser::PlainText>(&item)) {
+                    auto level = LogParser::guessLevel(text->message, last);
+
+                    out.append(std::make_pair(level, text->message));
+                    last = level;
+                }
+            }
+        }
+        return out;
+    }
 };
 
 QTEST_GUILESS_MAIN(XmlLogParseTest)
@@ -0,0 +1,144 @@
+#include <QTemporaryDir>
+#include <QTest>
+
+#include <FileSystem.h>
+#include <archive/ArchiveWriter.h>
+#include <archive/ZipExtractor.h>
+
+class ZipExtractorTest : public QObject {
+    Q_OBJECT
+
+    static void writeArchive(const QString& path, const QHash<QString, QByteArray>& files)
+    {
+        MMCZip::ArchiveWriter writer(path);
+        QVERIFY(writer.open());
+        for (auto it = files.cbegin(); it != files.cend(); it++)
+            QVERIFY(writer.addFile(it.key(), it.value()));
+        QVERIFY(writer.close());
+    }
+
+   private slots:
+    void test_extractSubdirectory()
+    {
+        QTemporaryDir tempDir;
+        const auto archive = FS::PathCombine(tempDir.path(), "pack.zip");
+        const auto target = FS::PathCombine(tempDir.path(), "out");
+
+        QByteArray big;
+        for (int i = 0; i < 200000; i++)
+            big.append(QByteArray::number(i));
+        writeArchive(archive, {
+                                  { "manifest.json", "{}" },
+                                  { "overrides/options.txt", "fov:0.5" },
+                                  { "overrides/config/a/b/c.toml", "c = 1" },
+                                  { "overrides/saves/world/big.dat", big },
+                                  { "overrides/empty.txt", "" },
+                              });
+
+        MMCZip::ZipExtractor extractor(archive, "overrides/", target);
+        QVERIFY(extractor.open());
+        qint64 lastDone = 0;
+        connect(&extractor, &MMCZip::ZipExtractor::progress, this, [&lastDone](qint64 done, qint64) { lastDone = done; });
+        auto extracted = extractor.extract();
+        QVERIFY(extracted.has_value());
+        QCOMPARE(extracted->size(), qsizetype(4));
+        QCOMPARE(lastDone, qint64(big.size() + 12));
+
+        QVERIFY(!QFileInfo::exists(FS::PathCombine(target, "manifest.json")));
+        QCOMPARE(FS::read(FS::PathCombine(target, "options.txt")), QByteArray("fov:0.5"));
+        QCOMPARE(FS::read(FS::PathCombine(target, "config/a/b/c.toml")), QByteArray("c = 1"));
+        QCOMPARE(FS::read(FS::PathCombine(target, "saves/world/big.dat")), big);
+        QCOMPARE(FS::read(FS::PathCombine(target, "empty.txt")), QByteArray());
+    }
+
+    void test_outsideOfTarget()
+    {
+        QTemporaryDir tempDir;
+        const auto archive = FS::PathCombine(tempDir.path(), "evil.zip");
+        const auto target = FS::PathCombine(tempDir.path(), "out");
+        writeArchive(archive, { { "fine.txt", "fine" }, { "../evil.txt", "evil" } });
+
+        MMCZip::ZipExtractor extractor(archive, "", target);
+        QVERIFY(extractor.open());
+        QVERIFY(!extractor.extract().has_value());
+        QVERIFY(!QFileInfo::exists(FS::PathCombine(tempDir.path(), "evil.txt")));
+        QVERIFY(!QFileInfo::exists(FS::PathCombine(target, "fine.txt")));
+    }
+
+    void test_namesDifferingInCase()
+    {
+        QTemporaryDir tempDir;
+        const auto archive = FS::PathCombine(tempDir.path(), "pack.zip");
+        const auto target = FS::PathCombine(tempDir.path(), "out");
+
+        QByteArray first(1024 * 1024, 'a');
+        QByteArray second(1024 * 1024, 'b');
+        {
+            MMCZip::ArchiveWriter writer(archive);
+            QVERIFY(writer.open());
+            QVERIFY(writer.addFile("config/Foo.toml", first));
+            QVERIFY(writer.addFile("config/foo.toml", second));
+            QVERIFY(writer.close());
+        }
+
+        MMCZip::ZipExtractor extractor(archive, "", target);
+        QVERIFY(extractor.open());
+        auto extracted = extractor.extract();
+        QVERIFY(extracted.has_value());
+#if defined(Q_OS_WIN) || defined(Q_OS_MACOS)
+        // the same file there, so the last entry wins instead of both being written at once
+        QCOMPARE(extracted->size(), qsizetype(1));
+        QCOMPARE(FS::read(FS::PathCombine(target, "config/Foo.toml")), second);
+#else
+        QCOMPARE(extracted->size(), qsizetype(2));
+        QCOMPARE(FS::read(FS::PathCombine(target, "config/Foo.toml")), first);
+        QCOMPARE(FS::read(FS::PathCombine(target, "config/foo.toml")), second);
+#endif
+    }
+
+    void test_notAZip()
+    {
+        QTemporaryDir tempDir;
+        const auto archive = FS::PathCombine(tempDir.path(), "archive.tar.gz");
+        FS::write(archive, QByteArray(1000, 'x'));
+
+        MMCZip::ZipExtractor extractor(archive, "", FS::PathCombine(tempDir.path(), "out"));
+        QVERIFY(!extractor.open());
+    }
+
+    void bench_extract_data()
+    {
+        QTest::addColumn<int>("threads");
+
+        for (int threads = 1; threads <= QThread::idealThreadCount(); threads *= 2)
+            QTest::addRow("%d threads", threads) << threads;
+    }
+
+    void bench_extract()
+    {
+        QFETCH(int, threads);
+
+        QTemporaryDir tempDir;
+        const auto archive = FS::PathCombine(tempDir.path(), "pack.zip");
+        // lots of small configs, like a big modpack has
+        QHash<QString, QByteArray> files;
+        for (int i = 0; i < 3000; i++) {
+            auto name = QString("config/mod%1/settings%2.toml").arg(i / 20).arg(i);
+            files.insert(name, QByteArray("enabled = true\n").repeated(200 + i % 100));
+        }
+        writeArchive(archive, files);
+
+        int run = 0;
+        QBENCHMARK
+        {
+            MMCZip::ZipExtractor extractor(archive, "", FS::PathCombine(tempDir.path(), QString::number(run++)));
+            extractor.setThreadCount(threads);
+            QVERIFY(extractor.open());
+            QVERIFY(extractor.extract().has_value());
+        }
+    }
+};
+
+QTEST_GUILESS_MAIN(ZipExtractorTest)
+
+#include "ZipExtractor_test.moc"
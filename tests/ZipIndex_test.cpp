@@ -0,0 +1,205 @@
+#include <QBuffer>
+#include <QTemporaryDir>
+#include <QtEndian>
+#include <QTest>
+
+#include <FileSystem.h>
+#include <archive/ArchiveReader.h>
+#include <archive/ArchiveWriter.h>
+#include <archive/ZipIndex.h>
+
+class ZipIndexTest : public QObject {
+    Q_OBJECT
+   private slots:
+    void test_matchesArchiveReader_data()
+    {
+        QTest::addColumn<QString>("archive");
+
+        QTest::newRow("jar") << QFINDTESTDATA("testdata/ResourcePackParse/supercoolmod.jar");
+        QTest::newRow("zip") << QFINDTESTDATA("testdata/DataPackParse/test_data_pack_boogaloo.zip");
+        QTest::newRow("world") << QFINDTESTDATA("testdata/WorldSaveParse/minecraft_save_1.zip");
+    }
+
+    void test_matchesArchiveReader()
+    {
+        QFETCH(QString, archive);
+
+        MMCZip::ZipIndex index(archive);
+        QVERIFY(index.open());
+
+        QStringList names;
+        MMCZip::ArchiveReader reader(archive);
+        QVERIFY(reader.parse([&index, &names](MMCZip::ArchiveReader::File* file) {
+            names << file->filename();
+            auto expected = file->readAll();
+            auto data = index.read(file->filename());
+            if (!data || *data != expected)
+                qWarning() << "Mismatch for" << file->filename();
+            return data && *data == expected;
+        }));
+
+        QStringList indexed;
+        for (const auto& entry : index.entries())
+            indexed << entry.name;
+        indexed.sort();
+        names.sort();
+        QCOMPARE(indexed, names);
+    }
+
+    void test_writtenArchive()
+    {
+        QTemporaryDir tempDir;
+        const auto path = FS::PathCombine(tempDir.path(), "test.jar");
+
+        QByteArray big;
+        for (int i = 0; i < 100000; i++)
+            big.append(QByteArray::number(i));
+        {
+            MMCZip::ArchiveWriter writer(path);
+            QVERIFY(writer.open());
+            QVERIFY(writer.addFile("fabric.mod.json", QByteArray(R"({ "id": "test" })")));
+            QVERIFY(writer.addFile("assets/test/big.txt", big));
+            QVERIFY(writer.addFile("empty.txt", QByteArray()));
+            QVERIFY(writer.close());
+        }
+
+        MMCZip::ZipIndex index(path);
+        QVERIFY(index.open());
+        QVERIFY(index.contains("fabric.mod.json"));
+        QVERIFY(!index.contains("quilt.mod.json"));
+        QCOMPARE(index.read("fabric.mod.json").value(), QByteArray(R"({ "id": "test" })"));
+        QCOMPARE(index.read("assets/test/big.txt").value(), big);
+        QCOMPARE(index.read("empty.txt").value(), QByteArray());
+        QVERIFY(!index.read("missing.txt").has_value());
+    }
+
+    void test_copiedEntries()
+    {
+        QTemporaryDir tempDir;
+        const auto source = FS::PathCombine(tempDir.path(), "source.jar");
+        const auto target = FS::PathCombine(tempDir.path(), "target.jar");
+
+        QByteArray big;
+        for (int i = 0; i < 100000; i++)
+            big.append(QByteArray::number(i));
+        {
+            MMCZip::ArchiveWriter writer(source);
+            QVERIFY(writer.open());
+            QVERIFY(writer.addFile("assets/test/big.txt", big));
+            QVERIFY(writer.addFile("empty.txt", QByteArray()));
+            QVERIFY(writer.close());
+        }
+
+        MMCZip::ZipIndex sourceIndex(source);
+        QVERIFY(sourceIndex.open());
+        {
+            MMCZip::ArchiveWriter writer(target);
+            writer.setCompressionLevel(0);
+            QVERIFY(writer.open());
+            for (const auto& entry : sourceIndex.entries())
+                QVERIFY(writer.addEntry(sourceIndex, entry));
+            QVERIFY(writer.addEntry(sourceIndex, *sourceIndex.find("empty.txt"), "renamed.txt"));
+            QVERIFY(writer.close());
+        }
+
+        MMCZip::ZipIndex index(target);
+        QVERIFY(index.open());
+        QCOMPARE(index.entries().size(), qsizetype(3));
+        // copied as they were stored, the compression level doesn't apply
+        QCOMPARE(index.find("assets/test/big.txt")->method, quint16(MMCZip::ZipIndex::Deflated));
+        QCOMPARE(index.find("assets/test/big.txt")->compressedSize, sourceIndex.find("assets/test/big.txt")->compressedSize);
+        QCOMPARE(index.read("assets/test/big.txt").value(), big);
+        QCOMPARE(index.read("renamed.txt").value(), QByteArray());
+
+        // libarchive must be able to read it too
+        QStringList names;
+        MMCZip::ArchiveReader reader(target);
+        QVERIFY(reader.parse([&names, &big](MMCZip::ArchiveReader::File* file) {
+            names << file->filename();
+            auto data = file->readAll();
+            return file->filename() != "assets/test/big.txt" || data == big;
+        }));
+        names.sort();
+        QCOMPARE(names, QStringList({ "assets/test/big.txt", "empty.txt", "renamed.txt" }));
+    }
+
+    void test_duplicateNames()
+    {
+        QTemporaryDir tempDir;
+        const auto path = FS::PathCombine(tempDir.path(), "test.jar");
+        {
+            MMCZip::ArchiveWriter writer(path);
+            QVERIFY(writer.open());
+            QVERIFY(writer.addFile("fabric.mod.json", QByteArray("first")));
+            QVERIFY(writer.addFile("fabric.mod.json", QByteArray("second")));
+            QVERIFY(writer.close());
+        }
+
+        MMCZip::ZipIndex index(path);
+        QVERIFY(index.open());
+        QCOMPARE(index.entries().size(), qsizetype(2));
+        QCOMPARE(index.find("fabric.mod.json"), &index.entries().first());
+        QCOMPARE(index.read("fabric.mod.json").value(), QByteArray("first"));
+    }
+
+    void test_lyingSizes()
+    {
+        QTemporaryDir tempDir;
+        const auto path = FS::PathCombine(tempDir.path(), "test.jar");
+
+        QByteArray big;
+        for (int i = 0; i < 100000; i++)
+            big.append(QByteArray::number(i));
+        {
+            MMCZip::ArchiveWriter writer(path);
+            QVERIFY(writer.open());
+            QVERIFY(writer.addFile("big.txt", big));
+            QVERIFY(writer.close());
+        }
+
+        // overwrites the uncompressed size in the central directory header of the only entry
+        auto withSize = [&path](quint32 size) {
+            auto data = FS::read(path);
+            const auto header = data.lastIndexOf(QByteArray("PK\x01\x02", 4));
+            if (header < 0)
+                return false;
+            qToLittleEndian(size, data.data() + header + 24);
+            FS::write(path, data);
+            return true;
+        };
+
+        QVERIFY(withSize(0xF0000000));
+        {
+            MMCZip::ZipIndex index(path);
+            QVERIFY(index.open());
+            QVERIFY(!index.read("big.txt").has_value());
+        }
+
+        QVERIFY(withSize(1000));
+        {
+            MMCZip::ZipIndex index(path);
+            QVERIFY(index.open());
+            QVERIFY(!index.read("big.txt").has_value());
+
+            QBuffer output;
+            QVERIFY(output.open(QIODevice::WriteOnly));
+            QVERIFY(!index.extract(*index.find("big.txt"), output));
+            QVERIFY(output.size() <= 1000);
+        }
+    }
+
+    void test_notAZip()
+    {
+        QTemporaryDir tempDir;
+        const auto path = FS::PathCombine(tempDir.path(), "garbage.jar");
+        FS::write(path, QByteArray(1000, 'x'));
+
+        MMCZip::ZipIndex index(path);
+        QVERIFY(!index.open());
+        QVERIFY(index.entries().isEmpty());
+    }
+};
+
+QTEST_GUILESS_MAIN(ZipIndexTest)
+
+#include "ZipIndex_test.moc"